@@ -0,0 +1,325 @@
+#include "SocketDataSharing.hpp"
+#include "Poller.hpp"
+#include "DataTransfer.hpp"
+#include "Error.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+//Opens and closes connections against a local listener at a fixed rate to reproduce connection storms.
+//Every client thread keeps one connection at a time: it connects, sends the payload and destroys the socket.
+//Connections are started on schedule even if the previous ones were late, so a slow listener shows up as lower rate and higher latencies.
+//The report is printed as one JSON object. Failures are keyed by the SDS::Error value taken from the thread's last error.
+//Usage: ConnectionChurnLoadGenerator [connections per second] [client thread count] [duration in seconds] [payload size]
+//    [destruction timeout: -1 closes gracefully, 0 resets, greater values linger for that many seconds]
+//Graceful closing leaves the client ports in the TIME_WAIT state, so high rates run out of ports unless the connections are reset.
+
+using namespace SDS;
+
+using Clock = std::chrono::steady_clock;
+
+static constexpr auto pendingConnectionQueueSize = (uint32_t)4096;
+static constexpr auto acceptBatchSize = (int32_t)64;
+static constexpr auto waitTimeoutInMilliseconds = (int32_t)5000;
+static constexpr auto errorValueCount = (size_t)64;
+
+struct Settings final
+{
+    int32_t connectionsPerSecond;
+    int32_t clientThreadCount;
+    int32_t durationInSeconds;
+    size_t payloadSize;
+    int32_t destructionTimeout;
+};
+
+struct ClientResults final
+{
+    std::vector<uint64_t> connectTimes;
+    std::vector<uint64_t> cycleTimes;
+    uint64_t startedConnectionCount = 0;
+    uint64_t timeoutCount = 0;
+    uint64_t failureCounts[errorValueCount]{};
+};
+
+static const IPv4Address loopbackAddress{ { 127, 0, 0, 1 } };
+
+//Errors are read from the thread's last error, so the callback only has to exist.
+static void IgnoreError(Error, int64_t, void*) {}
+
+static uint64_t ToNanoseconds(Clock::duration duration)
+{
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+}
+
+static void CountFailure(ClientResults& results)
+{
+    const Error error = GetThreadLastError(nullptr);
+    ++results.failureCounts[(size_t)error < errorValueCount ? (size_t)error : errorValueCount - (size_t)1];
+}
+
+//The returned value is false if the socket didn't become writable in time. The poller only holds the current socket.
+static bool WaitForSocket(PollerHandle poller)
+{
+    PollerEvent event;
+    int32_t eventCount;
+    return WaitForPollerEvents(poller, &event, 1, waitTimeoutInMilliseconds, &eventCount) != ErrorIndicator::Error && eventCount != 0;
+}
+
+//The returned value is false if the connection failed. Failures and timeouts are counted by this function.
+static bool RunConnection(const Settings& settings, uint16_t portNumber, PollerHandle poller,
+    const std::vector<std::byte>& payload, ClientResults& results)
+{
+    const auto start = Clock::now();
+    ClearThreadLastError();
+
+    SocketProfile profile{};
+    if (settings.destructionTimeout >= 0)
+    {
+        profile.isDestructionTimeoutEnabled = Bool::True;
+        profile.destructionTimeoutInSeconds = (uint16_t)settings.destructionTimeout;
+    }
+
+    auto* const socket = CreateConnectedIPv4TCPSocketWithProfile(0, loopbackAddress, portNumber, &profile);
+    if (socket == nullptr)
+    {
+        CountFailure(results);
+        return false;
+    }
+
+    auto hasSucceeded = false;
+    if (AddSocketToPoller(poller, socket, (uint32_t)PollerEventFlag::Writable, 0) == ErrorIndicator::Error)
+    {
+        CountFailure(results);
+    }
+    else if (!WaitForSocket(poller))
+    {
+        ++results.timeoutCount;
+    }
+    else if (IsTCPSocketConnected(socket) != ErrorBool::True)
+    {
+        CountFailure(results);
+    }
+    else
+    {
+        results.connectTimes.push_back(ToNanoseconds(Clock::now() - start));
+
+        hasSucceeded = true;
+        for (auto sentSize = (size_t)0; sentSize < settings.payloadSize && hasSucceeded;)
+        {
+            BufferSegment segment{ const_cast<std::byte*>(payload.data()) + sentSize, settings.payloadSize - sentSize };
+            size_t byteCount;
+            const TransferStatus status = Send(socket, &segment, 1, &byteCount);
+            if (status == TransferStatus::Transferred)
+            {
+                sentSize += byteCount;
+            }
+            else if (status != TransferStatus::WouldBlock)
+            {
+                CountFailure(results);
+                hasSucceeded = false;
+            }
+            else if (!WaitForSocket(poller))
+            {
+                ++results.timeoutCount;
+                hasSucceeded = false;
+            }
+        }
+    }
+
+    if (DestroySocket(socket) == ErrorIndicator::Error && hasSucceeded)
+    {
+        CountFailure(results);
+        hasSucceeded = false;
+    }
+
+    if (hasSucceeded)
+        results.cycleTimes.push_back(ToNanoseconds(Clock::now() - start));
+
+    return hasSucceeded;
+}
+
+static void RunClient(const Settings& settings, uint16_t portNumber, int32_t threadIndex, Clock::time_point start, ClientResults& results)
+{
+    auto* const poller = CreatePoller();
+    if (poller == nullptr)
+        std::exit(EXIT_FAILURE);
+
+    const std::vector<std::byte> payload(settings.payloadSize);
+    const auto interval = std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>((double)settings.clientThreadCount / (double)settings.connectionsPerSecond));
+    const auto end = start + std::chrono::seconds(settings.durationInSeconds);
+
+    //The threads are shifted within one interval, so they don't start their connections at the same time.
+    auto nextStart = start + interval * threadIndex / settings.clientThreadCount;
+    while (nextStart < end)
+    {
+        std::this_thread::sleep_until(nextStart);
+        ++results.startedConnectionCount;
+        RunConnection(settings, portNumber, poller, payload, results);
+        nextStart += interval;
+    }
+
+    DestroyPoller(poller);
+}
+
+//Accepts connections and receives until another host closes them, so the payload is really transferred.
+static void RunListener(SocketHandle listeningSocket, const std::atomic<bool>& isRunning, std::atomic<uint64_t>& acceptedConnectionCount)
+{
+    auto* const poller = CreatePoller();
+    if (poller == nullptr || AddSocketToPoller(poller, listeningSocket, (uint32_t)PollerEventFlag::Readable, 0) == ErrorIndicator::Error)
+        std::exit(EXIT_FAILURE);
+
+    PollerEvent events[acceptBatchSize];
+    SocketHandle connectedSockets[acceptBatchSize];
+    std::byte buffer[65536];
+    BufferSegment segment{ buffer, sizeof(buffer) };
+    while (isRunning.load(std::memory_order_relaxed))
+    {
+        int32_t eventCount;
+        if (WaitForPollerEvents(poller, events, acceptBatchSize, 10, &eventCount) == ErrorIndicator::Error)
+            std::exit(EXIT_FAILURE);
+
+        for (auto i = (int32_t)0; i < eventCount; ++i)
+        {
+            if (events[i].tag == (uint64_t)0)
+            {
+                int32_t acceptedBatchSize;
+                do
+                {
+                    if (AcceptNewConnections(listeningSocket, connectedSockets, nullptr, acceptBatchSize, &acceptedBatchSize) == ErrorIndicator::Error)
+                        break;
+
+                    for (auto j = (int32_t)0; j < acceptedBatchSize; ++j)
+                        if (AddSocketToPoller(poller, connectedSockets[j], (uint32_t)PollerEventFlag::Readable,
+                                (uint64_t)reinterpret_cast<uintptr_t>(connectedSockets[j])) == ErrorIndicator::Error)
+                            DestroySocket(connectedSockets[j]);
+
+                    acceptedConnectionCount.fetch_add((uint64_t)acceptedBatchSize, std::memory_order_relaxed);
+                } while (acceptedBatchSize == acceptBatchSize);
+
+                continue;
+            }
+
+            auto* const connectedSocket = reinterpret_cast<SocketHandle>((uintptr_t)events[i].tag);
+            size_t byteCount;
+            TransferStatus status;
+            do
+                status = Receive(connectedSocket, &segment, 1, &byteCount);
+            while (status == TransferStatus::Transferred);
+
+            if (status != TransferStatus::WouldBlock)
+                DestroySocket(connectedSocket);
+        }
+    }
+
+    DestroyPoller(poller);
+}
+
+static uint64_t GetPercentile(const std::vector<uint64_t>& sortedValues, double percentile)
+{
+    if (sortedValues.empty())
+        return 0;
+
+    return sortedValues[(size_t)(percentile / 100.0 * (double)(sortedValues.size() - (size_t)1) + 0.5)];
+}
+
+static void PrintLatencies(const char* name, std::vector<uint64_t>& values)
+{
+    std::sort(values.begin(), values.end());
+    std::printf(",\"%s\":{\"p50_ns\":%llu,\"p90_ns\":%llu,\"p99_ns\":%llu,\"p999_ns\":%llu,\"max_ns\":%llu}", name,
+        (unsigned long long)GetPercentile(values, 50.0), (unsigned long long)GetPercentile(values, 90.0),
+        (unsigned long long)GetPercentile(values, 99.0), (unsigned long long)GetPercentile(values, 99.9),
+        (unsigned long long)(values.empty() ? (uint64_t)0 : values.back()));
+}
+
+int main(int argumentCount, char** arguments)
+{
+    Settings settings{};
+    settings.connectionsPerSecond = argumentCount > 1 ? (int32_t)std::atoi(arguments[1]) : (int32_t)1000;
+    settings.clientThreadCount = argumentCount > 2 ? (int32_t)std::atoi(arguments[2]) : (int32_t)4;
+    settings.durationInSeconds = argumentCount > 3 ? (int32_t)std::atoi(arguments[3]) : (int32_t)10;
+    settings.payloadSize = argumentCount > 4 ? (size_t)std::atoll(arguments[4]) : (size_t)0;
+    settings.destructionTimeout = argumentCount > 5 ? (int32_t)std::atoi(arguments[5]) : (int32_t)0;
+    if (settings.connectionsPerSecond <= 0 || settings.clientThreadCount <= 0 || settings.durationInSeconds <= 0 ||
+        settings.destructionTimeout > (int32_t)UINT16_MAX)
+    {
+        std::fprintf(stderr, "Invalid arguments\n");
+        return EXIT_FAILURE;
+    }
+
+    SetErrorOccuredCallback(IgnoreError, nullptr);
+    if (Initialize() == ErrorIndicator::Error)
+        return EXIT_FAILURE;
+
+    uint16_t portNumber = 0;
+    auto* const listeningSocket = CreateListeningIPv4TCPSocket(loopbackAddress, &portNumber, pendingConnectionQueueSize);
+    if (listeningSocket == nullptr)
+        return EXIT_FAILURE;
+
+    std::atomic<bool> isListenerRunning = true;
+    std::atomic<uint64_t> acceptedConnectionCount = 0;
+    std::thread listenerThread(RunListener, listeningSocket, std::cref(isListenerRunning), std::ref(acceptedConnectionCount));
+
+    std::vector<ClientResults> results((size_t)settings.clientThreadCount);
+    const auto expectedConnectionCount = (size_t)settings.connectionsPerSecond * (size_t)settings.durationInSeconds / (size_t)settings.clientThreadCount;
+    for (auto& threadResults : results)
+    {
+        threadResults.connectTimes.reserve(expectedConnectionCount + (size_t)1);
+        threadResults.cycleTimes.reserve(expectedConnectionCount + (size_t)1);
+    }
+
+    const auto start = Clock::now() + std::chrono::milliseconds(10);
+    std::vector<std::thread> clientThreads;
+    for (auto i = (int32_t)0; i < settings.clientThreadCount; ++i)
+        clientThreads.emplace_back(RunClient, std::cref(settings), portNumber, i, start, std::ref(results[(size_t)i]));
+
+    for (auto& clientThread : clientThreads)
+        clientThread.join();
+
+    const double time = std::chrono::duration<double>(Clock::now() - start).count();
+    isListenerRunning.store(false, std::memory_order_relaxed);
+    listenerThread.join();
+
+    ClientResults totals;
+    for (auto& threadResults : results)
+    {
+        totals.startedConnectionCount += threadResults.startedConnectionCount;
+        totals.timeoutCount += threadResults.timeoutCount;
+        for (auto i = (size_t)0; i < errorValueCount; ++i)
+            totals.failureCounts[i] += threadResults.failureCounts[i];
+
+        totals.connectTimes.insert(totals.connectTimes.end(), threadResults.connectTimes.begin(), threadResults.connectTimes.end());
+        totals.cycleTimes.insert(totals.cycleTimes.end(), threadResults.cycleTimes.begin(), threadResults.cycleTimes.end());
+    }
+
+    std::printf("{\"target_connections_per_second\":%d,\"client_thread_count\":%d,\"payload_size\":%zu,\"destruction_timeout\":%d,"
+        "\"seconds\":%.6f,\"started_connection_count\":%llu,\"completed_connection_count\":%llu,\"accepted_connection_count\":%llu,"
+        "\"achieved_connections_per_second\":%.0f,\"timeout_count\":%llu,\"failures_by_error\":{",
+        (int)settings.connectionsPerSecond, (int)settings.clientThreadCount, settings.payloadSize, (int)settings.destructionTimeout,
+        time, (unsigned long long)totals.startedConnectionCount, (unsigned long long)totals.cycleTimes.size(),
+        (unsigned long long)acceptedConnectionCount.load(std::memory_order_relaxed), totals.cycleTimes.size() / time,
+        (unsigned long long)totals.timeoutCount);
+
+    auto isFirstFailure = true;
+    for (auto i = (size_t)0; i < errorValueCount; ++i)
+    {
+        if (totals.failureCounts[i] != (uint64_t)0)
+        {
+            std::printf("%s\"%zu\":%llu", isFirstFailure ? "" : ",", i, (unsigned long long)totals.failureCounts[i]);
+            isFirstFailure = false;
+        }
+    }
+
+    std::printf("}");
+    PrintLatencies("connect_latency", totals.connectTimes);
+    PrintLatencies("cycle_latency", totals.cycleTimes);
+    std::printf("}\n");
+
+    DestroySocket(listeningSocket);
+    Shutdown();
+    return EXIT_SUCCESS;
+}
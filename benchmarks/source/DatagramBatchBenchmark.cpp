@@ -0,0 +1,112 @@
+#include "SocketDataSharing.hpp"
+#include "DataTransfer.hpp"
+#include "EndiannessConversions.hpp"
+#include "Error.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+//Compares the datagram rate of SendTo/ReceiveFrom with SendDatagramBatch/ReceiveDatagramBatch over loopback.
+//Usage: DatagramBatchBenchmark [datagram count] [datagram size]
+
+using namespace SDS;
+
+static constexpr auto batchSize = (int32_t)64;
+
+static void PrintError(Error error, int64_t correspondingSystemError, void*)
+{
+    if (error != Error::Success)
+        std::fprintf(stderr, "Error %d (system error %lld)\n", (int)error, (long long)correspondingSystemError);
+}
+
+//Datagrams are sent and received in rounds, so the receive buffer never overflows.
+static double MeasureSingleDatagramPath(SocketHandle sender, SocketHandle receiver, const ErrorIPSocketAddress& destination,
+    BufferSegment& segment, int32_t datagramCount)
+{
+    const auto start = std::chrono::steady_clock::now();
+
+    size_t byteCount;
+    for (auto sentDatagramCount = (int32_t)0; sentDatagramCount < datagramCount; sentDatagramCount += batchSize)
+    {
+        for (auto i = (int32_t)0; i < batchSize; ++i)
+            if (SendTo(sender, &segment, 1, &destination, &byteCount) != TransferStatus::Transferred)
+                std::exit(EXIT_FAILURE);
+
+        for (auto i = (int32_t)0; i < batchSize; ++i)
+            while (ReceiveFrom(receiver, &segment, 1, nullptr, &byteCount) == TransferStatus::WouldBlock);
+    }
+
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static double MeasureBatchPath(SocketHandle sender, SocketHandle receiver, const ErrorIPSocketAddress& destination,
+    BufferSegment& segment, int32_t datagramCount)
+{
+    //Received datagrams are overwritten with the source addresses, so they can't be reused for sending.
+    Datagram datagramsToSend[batchSize]{};
+    Datagram datagramsToReceive[batchSize]{};
+    for (auto i = (int32_t)0; i < batchSize; ++i)
+    {
+        datagramsToSend[i].socketAddressInNetworkBO = destination;
+        datagramsToSend[i].segments = &segment;
+        datagramsToSend[i].segmentCount = 1;
+
+        datagramsToReceive[i].segments = &segment;
+        datagramsToReceive[i].segmentCount = 1;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+
+    int32_t transferredDatagramCount;
+    for (auto sentDatagramCount = (int32_t)0; sentDatagramCount < datagramCount; sentDatagramCount += batchSize)
+    {
+        for (auto batchSentDatagramCount = (int32_t)0; batchSentDatagramCount < batchSize; batchSentDatagramCount += transferredDatagramCount)
+            if (SendDatagramBatch(sender, datagramsToSend + batchSentDatagramCount, batchSize - batchSentDatagramCount,
+                    &transferredDatagramCount) == TransferStatus::Error)
+                std::exit(EXIT_FAILURE);
+
+        for (auto batchReceivedDatagramCount = (int32_t)0; batchReceivedDatagramCount < batchSize; batchReceivedDatagramCount += transferredDatagramCount)
+            if (ReceiveDatagramBatch(receiver, datagramsToReceive + batchReceivedDatagramCount, batchSize - batchReceivedDatagramCount,
+                    &transferredDatagramCount) == TransferStatus::WouldBlock)
+                transferredDatagramCount = 0;
+    }
+
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argumentCount, char** arguments)
+{
+    const auto datagramCount = argumentCount > 1 ? (int32_t)std::atoi(arguments[1]) / batchSize * batchSize : (int32_t)1048576;
+    const auto datagramSize = argumentCount > 2 ? (size_t)std::atoi(arguments[2]) : (size_t)64;
+
+    SetErrorOccuredCallback(PrintError, nullptr);
+    if (Initialize() == ErrorIndicator::Error)
+        return EXIT_FAILURE;
+
+    const IPv4Address loopbackAddress{ { 127, 0, 0, 1 } };
+    uint16_t senderPortNumber = 0;
+    uint16_t receiverPortNumber = 0;
+    auto* const sender = CreateIPv4UDPSocket(loopbackAddress, &senderPortNumber);
+    auto* const receiver = CreateIPv4UDPSocket(loopbackAddress, &receiverPortNumber);
+    if (sender == nullptr || receiver == nullptr)
+        return EXIT_FAILURE;
+
+    ErrorIPSocketAddress destination{};
+    destination.port = HostToNetworkBO_16(receiverPortNumber);
+    destination.v4 = loopbackAddress;
+
+    auto* const payload = new std::byte[datagramSize]{};
+    BufferSegment segment{ payload, datagramSize };
+
+    const double singleDatagramPathTime = MeasureSingleDatagramPath(sender, receiver, destination, segment, datagramCount);
+    const double batchPathTime = MeasureBatchPath(sender, receiver, destination, segment, datagramCount);
+
+    std::printf("datagram count: %d, datagram size: %zu bytes\n", (int)datagramCount, datagramSize);
+    std::printf("SendTo/ReceiveFrom: %.0f datagrams/s\n", datagramCount / singleDatagramPathTime);
+    std::printf("SendDatagramBatch/ReceiveDatagramBatch: %.0f datagrams/s\n", datagramCount / batchPathTime);
+    std::printf("speedup: %.2fx\n", singleDatagramPathTime / batchPathTime);
+
+    delete[] payload;
+    Shutdown();
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,155 @@
+#include "SocketDataSharing.hpp"
+#include "Poller.hpp"
+#include "Error.hpp"
+#include <pthread.h>
+#include <sched.h>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+//Measures the accept rate over loopback while the listening socket group grows from one socket to the core count.
+//Every socket of the group is accepted on its own thread pinned to the corresponding CPU.
+//Usage: ShardedAcceptBenchmark [connection count] [client thread count] [max listening socket count]
+
+using namespace SDS;
+
+static constexpr auto acceptBatchSize = (int32_t)64;
+static constexpr auto pendingConnectionQueueSize = (uint32_t)4096;
+
+static void PrintError(Error error, int64_t correspondingSystemError, void*)
+{
+    if (error != Error::Success)
+        std::fprintf(stderr, "Error %d (system error %lld)\n", (int)error, (long long)correspondingSystemError);
+}
+
+static void PinCurrentThreadToCPU(unsigned int cpuIndex)
+{
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    CPU_SET(cpuIndex, &cpuSet);
+    pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuSet); //If it fails, the thread just isn't pinned.
+}
+
+static void AcceptConnections(SocketHandle listeningSocket, unsigned int cpuIndex,
+    std::atomic<int32_t>& acceptedConnectionCount, int32_t connectionCount)
+{
+    PinCurrentThreadToCPU(cpuIndex);
+
+    auto* const poller = CreatePoller();
+    if (poller == nullptr || AddSocketToPoller(poller, listeningSocket, (uint32_t)PollerEventFlag::Readable, 0) == ErrorIndicator::Error)
+        std::exit(EXIT_FAILURE);
+
+    PollerEvent event;
+    int32_t eventCount;
+    SocketHandle connectedSockets[acceptBatchSize];
+    int32_t acceptedBatchSize;
+    while (acceptedConnectionCount.load(std::memory_order_relaxed) < connectionCount)
+    {
+        //The timeout lets the thread notice that the other threads have accepted the rest of the connections.
+        if (WaitForPollerEvents(poller, &event, 1, 10, &eventCount) == ErrorIndicator::Error)
+            std::exit(EXIT_FAILURE);
+
+        if (eventCount == 0)
+            continue;
+
+        do
+        {
+            if (AcceptNewConnections(listeningSocket, connectedSockets, nullptr, acceptBatchSize, &acceptedBatchSize) == ErrorIndicator::Error)
+                std::exit(EXIT_FAILURE);
+
+            for (auto i = (int32_t)0; i < acceptedBatchSize; ++i)
+                DestroySocket(connectedSockets[i]);
+
+            acceptedConnectionCount.fetch_add(acceptedBatchSize, std::memory_order_relaxed);
+        } while (acceptedBatchSize == acceptBatchSize);
+    }
+
+    DestroyPoller(poller);
+}
+
+//The connections are reset on destruction, so the client ports don't stay in the TIME_WAIT state.
+static void ConnectAndDisconnect(uint16_t portNumber, int32_t connectionCount)
+{
+    auto* const poller = CreatePoller();
+    if (poller == nullptr)
+        std::exit(EXIT_FAILURE);
+
+    const IPv4Address loopbackAddress{ { 127, 0, 0, 1 } };
+    SocketProfile profile{}; //The connections are reset on destruction, so the client ports don't stay in the TIME_WAIT state.
+    profile.isDestructionTimeoutEnabled = Bool::True;
+
+    PollerEvent event;
+    int32_t eventCount;
+    for (auto i = (int32_t)0; i < connectionCount; ++i)
+    {
+        auto* const connectingSocket = CreateConnectedIPv4TCPSocketWithProfile(0, loopbackAddress, portNumber, &profile);
+        if (connectingSocket == nullptr ||
+            AddSocketToPoller(poller, connectingSocket, (uint32_t)PollerEventFlag::Writable, 0) == ErrorIndicator::Error ||
+            WaitForPollerEvents(poller, &event, 1, -1, &eventCount) == ErrorIndicator::Error ||
+            IsTCPSocketConnected(connectingSocket) != ErrorBool::True)
+        {
+            std::exit(EXIT_FAILURE);
+        }
+
+        DestroySocket(connectingSocket);
+    }
+
+    DestroyPoller(poller);
+}
+
+static double MeasureAcceptRate(int32_t listeningSocketCount, int32_t connectionCount, int32_t clientThreadCount)
+{
+    const IPv4Address loopbackAddress{ { 127, 0, 0, 1 } };
+    uint16_t portNumber = 0;
+    std::vector<SocketHandle> listeningSockets((size_t)listeningSocketCount);
+    if (CreateListeningIPv4TCPSocketGroup(loopbackAddress, &portNumber, pendingConnectionQueueSize,
+        listeningSocketCount, Bool::True, listeningSockets.data()) == ErrorIndicator::Error)
+    {
+        std::exit(EXIT_FAILURE);
+    }
+
+    std::atomic<int32_t> acceptedConnectionCount = 0;
+    const auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> threads;
+    for (auto i = (int32_t)0; i < listeningSocketCount; ++i)
+        threads.emplace_back(AcceptConnections, listeningSockets[i], (unsigned int)i, std::ref(acceptedConnectionCount), connectionCount);
+
+    for (auto i = (int32_t)0; i < clientThreadCount; ++i)
+        threads.emplace_back(ConnectAndDisconnect, portNumber, connectionCount / clientThreadCount);
+
+    for (auto& thread : threads)
+        thread.join();
+
+    const double time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    for (auto* const listeningSocket : listeningSockets)
+        DestroySocket(listeningSocket);
+
+    return connectionCount / time;
+}
+
+int main(int argumentCount, char** arguments)
+{
+    const auto coreCount = (int32_t)std::thread::hardware_concurrency();
+    const auto clientThreadCount = argumentCount > 2 ? (int32_t)std::atoi(arguments[2]) : coreCount;
+    const auto connectionCount = (argumentCount > 1 ? (int32_t)std::atoi(arguments[1]) : (int32_t)65536) / clientThreadCount * clientThreadCount;
+    const auto maxListeningSocketCount = argumentCount > 3 ? (int32_t)std::atoi(arguments[3]) : coreCount;
+
+    SetErrorOccuredCallback(PrintError, nullptr);
+    if (Initialize() == ErrorIndicator::Error)
+        return EXIT_FAILURE;
+
+    std::printf("connection count: %d, client thread count: %d\n", (int)connectionCount, (int)clientThreadCount);
+    for (auto listeningSocketCount = (int32_t)1; listeningSocketCount <= maxListeningSocketCount; ++listeningSocketCount)
+    {
+        std::printf("listening sockets: %d, %.0f accepts/s\n", (int)listeningSocketCount,
+            MeasureAcceptRate(listeningSocketCount, connectionCount, clientThreadCount));
+    }
+
+    Shutdown();
+    return EXIT_SUCCESS;
+}
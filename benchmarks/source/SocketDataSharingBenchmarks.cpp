@@ -0,0 +1,466 @@
+#include "SocketDataSharing.hpp"
+#include "Poller.hpp"
+#include "DataTransfer.hpp"
+#include "EndiannessConversions.hpp"
+#include "Error.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+//Runs the loopback benchmark suite. Every result is printed as one JSON object per line, so runs can be compared with a script.
+//Usage: SocketDataSharingBenchmarks [benchmark name...]
+//Benchmark names: tcp_ping_pong, tcp_streaming, udp_datagram_rate, accept_churn, network_ip_addresses. All of them run by default.
+
+using namespace SDS;
+
+using Clock = std::chrono::steady_clock;
+
+static constexpr auto pingPongMessageSize = (size_t)64;
+static constexpr auto pingPongWarmupCount = (int32_t)1000;
+static constexpr auto pingPongRoundTripCount = (int32_t)20000;
+static constexpr size_t streamingMessageSizes[] = { 64, 1024, 16384, 65536 };
+static constexpr auto streamingDuration = std::chrono::milliseconds(1000);
+static constexpr auto datagramSize = (size_t)64;
+static constexpr auto datagramBatchSize = (int32_t)64;
+static constexpr auto datagramDuration = std::chrono::milliseconds(1000);
+static constexpr auto churnConnectionCount = (int32_t)8192;
+static constexpr auto churnClientThreadCount = (int32_t)4;
+static constexpr auto acceptBatchSize = (int32_t)64;
+static constexpr auto networkIPAddressesCallCount = (int32_t)1000;
+
+static const IPv4Address loopbackAddress{ { 127, 0, 0, 1 } };
+
+static void PrintError(Error error, int64_t correspondingSystemError, void*)
+{
+    if (error != Error::Success)
+        std::fprintf(stderr, "Error %d (system error %lld)\n", (int)error, (long long)correspondingSystemError);
+}
+
+//Waits until the socket is ready. The poller is created per call, because the benchmarks only use it outside of the measured loops.
+static void WaitForSocket(SocketHandle socket, PollerEventFlag eventFlag)
+{
+    auto* const poller = CreatePoller();
+    PollerEvent event;
+    int32_t eventCount;
+    if (poller == nullptr || AddSocketToPoller(poller, socket, (uint32_t)eventFlag, 0) == ErrorIndicator::Error ||
+        WaitForPollerEvents(poller, &event, 1, -1, &eventCount) == ErrorIndicator::Error)
+    {
+        std::exit(EXIT_FAILURE);
+    }
+
+    DestroyPoller(poller);
+}
+
+struct ConnectionPair final
+{
+    SocketHandle clientSocket;
+    SocketHandle serverSocket;
+};
+
+static ConnectionPair CreateConnectionPair()
+{
+    uint16_t portNumber = 0;
+    auto* const listeningSocket = CreateListeningIPv4TCPSocket(loopbackAddress, &portNumber, 1);
+    if (listeningSocket == nullptr)
+        std::exit(EXIT_FAILURE);
+
+    ConnectionPair pair{};
+    pair.clientSocket = CreateConnectedIPv4TCPSocket(0, loopbackAddress, portNumber);
+    if (pair.clientSocket == nullptr)
+        std::exit(EXIT_FAILURE);
+
+    WaitForSocket(pair.clientSocket, PollerEventFlag::Writable);
+    WaitForSocket(listeningSocket, PollerEventFlag::Readable);
+    if (IsTCPSocketConnected(pair.clientSocket) != ErrorBool::True ||
+        AcceptNewConnection(listeningSocket, &pair.serverSocket) == ErrorIndicator::Error || pair.serverSocket == nullptr)
+    {
+        std::exit(EXIT_FAILURE);
+    }
+
+    DestroySocket(listeningSocket);
+    return pair;
+}
+
+//Transfers the whole buffer, waiting with the poller whenever the socket isn't ready.
+//The poller must wait for the direction of the transfer. The returned value is false if the connection was closed.
+static bool TransferAll(PollerHandle poller, SocketHandle socket, std::byte* data, size_t size, bool isSending)
+{
+    PollerEvent event;
+    int32_t eventCount;
+    for (auto transferredSize = (size_t)0; transferredSize < size;)
+    {
+        BufferSegment segment{ data + transferredSize, size - transferredSize };
+        size_t byteCount;
+        const TransferStatus status = isSending ? Send(socket, &segment, 1, &byteCount) : Receive(socket, &segment, 1, &byteCount);
+        if (status == TransferStatus::Transferred)
+            transferredSize += byteCount;
+        else if (status == TransferStatus::WouldBlock)
+            WaitForPollerEvents(poller, &event, 1, -1, &eventCount);
+        else if (status == TransferStatus::ConnectionClosed)
+            return false;
+        else
+            std::exit(EXIT_FAILURE);
+    }
+
+    return true;
+}
+
+static PollerHandle CreatePollerFor(SocketHandle socket, PollerEventFlag eventFlag)
+{
+    auto* const poller = CreatePoller();
+    if (poller == nullptr || AddSocketToPoller(poller, socket, (uint32_t)eventFlag, 0) == ErrorIndicator::Error)
+        std::exit(EXIT_FAILURE);
+
+    return poller;
+}
+
+static uint64_t GetPercentile(const std::vector<uint64_t>& sortedValues, double percentile)
+{
+    const auto index = (size_t)(percentile / 100.0 * (double)(sortedValues.size() - (size_t)1) + 0.5);
+    return sortedValues[index];
+}
+
+//Each round trip sends a message and waits until the peer echoes it back.
+static void RunTCPPingPong()
+{
+    const ConnectionPair pair = CreateConnectionPair();
+    SetTCPSocketNaglesAlgorithm(pair.clientSocket, Bool::False);
+    SetTCPSocketNaglesAlgorithm(pair.serverSocket, Bool::False);
+
+    const int32_t totalRoundTripCount = pingPongWarmupCount + pingPongRoundTripCount;
+    std::thread echoThread([&pair, totalRoundTripCount]
+    {
+        auto* const readablePoller = CreatePollerFor(pair.serverSocket, PollerEventFlag::Readable);
+        auto* const writablePoller = CreatePollerFor(pair.serverSocket, PollerEventFlag::Writable);
+        std::byte message[pingPongMessageSize];
+        for (auto i = (int32_t)0; i < totalRoundTripCount; ++i)
+        {
+            if (!TransferAll(readablePoller, pair.serverSocket, message, pingPongMessageSize, false) ||
+                !TransferAll(writablePoller, pair.serverSocket, message, pingPongMessageSize, true))
+            {
+                std::exit(EXIT_FAILURE);
+            }
+        }
+
+        DestroyPoller(readablePoller);
+        DestroyPoller(writablePoller);
+    });
+
+    auto* const readablePoller = CreatePollerFor(pair.clientSocket, PollerEventFlag::Readable);
+    auto* const writablePoller = CreatePollerFor(pair.clientSocket, PollerEventFlag::Writable);
+    std::byte message[pingPongMessageSize]{};
+    std::vector<uint64_t> roundTripTimes;
+    roundTripTimes.reserve((size_t)pingPongRoundTripCount);
+    for (auto i = (int32_t)0; i < totalRoundTripCount; ++i)
+    {
+        const auto start = Clock::now();
+        if (!TransferAll(writablePoller, pair.clientSocket, message, pingPongMessageSize, true) ||
+            !TransferAll(readablePoller, pair.clientSocket, message, pingPongMessageSize, false))
+        {
+            std::exit(EXIT_FAILURE);
+        }
+
+        if (i >= pingPongWarmupCount)
+            roundTripTimes.push_back((uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+    }
+
+    echoThread.join();
+    DestroyPoller(readablePoller);
+    DestroyPoller(writablePoller);
+    DestroySocket(pair.clientSocket);
+    DestroySocket(pair.serverSocket);
+
+    std::sort(roundTripTimes.begin(), roundTripTimes.end());
+    auto totalTime = (uint64_t)0;
+    for (const auto roundTripTime : roundTripTimes)
+        totalTime += roundTripTime;
+
+    std::printf("{\"benchmark\":\"tcp_ping_pong\",\"message_size\":%zu,\"round_trip_count\":%d,\"mean_ns\":%llu,"
+        "\"p50_ns\":%llu,\"p90_ns\":%llu,\"p99_ns\":%llu,\"p999_ns\":%llu,\"max_ns\":%llu}\n",
+        pingPongMessageSize, (int)pingPongRoundTripCount, (unsigned long long)(totalTime / roundTripTimes.size()),
+        (unsigned long long)GetPercentile(roundTripTimes, 50.0), (unsigned long long)GetPercentile(roundTripTimes, 90.0),
+        (unsigned long long)GetPercentile(roundTripTimes, 99.0), (unsigned long long)GetPercentile(roundTripTimes, 99.9),
+        (unsigned long long)roundTripTimes.back());
+}
+
+//The sender sends messages for a fixed time and closes the connection. The receiver measures until it sees the closure.
+static void RunTCPStreaming(size_t messageSize)
+{
+    const ConnectionPair pair = CreateConnectionPair();
+
+    std::thread senderThread([&pair, messageSize]
+    {
+        auto* const poller = CreatePollerFor(pair.clientSocket, PollerEventFlag::Writable);
+        std::vector<std::byte> message(messageSize);
+        const auto end = Clock::now() + streamingDuration;
+        while (Clock::now() < end)
+            if (!TransferAll(poller, pair.clientSocket, message.data(), messageSize, true))
+                std::exit(EXIT_FAILURE);
+
+        DestroyPoller(poller);
+        DestroySocket(pair.clientSocket);
+    });
+
+    auto* const poller = CreatePollerFor(pair.serverSocket, PollerEventFlag::Readable);
+    std::vector<std::byte> buffer(messageSize > (size_t)65536 ? messageSize : (size_t)65536);
+    BufferSegment segment{ buffer.data(), buffer.size() };
+    auto receivedByteCount = (uint64_t)0;
+    PollerEvent event;
+    int32_t eventCount;
+
+    const auto start = Clock::now();
+    while (true)
+    {
+        size_t byteCount;
+        const TransferStatus status = Receive(pair.serverSocket, &segment, 1, &byteCount);
+        if (status == TransferStatus::Transferred)
+            receivedByteCount += (uint64_t)byteCount;
+        else if (status == TransferStatus::WouldBlock)
+            WaitForPollerEvents(poller, &event, 1, -1, &eventCount);
+        else if (status == TransferStatus::ConnectionClosed)
+            break;
+        else
+            std::exit(EXIT_FAILURE);
+    }
+
+    const double time = std::chrono::duration<double>(Clock::now() - start).count();
+
+    senderThread.join();
+    DestroyPoller(poller);
+    DestroySocket(pair.serverSocket);
+
+    std::printf("{\"benchmark\":\"tcp_streaming\",\"message_size\":%zu,\"byte_count\":%llu,\"seconds\":%.6f,"
+        "\"bytes_per_second\":%.0f,\"messages_per_second\":%.0f}\n",
+        messageSize, (unsigned long long)receivedByteCount, time, receivedByteCount / time, receivedByteCount / (double)messageSize / time);
+}
+
+//Datagrams are sent in batches for a fixed time. Datagrams dropped by the system are counted as sent but not received.
+static void RunUDPDatagramRate()
+{
+    uint16_t senderPortNumber = 0;
+    uint16_t receiverPortNumber = 0;
+    auto* const sender = CreateIPv4UDPSocket(loopbackAddress, &senderPortNumber);
+    auto* const receiver = CreateIPv4UDPSocket(loopbackAddress, &receiverPortNumber);
+    if (sender == nullptr || receiver == nullptr)
+        std::exit(EXIT_FAILURE);
+
+    ErrorIPSocketAddress destination{};
+    destination.port = HostToNetworkBO_16(receiverPortNumber);
+    destination.v4 = loopbackAddress;
+
+    std::atomic<bool> isSending = true;
+    auto sentDatagramCount = (uint64_t)0;
+    double sendingTime = 0.0;
+    std::thread senderThread([&]
+    {
+        std::byte payload[datagramSize]{};
+        BufferSegment segment{ payload, datagramSize };
+        Datagram datagrams[datagramBatchSize]{};
+        for (auto& datagram : datagrams)
+        {
+            datagram.socketAddressInNetworkBO = destination;
+            datagram.segments = &segment;
+            datagram.segmentCount = 1;
+        }
+
+        auto* const poller = CreatePollerFor(sender, PollerEventFlag::Writable);
+        PollerEvent event;
+        int32_t eventCount;
+        const auto start = Clock::now();
+        const auto end = start + datagramDuration;
+        while (Clock::now() < end)
+        {
+            int32_t batchSentDatagramCount;
+            const TransferStatus status = SendDatagramBatch(sender, datagrams, datagramBatchSize, &batchSentDatagramCount);
+            if (status == TransferStatus::Transferred)
+                sentDatagramCount += (uint64_t)batchSentDatagramCount;
+            else if (status == TransferStatus::WouldBlock)
+                WaitForPollerEvents(poller, &event, 1, -1, &eventCount);
+            else
+                std::exit(EXIT_FAILURE);
+        }
+
+        sendingTime = std::chrono::duration<double>(Clock::now() - start).count();
+        DestroyPoller(poller);
+        isSending.store(false, std::memory_order_release);
+    });
+
+    std::byte payload[datagramSize];
+    BufferSegment segment{ payload, datagramSize };
+    Datagram datagrams[datagramBatchSize]{};
+    for (auto& datagram : datagrams)
+    {
+        datagram.segments = &segment;
+        datagram.segmentCount = 1;
+    }
+
+    auto* const poller = CreatePollerFor(receiver, PollerEventFlag::Readable);
+    PollerEvent event;
+    int32_t eventCount;
+    auto receivedDatagramCount = (uint64_t)0;
+    while (true)
+    {
+        //The sender is checked before receiving, so the datagrams sent before it finished are all received.
+        const bool hasSenderFinished = !isSending.load(std::memory_order_acquire);
+
+        int32_t batchReceivedDatagramCount;
+        const TransferStatus status = ReceiveDatagramBatch(receiver, datagrams, datagramBatchSize, &batchReceivedDatagramCount);
+        if (status == TransferStatus::Transferred)
+            receivedDatagramCount += (uint64_t)batchReceivedDatagramCount;
+        else if (status == TransferStatus::WouldBlock && hasSenderFinished)
+            break;
+        else if (status == TransferStatus::WouldBlock)
+            WaitForPollerEvents(poller, &event, 1, 10, &eventCount);
+        else
+            std::exit(EXIT_FAILURE);
+    }
+
+    senderThread.join();
+    DestroyPoller(poller);
+    DestroySocket(sender);
+    DestroySocket(receiver);
+
+    std::printf("{\"benchmark\":\"udp_datagram_rate\",\"datagram_size\":%zu,\"batch_size\":%d,\"sent_datagram_count\":%llu,"
+        "\"received_datagram_count\":%llu,\"seconds\":%.6f,\"sent_datagrams_per_second\":%.0f,\"received_datagrams_per_second\":%.0f}\n",
+        datagramSize, (int)datagramBatchSize, (unsigned long long)sentDatagramCount, (unsigned long long)receivedDatagramCount,
+        sendingTime, sentDatagramCount / sendingTime, receivedDatagramCount / sendingTime);
+}
+
+//Client threads connect and reset their connections as fast as they can while one thread accepts and destroys them.
+//The connections are reset on destruction, so the client ports don't stay in the TIME_WAIT state.
+static void RunAcceptChurn()
+{
+    uint16_t portNumber = 0;
+    auto* const listeningSocket = CreateListeningIPv4TCPSocket(loopbackAddress, &portNumber, 4096);
+    if (listeningSocket == nullptr)
+        std::exit(EXIT_FAILURE);
+
+    const int32_t connectionCount = churnConnectionCount / churnClientThreadCount * churnClientThreadCount;
+    const auto start = Clock::now();
+
+    std::vector<std::thread> clientThreads;
+    for (auto i = (int32_t)0; i < churnClientThreadCount; ++i)
+    {
+        clientThreads.emplace_back([portNumber, connectionCount]
+        {
+            SocketProfile profile{};
+            profile.isDestructionTimeoutEnabled = Bool::True;
+
+            for (auto j = (int32_t)0; j < connectionCount / churnClientThreadCount; ++j)
+            {
+                auto* const connectingSocket = CreateConnectedIPv4TCPSocketWithProfile(0, loopbackAddress, portNumber, &profile);
+                if (connectingSocket == nullptr)
+                    std::exit(EXIT_FAILURE);
+
+                WaitForSocket(connectingSocket, PollerEventFlag::Writable);
+                if (IsTCPSocketConnected(connectingSocket) != ErrorBool::True)
+                    std::exit(EXIT_FAILURE);
+
+                DestroySocket(connectingSocket);
+            }
+        });
+    }
+
+    auto* const poller = CreatePollerFor(listeningSocket, PollerEventFlag::Readable);
+    PollerEvent event;
+    int32_t eventCount;
+    SocketHandle connectedSockets[acceptBatchSize];
+    for (auto acceptedConnectionCount = (int32_t)0; acceptedConnectionCount < connectionCount;)
+    {
+        int32_t acceptedBatchSize;
+        if (AcceptNewConnections(listeningSocket, connectedSockets, nullptr, acceptBatchSize, &acceptedBatchSize) == ErrorIndicator::Error)
+            std::exit(EXIT_FAILURE);
+
+        if (acceptedBatchSize == (int32_t)0)
+            WaitForPollerEvents(poller, &event, 1, -1, &eventCount);
+
+        for (auto i = (int32_t)0; i < acceptedBatchSize; ++i)
+            DestroySocket(connectedSockets[i]);
+
+        acceptedConnectionCount += acceptedBatchSize;
+    }
+
+    const double time = std::chrono::duration<double>(Clock::now() - start).count();
+
+    for (auto& clientThread : clientThreads)
+        clientThread.join();
+
+    DestroyPoller(poller);
+    DestroySocket(listeningSocket);
+
+    std::printf("{\"benchmark\":\"accept_churn\",\"connection_count\":%d,\"client_thread_count\":%d,\"seconds\":%.6f,\"accepts_per_second\":%.0f}\n",
+        (int)connectionCount, (int)churnClientThreadCount, time, connectionCount / time);
+}
+
+static void RunNetworkIPAddresses()
+{
+    std::vector<uint64_t> callTimes;
+    callTimes.reserve((size_t)networkIPAddressesCallCount);
+
+    int32_t size = 0;
+    for (auto i = (int32_t)0; i < networkIPAddressesCallCount; ++i)
+    {
+        const auto start = Clock::now();
+        if (GetNetworkIPAddressesArray(&size) == nullptr && size != (int32_t)0)
+            std::exit(EXIT_FAILURE);
+
+        callTimes.push_back((uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+    }
+
+    std::sort(callTimes.begin(), callTimes.end());
+    auto totalTime = (uint64_t)0;
+    for (const auto callTime : callTimes)
+        totalTime += callTime;
+
+    std::printf("{\"benchmark\":\"network_ip_addresses\",\"call_count\":%d,\"address_count\":%d,\"mean_ns\":%llu,"
+        "\"p50_ns\":%llu,\"p99_ns\":%llu,\"max_ns\":%llu}\n",
+        (int)networkIPAddressesCallCount, (int)size, (unsigned long long)(totalTime / callTimes.size()),
+        (unsigned long long)GetPercentile(callTimes, 50.0), (unsigned long long)GetPercentile(callTimes, 99.0),
+        (unsigned long long)callTimes.back());
+}
+
+static bool ShouldRun(int argumentCount, char** arguments, const char* benchmarkName)
+{
+    if (argumentCount < 2)
+        return true;
+
+    for (auto i = 1; i < argumentCount; ++i)
+        if (std::strcmp(arguments[i], benchmarkName) == 0)
+            return true;
+
+    return false;
+}
+
+int main(int argumentCount, char** arguments)
+{
+    SetErrorOccuredCallback(PrintError, nullptr);
+    if (Initialize() == ErrorIndicator::Error)
+        return EXIT_FAILURE;
+
+    std::printf("{\"benchmark\":\"environment\",\"hardware_concurrency\":%u}\n", std::thread::hardware_concurrency());
+    std::fflush(stdout);
+
+    if (ShouldRun(argumentCount, arguments, "tcp_ping_pong"))
+        RunTCPPingPong();
+
+    if (ShouldRun(argumentCount, arguments, "tcp_streaming"))
+        for (const auto messageSize : streamingMessageSizes)
+            RunTCPStreaming(messageSize);
+
+    if (ShouldRun(argumentCount, arguments, "udp_datagram_rate"))
+        RunUDPDatagramRate();
+
+    if (ShouldRun(argumentCount, arguments, "accept_churn"))
+        RunAcceptChurn();
+
+    if (ShouldRun(argumentCount, arguments, "network_ip_addresses"))
+        RunNetworkIPAddresses();
+
+    Shutdown();
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,5 @@
+#!/bin/sh
+
+cd "$(dirname "$0")"
+
+cmake -D PLATFORM_TO_BUILD_FOR=Linux -G "Unix Makefiles" -D CMAKE_BUILD_TYPE=Release -S ../../ -B ../../build
@@ -0,0 +1,46 @@
+#pragma once
+#include <cstdint>
+
+//A context is an isolated instance of the library's runtime state: its own socket table and error callback.
+//The default context always exists and is used by threads which aren't bound to another context.
+//Context handles keep the context index incremented by one in the low half and the context generation in the high half.
+namespace Contexts
+{
+	static constexpr auto maxContextCount = (uint32_t)256;
+	static constexpr auto defaultContextIndex = (uint32_t)0;
+
+	//The returned handle is null if all contexts are used.
+	void* Create() noexcept;
+
+	//Makes the handle stale. The returned index is -1 if the handle is stale, invalid or refers to the default context.
+	//The resources of the context must be released by the caller.
+	int32_t Destroy(const void* contextHandle) noexcept;
+
+	//Makes the handles of all contexts except the default one stale. It's called by the Shutdown function.
+	void DestroyAll() noexcept;
+
+	//The returned index is -1 if the handle is stale or invalid. Passing null returns the default context index.
+	int32_t ToIndex(const void* contextHandle) noexcept;
+
+	//Returns the index of the context the calling thread is bound to.
+	//If that context has been destroyed, the default context index is returned.
+	uint32_t GetCurrentIndex() noexcept;
+
+	//The index must refer to a living context.
+	void BindCurrentThread(uint32_t contextIndex) noexcept;
+
+	//Binds the calling thread to the context for the lifetime of the scope, so the library works on that context.
+	class Scope final
+	{
+	public:
+		explicit Scope(uint32_t contextIndex) noexcept;
+		Scope(const Scope&) = delete;
+		~Scope() noexcept;
+
+		Scope& operator=(const Scope&) = delete;
+
+	private:
+		uint32_t m_previousContextIndex;
+		uint32_t m_previousGeneration;
+	};
+}
\ No newline at end of file
@@ -1,5 +1,8 @@
 #pragma once
+#include <cstdint>
+#include <atomic>
 #include "Error.hpp"
+#include "Contexts.hpp"
 
 #include "SystemIncludeDefine.hpp"
 
@@ -15,7 +18,56 @@ public:
 	static void SignalError(SDS::Error error) noexcept;
 
 	//This function will throw an exception if the passed callback is invalid.
-	static void SetCallback(SDS::ErrorOccuredCallback callback, void* callbackContext);
+	//It can be called while other threads are signaling errors. Each of them calls either the old callback or the new one.
+	//Errors are passed to the callback of the context the signaling thread works on.
+	static void SetCallback(SDS::ErrorOccuredCallback callback, void* callbackContext,
+		uint32_t contextIndex = Contexts::defaultContextIndex);
+
+	//Makes the context pass its errors to the callback of the default context.
+	static void ResetCallback(uint32_t contextIndex) noexcept;
+
+	//The last error is remembered per thread, so the functions below only affect the calling thread.
+	static SDS::Error GetThreadLastError(int64_t& correspondingSystemError_out) noexcept;
+	static void ClearThreadLastError() noexcept;
+	static void SetThreadCallbackSuppression(bool isSuppressed) noexcept;
+
+	//Every context has its own queue. While it's enabled, the errors of the context are pushed to it instead of being passed to the callback.
+	//The queue is created by the first call. Later calls reuse it and ignore the capacity.
+	//The returned bool value is set to false if the queue can't be created. In that case, the error is already signaled.
+	static bool EnableEventQueue(int32_t capacity, uint32_t contextIndex = Contexts::defaultContextIndex) noexcept;
+	static void DisableEventQueue(uint32_t contextIndex = Contexts::defaultContextIndex) noexcept;
+
+	//Disables the queue of the context and discards its events and its dropped event count, so a new context doesn't see them.
+	static void ResetEventQueue(uint32_t contextIndex) noexcept;
+
+	//The returned value is the number of the popped events. Events can be popped while the queue is disabled.
+	static int32_t PopEvents(SDS::ErrorEvent* events_out, int32_t eventCapacity,
+		uint32_t contextIndex = Contexts::defaultContextIndex) noexcept;
+	static uint64_t GetDroppedEventCount(uint32_t contextIndex = Contexts::defaultContextIndex) noexcept;
+
+	//Remembers the socket the calling thread works on, so the errors signaled within the scope are reported with it.
+	//Scopes can be nested. The handle isn't checked, so it's legal to pass a stale one.
+	class SocketScope final
+	{
+	public:
+		explicit SocketScope(const void* socketHandle) noexcept :
+			m_previousSocketHandle(m_currentSocketHandle)
+		{
+			m_currentSocketHandle = socketHandle;
+		}
+
+		SocketScope(const SocketScope&) = delete;
+
+		~SocketScope() noexcept
+		{
+			m_currentSocketHandle = m_previousSocketHandle;
+		}
+
+		SocketScope& operator=(const SocketScope&) = delete;
+
+	private:
+		const void* m_previousSocketHandle;
+	};
 
 	ErrorHandler& operator=(const ErrorHandler&) = delete;
 	ErrorHandler& operator=(ErrorHandler&&) = delete;
@@ -40,10 +92,50 @@ public:
 	static void Handle_accept() noexcept;
 	static void Handle_getpeername() noexcept;
 	static void Handle_connect() noexcept;
+#elif defined __linux__
+	static void Handle_getifaddrs() noexcept;
+	static void Handle_socket(int addressFamily, int socketType, int protocol) noexcept; //The socket type may contain creation flags.
+	static void Handle_bind() noexcept;
+	static void Handle_getsockname() noexcept;
+	static void Handle_close() noexcept;
+	static void Handle_setsockopt() noexcept;
+	static void Handle_getsockopt() noexcept;
+	static void Handle_listen() noexcept;
+	static void Handle_accept() noexcept; //Can be used with accept4.
+	static void Handle_getpeername() noexcept;
+	static void Handle_connect() noexcept;
+	static void Handle_epoll_create1() noexcept;
+	static void Handle_epoll_ctl() noexcept;
+	static void Handle_epoll_wait() noexcept;
+	static void Handle_sendmsg() noexcept; //Can be used with sendmmsg.
+	static void Handle_recvmsg() noexcept; //Can be used with recvmmsg.
+	static void Handle_io_uring_setup() noexcept;
+	static void Handle_io_uring_enter() noexcept;
+	static void Handle_mmap() noexcept;
+	static void Handle_open() noexcept;
+	static void Handle_sendfile() noexcept;
+	static void Handle_splice() noexcept;
+	static void Handle_pipe2() noexcept;
+	static void Handle_memfd_create() noexcept;
+	static void Handle_ftruncate() noexcept;
+	static void Handle_sock_extended_err(int errorCode) noexcept; //An error taken from the error queue of a socket.
 #endif
 
 private:
-	//The callback is set to an empty function by default.
-	static SDS::ErrorOccuredCallback m_callback;
-	inline static void* m_callbackContext = nullptr;
+	struct CallbackBinding final
+	{
+		SDS::ErrorOccuredCallback callback;
+		void* callbackContext;
+	};
+
+	//The callback and its context are replaced together, so a callback is never called with the context of another one.
+	//The binding of the default context is set to an empty function by default. Other contexts have no binding until it's set.
+	//Replaced bindings are never freed, because another thread may still be calling them.
+	static const CallbackBinding m_defaultCallbackBinding;
+	static std::atomic<const CallbackBinding*> m_callbackBindings[Contexts::maxContextCount];
+
+	inline static thread_local const void* m_currentSocketHandle = nullptr;
+
+	//Remembers the error for the calling thread, then pushes it to the event queue or calls the callback unless the thread suppressed it.
+	static void ReportError(SDS::Error error, int64_t correspondingSystemError) noexcept;
 };
\ No newline at end of file
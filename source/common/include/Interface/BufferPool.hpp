@@ -0,0 +1,38 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include "SocketDataSharing.hpp"
+
+#include "IndirectIncludes/SocketDataSharingAPIDefine.hpp"
+
+//A pool of I/O buffers, so sending and receiving in a loop doesn't allocate. Buffers come in power of two size classes
+//from 256 bytes to 1 MiB, and every thread caches a few free buffers of each class, so acquiring and releasing rarely lock.
+//Buffers are cache line aligned and reference counted, so one buffer can be queued for sending on many sockets
+//and released by each of them. The memory of released buffers is kept for reuse, not returned to the system.
+//The memory is backed by huge pages when the system has them reserved, otherwise transparent huge pages are requested.
+//Every thread takes its buffers from the memory of the NUMA node it runs on, so pin the threads which use buffers.
+//Huge pages and NUMA binding are currently only implemented on Linux. Windows only binds the memory to the node.
+
+namespace SDS
+{
+	extern "C"
+	{
+		//The returned buffer is referenced once and its capacity is never less than the size. Sizes greater than 1 MiB
+		//are allocated separately and returned to the system when released. Returns null if the memory can't be allocated.
+		SOCKETDATASHARING_API void* AcquireBuffer(size_t size, size_t* capacity_out) noexcept;
+
+		//Adds a reference. Every reference must be released. The buffer must not be accessed after its last release.
+		SOCKETDATASHARING_API ErrorIndicator RetainBuffer(void* buffer) noexcept;
+		SOCKETDATASHARING_API ErrorIndicator ReleaseBuffer(void* buffer) noexcept;
+
+		//Returns 0 if the buffer isn't valid.
+		SOCKETDATASHARING_API size_t GetBufferCapacity(const void* buffer) noexcept;
+
+		//The snapshot isn't atomic as a whole, so the counts may be a bit off while other threads use the pool.
+		SOCKETDATASHARING_API ErrorIndicator GetBufferPoolStatistics(BufferPoolStatistics* statistics_out) noexcept;
+
+		//Makes the thread take its buffers from the memory of the node, e.g. the node of the sockets the thread serves.
+		//Negative nodes mean the node the thread runs on. Nodes from 8 on aren't bound, so the system places their memory.
+		SOCKETDATASHARING_API void SetThreadBufferNUMANode(int32_t numaNode) noexcept;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,70 @@
+#pragma once
+#include <cstdint>
+#include "SocketDataSharing.hpp"
+
+#include "IndirectIncludes/SocketDataSharingAPIDefine.hpp"
+
+//A completion queue performs socket operations on behalf of the caller and reports their results.
+//Unlike a poller, it doesn't report that a socket is ready, so there is no second call to transfer the data.
+//The operations are submitted in batches and their completions are reaped in batches, usually with one system call per batch.
+//Completion queues can only be used if the completion engine was selected. They work on the same socket handles as
+//the rest of the library. Currently, completion queues are only implemented on Linux (io_uring, kernel 5.17 or newer).
+
+namespace SDS
+{
+	extern "C"
+	{
+		using CompletionQueueHandle = void*;
+
+		//Must be called before the Initialize function. IOEngine::Readiness is preferred by default.
+		SOCKETDATASHARING_API ErrorIndicator SetPreferredIOEngine(IOEngine ioEngine) noexcept;
+
+		//Returns the engine selected by the Initialize function.
+		//If the completion engine was preferred but the system doesn't support it, the readiness engine is selected instead.
+		//Pollers and the transfer functions work with both engines.
+		SOCKETDATASHARING_API IOEngine GetSelectedIOEngine() noexcept;
+
+		//The capacity is the maximum number of pending operations. It must be within the inclusive range of 1 to 4096.
+		//A completion queue must only be used by one thread at a time. At most 1024 completion queues can exist at once.
+		//If an error occured, the returned pointer is null.
+		//The Shutdown function automatically destroys all created completion queues.
+		SOCKETDATASHARING_API CompletionQueueHandle CreateCompletionQueue(int32_t capacity) noexcept;
+
+		//Pending operations are canceled without completions. Sockets used with the queue aren't destroyed.
+		SOCKETDATASHARING_API ErrorIndicator DestroyCompletionQueue(CompletionQueueHandle completionQueueHandle) noexcept;
+
+		//The submitting functions only queue the operations. They are passed to the system by the next WaitForCompletions call
+		//or when the submission queue is full. The tag is returned with the completion of the operation.
+		//The segments and the memory they point to must stay valid until the operation is completed.
+
+		//Accepts one connection. The accepted socket is returned by the completion.
+		SOCKETDATASHARING_API ErrorIndicator SubmitAccept(CompletionQueueHandle completionQueueHandle,
+			SocketHandle listeningSocketHandle, uint64_t tag) noexcept;
+
+		//Creates a TCP socket and connects it to the destination, which must be in network byte order. Its error indicator is ignored.
+		//The connecting socket isn't bound explicitly, so the system binds it to a port number from its ephemeral port range.
+		//If the connection attempt failed, the socket must be destroyed.
+		//If an error occured, the returned pointer is null and no operation is submitted.
+		SOCKETDATASHARING_API SocketHandle SubmitConnect(CompletionQueueHandle completionQueueHandle,
+			const ErrorIPSocketAddress* destinationInNetworkBO, uint64_t tag) noexcept;
+
+		//The segment count must be within the inclusive range of 1 to 1024. Fewer bytes than requested can be transferred.
+		SOCKETDATASHARING_API ErrorIndicator SubmitSend(CompletionQueueHandle completionQueueHandle,
+			SocketHandle connectedSocketHandle, const BufferSegment* segments, int32_t segmentCount, uint64_t tag) noexcept;
+		SOCKETDATASHARING_API ErrorIndicator SubmitReceive(CompletionQueueHandle completionQueueHandle,
+			SocketHandle connectedSocketHandle, const BufferSegment* segments, int32_t segmentCount, uint64_t tag) noexcept;
+
+		//The socket handle becomes invalid immediately, even before the operation is completed.
+		SOCKETDATASHARING_API ErrorIndicator SubmitDestroySocket(CompletionQueueHandle completionQueueHandle,
+			SocketHandle socketHandle, uint64_t tag) noexcept;
+
+		//Passes the submitted operations to the system, waits until at least one operation is completed or the timeout is expired,
+		//then fills the array with up to completionCapacity completions.
+		//Passing a negative timeout waits infinitely. Passing a zero timeout returns immediately.
+		//If the timeout is expired, completionCount_out is set to zero. Being interrupted by a signal is treated the same way.
+		//Failed operations are reported with TransferStatus::Error, and their errors are signaled while their completions are reaped.
+		//The completion capacity must be at least 1. Otherwise, Error::InvalidOutputCapacity is signaled.
+		SOCKETDATASHARING_API ErrorIndicator WaitForCompletions(CompletionQueueHandle completionQueueHandle, Completion* completions_out,
+			int32_t completionCapacity, int32_t timeoutInMilliseconds, int32_t* completionCount_out) noexcept;
+	}
+}
@@ -0,0 +1,96 @@
+#pragma once
+#include <cstdint>
+#include "SocketDataSharing.hpp"
+#include "Poller.hpp"
+#include "Error.hpp"
+
+#include "IndirectIncludes/SocketDataSharingAPIDefine.hpp"
+
+//A context is an isolated instance of the library's runtime: it has its own socket table, error callback and error event queue,
+//so contexts share no socket state with each other. Use one context per core to keep the cores from contending.
+//The default context always exists. The functions without a context handle work on the context the calling thread is bound to,
+//which is the default context unless BindThreadToContext was called. Accepted sockets belong to the context of the listening socket.
+//A context has no poller of its own. Create pollers in it with CreatePollerInContext, so they are destroyed with the context.
+//Buffer pool memory isn't isolated per context but per thread: every thread caches its own buffers and takes them from the memory
+//of its NUMA node (see SetThreadBufferNUMANode). So bind each thread to one context and pin it to a core of the context's node.
+//Currently, contexts are only implemented on Linux.
+
+namespace SDS
+{
+	extern "C"
+	{
+		using ContextHandle = void*;
+
+		//Passing null as a context handle to any function below means the default context.
+
+		//Up to 255 contexts can exist at once besides the default one.
+		//If an error occured, the returned pointer is null.
+		SOCKETDATASHARING_API ContextHandle CreateContext() noexcept;
+
+		//Destroys all sockets and pollers created in the context. The default context can't be destroyed.
+		//Threads bound to the context are bound back to the default context.
+		//The context must not be destroyed while other threads are creating sockets in it.
+		//The Shutdown function automatically destroys all created contexts.
+		SOCKETDATASHARING_API ErrorIndicator DestroyContext(ContextHandle contextHandle) noexcept;
+
+		//Works like SetErrorOccuredCallback but only for the errors which occur while the library works on the context.
+		//Until it's called, the errors are passed to the callback of the default context. Passing an invalid callback will throw an exception.
+		SOCKETDATASHARING_API ErrorIndicator SetContextErrorOccuredCallback(ContextHandle contextHandle,
+			ErrorOccuredCallback callback, void* callbackContext);
+
+		//Makes the functions called by this thread work on the context. Other threads aren't affected.
+		SOCKETDATASHARING_API ErrorIndicator BindThreadToContext(ContextHandle contextHandle) noexcept;
+
+		//These functions work like the functions without the InContext suffix, but they create the socket or the poller in the context.
+		//Errors are passed to the callback of the context.
+
+		SOCKETDATASHARING_API SocketHandle CreateIPv4UDPSocketInContext(ContextHandle contextHandle,
+			IPv4Address ipv4Address, uint16_t* portNumberInHostBO_inout) noexcept;
+		SOCKETDATASHARING_API SocketHandle CreateIPv6UDPSocketInContext(ContextHandle contextHandle,
+			IPv6Address ipv6AddressInNetworkBO, uint16_t* portNumberInHostBO_inout) noexcept;
+
+		SOCKETDATASHARING_API SocketHandle CreateListeningIPv4TCPSocketInContext(ContextHandle contextHandle, IPv4Address ipv4Address,
+			uint16_t* portNumberInHostBO_inout, uint32_t pendingConnectionQueueSize) noexcept;
+		SOCKETDATASHARING_API SocketHandle CreateListeningIPv6TCPSocketInContext(ContextHandle contextHandle, IPv6Address ipv6AddressInNetworkBO,
+			uint16_t* portNumberInHostBO_inout, uint32_t pendingConnectionQueueSize) noexcept;
+
+		SOCKETDATASHARING_API ErrorIndicator CreateListeningIPv4TCPSocketGroupInContext(ContextHandle contextHandle, IPv4Address ipv4Address,
+			uint16_t* portNumberInHostBO_inout, uint32_t pendingConnectionQueueSize, int32_t listeningSocketCount, Bool shouldSteerByCPU,
+			SocketHandle* listeningSocketHandles_out) noexcept;
+		SOCKETDATASHARING_API ErrorIndicator CreateListeningIPv6TCPSocketGroupInContext(ContextHandle contextHandle, IPv6Address ipv6AddressInNetworkBO,
+			uint16_t* portNumberInHostBO_inout, uint32_t pendingConnectionQueueSize, int32_t listeningSocketCount, Bool shouldSteerByCPU,
+			SocketHandle* listeningSocketHandles_out) noexcept;
+
+		SOCKETDATASHARING_API SocketHandle CreateConnectedIPv4TCPSocketInContext(ContextHandle contextHandle, uint16_t portNumberToConnectFromInHostBO,
+			IPv4Address ipv4AddressToConnectTo, uint16_t portNumberToConnectToInHostBO) noexcept;
+		SOCKETDATASHARING_API SocketHandle CreateConnectedIPv6TCPSocketInContext(ContextHandle contextHandle, uint16_t portNumberToConnectFromInHostBO,
+			IPv6Address ipv6AddressToConnectToInHostBO, uint16_t portNumberToConnectToInHostBO) noexcept;
+
+		SOCKETDATASHARING_API PollerHandle CreatePollerInContext(ContextHandle contextHandle) noexcept;
+
+		//These functions work like the functions with the WithProfile suffix, but they create the socket in the context.
+		//The profile's options are set before the socket is bound, listens or connects. Passing null keeps the system defaults.
+
+		SOCKETDATASHARING_API SocketHandle CreateIPv4UDPSocketInContextWithProfile(ContextHandle contextHandle,
+			IPv4Address ipv4Address, uint16_t* portNumberInHostBO_inout, const SocketProfile* profile) noexcept;
+		SOCKETDATASHARING_API SocketHandle CreateIPv6UDPSocketInContextWithProfile(ContextHandle contextHandle,
+			IPv6Address ipv6AddressInNetworkBO, uint16_t* portNumberInHostBO_inout, const SocketProfile* profile) noexcept;
+
+		SOCKETDATASHARING_API SocketHandle CreateListeningIPv4TCPSocketInContextWithProfile(ContextHandle contextHandle, IPv4Address ipv4Address,
+			uint16_t* portNumberInHostBO_inout, uint32_t pendingConnectionQueueSize, const SocketProfile* profile) noexcept;
+		SOCKETDATASHARING_API SocketHandle CreateListeningIPv6TCPSocketInContextWithProfile(ContextHandle contextHandle, IPv6Address ipv6AddressInNetworkBO,
+			uint16_t* portNumberInHostBO_inout, uint32_t pendingConnectionQueueSize, const SocketProfile* profile) noexcept;
+
+		SOCKETDATASHARING_API ErrorIndicator CreateListeningIPv4TCPSocketGroupInContextWithProfile(ContextHandle contextHandle, IPv4Address ipv4Address,
+			uint16_t* portNumberInHostBO_inout, uint32_t pendingConnectionQueueSize, int32_t listeningSocketCount, Bool shouldSteerByCPU,
+			SocketHandle* listeningSocketHandles_out, const SocketProfile* profile) noexcept;
+		SOCKETDATASHARING_API ErrorIndicator CreateListeningIPv6TCPSocketGroupInContextWithProfile(ContextHandle contextHandle, IPv6Address ipv6AddressInNetworkBO,
+			uint16_t* portNumberInHostBO_inout, uint32_t pendingConnectionQueueSize, int32_t listeningSocketCount, Bool shouldSteerByCPU,
+			SocketHandle* listeningSocketHandles_out, const SocketProfile* profile) noexcept;
+
+		SOCKETDATASHARING_API SocketHandle CreateConnectedIPv4TCPSocketInContextWithProfile(ContextHandle contextHandle, uint16_t portNumberToConnectFromInHostBO,
+			IPv4Address ipv4AddressToConnectTo, uint16_t portNumberToConnectToInHostBO, const SocketProfile* profile) noexcept;
+		SOCKETDATASHARING_API SocketHandle CreateConnectedIPv6TCPSocketInContextWithProfile(ContextHandle contextHandle, uint16_t portNumberToConnectFromInHostBO,
+			IPv6Address ipv6AddressToConnectToInHostBO, uint16_t portNumberToConnectToInHostBO, const SocketProfile* profile) noexcept;
+	}
+}
\ No newline at end of file
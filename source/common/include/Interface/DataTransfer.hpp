@@ -0,0 +1,120 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include "SocketDataSharing.hpp"
+
+#include "IndirectIncludes/SocketDataSharingAPIDefine.hpp"
+
+//All transfer functions are non-blocking. TransferStatus::WouldBlock is returned without calling the error callback.
+//Wait for PollerEventFlag::Readable or PollerEventFlag::Writable and try again.
+//All buffer segments are transferred in one system call. Currently, these functions are only implemented on Linux.
+
+namespace SDS
+{
+	extern "C"
+	{
+		//The segment count must be within the inclusive range of 1 to 1024.
+
+		//This function can only be used with connected TCP sockets.
+		//sentByteCount_out is set to the number of bytes which were sent. It can be less than the total size of the segments.
+		//Send the rest later, starting from the first unsent byte.
+		SOCKETDATASHARING_API TransferStatus Send(SocketHandle connectedSocketHandle,
+			const BufferSegment* segments, int32_t segmentCount, size_t* sentByteCount_out) noexcept;
+
+		//This function can only be used with connected TCP sockets.
+		//The segments are filled in order. receivedByteCount_out is set to the number of bytes which were received.
+		SOCKETDATASHARING_API TransferStatus Receive(SocketHandle connectedSocketHandle,
+			const BufferSegment* segments, int32_t segmentCount, size_t* receivedByteCount_out) noexcept;
+
+		//This function can only be used with UDP sockets. The segments are sent as one datagram.
+		//The destination must be in network byte order and use the same IP version as the socket. Its error indicator is ignored.
+		//A datagram is either sent completely or not sent at all.
+		SOCKETDATASHARING_API TransferStatus SendTo(SocketHandle udpSocketHandle, const BufferSegment* segments, int32_t segmentCount,
+			const ErrorIPSocketAddress* destinationInNetworkBO, size_t* sentByteCount_out) noexcept;
+
+		//This function can only be used with UDP sockets. It receives one datagram.
+		//The source is returned in network byte order. Passing null to sourceInNetworkBO_out is legal.
+		SOCKETDATASHARING_API TransferStatus ReceiveFrom(SocketHandle udpSocketHandle, const BufferSegment* segments, int32_t segmentCount,
+			ErrorIPSocketAddress* sourceInNetworkBO_out, size_t* receivedByteCount_out) noexcept;
+
+		//Batch functions transfer many datagrams with as few system calls as possible (one call per 64 datagrams).
+		//They can only be used with UDP sockets. Passing a non-positive datagram count transfers nothing.
+		//If at least one datagram was transferred, TransferStatus::Transferred is returned even if an error occured later.
+
+		//Datagrams are sent in order. If fewer datagrams than requested were sent, send the rest later.
+		SOCKETDATASHARING_API TransferStatus SendDatagramBatch(SocketHandle udpSocketHandle,
+			Datagram* datagrams, int32_t datagramCount, int32_t* sentDatagramCount_out) noexcept;
+
+		//Fills the datagrams in order until there are no more received datagrams or the array is full.
+		SOCKETDATASHARING_API TransferStatus ReceiveDatagramBatch(SocketHandle udpSocketHandle,
+			Datagram* datagrams, int32_t datagramCount, int32_t* receivedDatagramCount_out) noexcept;
+
+		//Zero-copy sending lets the system transmit straight from the caller's memory instead of copying it.
+		//The memory must not be changed until the send is reported as completed. Requires Linux 4.14.
+		//Pinning the memory and reporting the completion cost more than copying a small payload.
+
+		//This function can only be used with TCP sockets. It must be called with Bool::True before SendZeroCopy is used.
+		//Otherwise, SendZeroCopy copies the data. Sockets accepted from a listening socket with zero-copy sending must enable it themselves.
+		SOCKETDATASHARING_API ErrorIndicator SetTCPSocketZeroCopy(SocketHandle tcpSocketHandle, Bool isEnabled) noexcept;
+
+		//Payloads smaller than the threshold are copied by SendZeroCopy as usual. It's 10240 bytes by default and applies to all sockets.
+		SOCKETDATASHARING_API void SetZeroCopySendThreshold(size_t thresholdInBytes) noexcept;
+
+		//Works like the Send function. If isZeroCopy_out is set to Bool::True, the send was given the next ID of the socket.
+		//IDs start from zero and only count zero-copy sends which transferred at least one byte.
+		//Otherwise, the payload was copied and the memory may be reused right away. That happens if the payload is smaller than
+		//the threshold, zero-copy sending isn't enabled or the system is out of memory for pinning the pages.
+		SOCKETDATASHARING_API TransferStatus SendZeroCopy(SocketHandle connectedSocketHandle, const BufferSegment* segments,
+			int32_t segmentCount, size_t* sentByteCount_out, Bool* isZeroCopy_out) noexcept;
+
+		//Pending completions make the poller report PollerEventFlag::Failed for the socket. They don't mean that an error occured.
+		//Other errors queued for the socket, e.g. ICMP errors, are taken from the queue as well and signaled.
+		//TransferStatus::WouldBlock is returned if there are no completions and no errors. If there are only errors, TransferStatus::Error is returned.
+		SOCKETDATASHARING_API TransferStatus ReceiveZeroCopySendCompletions(SocketHandle connectedSocketHandle,
+			ZeroCopySendCompletion* completions_out, int32_t completionCapacity, int32_t* completionCount_out) noexcept;
+
+		//File functions move data between a file and a connected TCP socket without copying it through user memory.
+		//The file descriptor is a native one, e.g. returned by open. The library never closes it.
+		//Fewer bytes than requested can be transferred. Call the function again with the offset moved by the transferred byte count.
+
+		//Sends up to length bytes of the file starting from the offset. The file position isn't changed.
+		//If the file ends before the range does, only the bytes up to the end of the file are sent.
+		//If the offset is at or past the end of the file, TransferStatus::Transferred is returned with zero sent bytes.
+		SOCKETDATASHARING_API TransferStatus SendFileRange(SocketHandle connectedSocketHandle, int32_t fileDescriptor,
+			uint64_t offset, uint64_t length, uint64_t* sentByteCount_out) noexcept;
+
+		//Works like SendFileRange but opens the file for the duration of the call.
+		//Use SendFileRange if the range is sent with many calls, so the file isn't reopened every time.
+		SOCKETDATASHARING_API TransferStatus SendFileRangeByPath(SocketHandle connectedSocketHandle, const char* filePath,
+			uint64_t offset, uint64_t length, uint64_t* sentByteCount_out) noexcept;
+
+		//Receives up to length bytes and writes them to the file starting from the offset. The file must be opened for writing
+		//without O_APPEND. The file position isn't changed. The data is moved through a pipe which is reused by the calling thread.
+		//If writing to the file failed, the data which was already received by this call is lost.
+		SOCKETDATASHARING_API TransferStatus ReceiveToFile(SocketHandle connectedSocketHandle, int32_t fileDescriptor,
+			uint64_t offset, uint64_t length, uint64_t* receivedByteCount_out) noexcept;
+
+		//UDP offload lets the system split one large buffer into many datagrams and merge received datagrams back.
+		//Segmentation requires Linux 4.18 and coalescing requires Linux 5.0. Otherwise, Error::UnsupportedSocketOption is signaled.
+
+		//Sets the segment size used by SendTo and SendDatagramBatch for this socket. Passing a zero disables segmentation.
+		//Buffers larger than the segment size are sent as a series of datagrams, the last of which may be shorter.
+		SOCKETDATASHARING_API ErrorIndicator SetUDPSocketSegmentationOffload(SocketHandle udpSocketHandle, uint16_t segmentSize) noexcept;
+
+		//Allows the system to merge datagrams with the same source and size into one buffer.
+		//Use ReceiveCoalescedDatagrams with such sockets, because the other receiving functions can't report datagram boundaries.
+		//The option is set to Bool::False by default.
+		SOCKETDATASHARING_API ErrorIndicator SetUDPSocketCoalescingOffload(SocketHandle udpSocketHandle, Bool isEnabled) noexcept;
+
+		//Sends the segments as a series of datagrams of segmentSize bytes with one system call regardless of the socket's segment size.
+		//The total size must not exceed 65507 bytes or 64 segments. Otherwise, Error::DatagramIsTooLarge is signaled.
+		SOCKETDATASHARING_API TransferStatus SendSegmentedDatagrams(SocketHandle udpSocketHandle, const BufferSegment* segments, int32_t segmentCount,
+			const ErrorIPSocketAddress* destinationInNetworkBO, uint16_t segmentSize, size_t* sentByteCount_out) noexcept;
+
+		//Receives one or more merged datagrams. Every datagram is datagramSize_out bytes long except the last, which may be shorter.
+		//If the datagrams weren't merged, datagramSize_out is set to the received byte count.
+		//Use a buffer of 65535 bytes to avoid truncating merged datagrams. Passing null to sourceInNetworkBO_out is legal.
+		SOCKETDATASHARING_API TransferStatus ReceiveCoalescedDatagrams(SocketHandle udpSocketHandle, const BufferSegment* segments, int32_t segmentCount,
+			ErrorIPSocketAddress* sourceInNetworkBO_out, size_t* receivedByteCount_out, uint16_t* datagramSize_out) noexcept;
+	}
+}
@@ -1,5 +1,7 @@
 #pragma once
 #include <cstdint>
+#include <cstddef>
+#include "IndirectIncludes/Types.hpp"
 
 #include "IndirectIncludes/SocketDataSharingAPIDefine.hpp"
 
@@ -47,15 +49,105 @@ namespace SDS
 			IPv4UDPIsNotSupported,
 			IPv6TCPIsNotSupported,			
 			IPv6UDPIsNotSupported,
+
+			InvalidPollerHandle,
+			SocketIsAlreadyInPoller,
+			SocketIsNotInPoller,
+			SystemPollerLimitIsReached,
+
+			ConnectionWasReset,
+			DatagramIsTooLarge,
+			TooManyBufferSegments,
+
+			InvalidSocketGroupSize,
+
+			CompletionEngineIsNotSelected,
+			InvalidCompletionQueueHandle,
+			InvalidCompletionQueueCapacity,
+			TooManyPendingOperations,
+
+			InvalidFileDescriptor,
+			FileDoesNotExist,
+			FileAccessIsDenied,
+			FileIsNotSupported,
+			NotEnoughDiskSpace,
+
+			InvalidContextHandle,
+			ContextLimitIsReached,
+
+			InvalidErrorEventQueueCapacity,
+
+			InvalidLatencyHistogramKind,
+
+			InvalidBuffer,
+
+			InvalidRingBufferHandle,
+			InvalidRingBufferCapacity,
+			InvalidRingBufferByteCount,
+			RingBufferIsFull,
+
+			InvalidMessageFramerHandle,
+			InvalidMaxMessageSize,
+			MessageIsTooLarge,
+
+			InvalidSendQueueHandle,
+			InvalidHighWaterMark,
+
+			InvalidOutputCapacity, //The output array must hold at least one element.
 		};
 
 		//Corresponding system error should be ignored unless the error is Error::UnexpectedSystemError.
 		typedef void(*ErrorOccuredCallback)(Error error, int64_t correspondingSystemError, void* callbackContext);
 
+		struct alignas(8) ErrorEvent final
+		{
+			Error error;
+
+			std::byte __padding[4]; //This must be ignored.
+
+			int64_t correspondingSystemError; //Should be ignored unless the error is Error::UnexpectedSystemError.
+			void* socketHandle; //The socket the failed function was called for. It's null if the error isn't related to any socket.
+			uint64_t timestampInNanoseconds; //Taken from a monotonic clock. Only the differences between timestamps are meaningful.
+		};
+
 		//The callback is set to an empty function by default. So that the library won't crash if you don't provide a callback.
 		//But you should set the callback to be able to handle errors.
 		//The callback will be called once with a value of Error::Success to check its validity.
 		//Passing an invalid callback will throw an exception.
+		//The callback is called on the thread where the error occured, so it must be thread safe if the library is used by many threads.
+		//It can be replaced while other threads are using the library. Each error is passed either to the old callback or to the new one.
 		SOCKETDATASHARING_API void SetErrorOccuredCallback(ErrorOccuredCallback callback, void* callbackContext);
+
+		//Every thread remembers the last error which occured on it, even if the callback was suppressed.
+		//Error::Success is returned if no error occured since the thread started or called ClearThreadLastError.
+		//Passing null to correspondingSystemError_out is legal.
+		SOCKETDATASHARING_API Error GetThreadLastError(int64_t* correspondingSystemError_out) noexcept;
+		SOCKETDATASHARING_API void ClearThreadLastError() noexcept;
+
+		//Passing Bool::True stops calling the callback for errors which occur on the calling thread. Other threads aren't affected.
+		//Use it on hot paths which expect failures and check the returned values together with GetThreadLastError instead.
+		//The option is set to Bool::False by default.
+		SOCKETDATASHARING_API void SetThreadErrorCallbackSuppression(Bool isSuppressed) noexcept;
+
+		//The error event queue lets the threads which signal errors avoid calling the callbacks, which may be slow or take locks.
+		//While the queue is enabled, errors are pushed to it instead and the callbacks aren't called. Pushing never locks or allocates.
+		//If the queue is full, the error is dropped and counted. The threads which suppressed the callback don't push their errors.
+		//Every context has its own queue. These functions work on the queue of the context the calling thread is bound to,
+		//and errors are pushed to the queue of the context the library works on when they occur.
+
+		//The capacity must be within the inclusive range of 1 to 1048576. It's rounded up to a power of two.
+		//The queue is created by the first call and lives until the process exits. Later calls ignore the capacity.
+		//A context created in place of a destroyed one starts with the queue disabled and empty.
+		SOCKETDATASHARING_API ErrorIndicator EnableErrorEventQueue(int32_t capacity) noexcept;
+
+		//Errors are passed to the callbacks again. The events which are already in the queue can still be popped.
+		SOCKETDATASHARING_API void DisableErrorEventQueue() noexcept;
+
+		//Pops up to eventCapacity events in the order they were pushed. If the queue is empty, eventCount_out is set to zero.
+		//It can be called by many threads at once, but then the order is only kept within each call.
+		SOCKETDATASHARING_API ErrorIndicator PopErrorEvents(ErrorEvent* events_out, int32_t eventCapacity, int32_t* eventCount_out) noexcept;
+
+		//Returns the number of errors dropped because the queue was full since the queue was created.
+		SOCKETDATASHARING_API uint64_t GetDroppedErrorEventCount() noexcept;
 	}
 }
\ No newline at end of file
@@ -7,6 +7,12 @@
 		#else
 			#define SOCKETDATASHARING_API __declspec(dllexport)
 		#endif
+	#elif defined(__linux__) && defined(__GNUC__)
+		#ifdef SOCKETDATASHARING_STATIC
+			#define SOCKETDATASHARING_API
+		#else
+			#define SOCKETDATASHARING_API __attribute__((visibility("default")))
+		#endif
 	#else
 		#error "This platform or/and compiler are not supported"
 	#endif
@@ -19,6 +25,8 @@
 		#else
 			#define SOCKETDATASHARING_API __declspec(dllimport)
 		#endif
+	#elif defined(__linux__) && defined(__GNUC__)
+		#define SOCKETDATASHARING_API
 	#else
 		#error "This platform or/and compiler are not supported"
 	#endif
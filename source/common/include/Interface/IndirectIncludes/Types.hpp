@@ -79,4 +79,204 @@ namespace SDS
 		IPv4Address v4;
 		IPv6Address v6;
 	};
+
+	//Poller event flags can be combined with the bitwise OR operator.
+	enum class PollerEventFlag : uint32_t
+	{
+		Readable = 1, //The socket has data to receive or, for listening sockets, pending connections.
+		Writable = 2, //The socket can send data. For connecting TCP sockets, it means that the connection attempt is finished.
+		Hangup = 4, //Another host closed the connection. It's reported even if it wasn't requested.
+		Failed = 8, //An error is pending on the socket. It's reported even if it wasn't requested.
+
+		//Only used for registration.
+		EdgeTriggered = 16, //The event is reported once per state change instead of while the state persists.
+		OneShot = 32, //The socket is disabled after the first event until it's modified.
+	};
+
+	struct alignas(8) PollerEvent final
+	{
+		uint64_t tag; //The value passed when the socket was added or modified.
+		uint32_t eventFlags; //A combination of the PollerEventFlag values.
+
+		std::byte __padding[4]; //This must be ignored.
+	};
+
+	//Describes one piece of memory in a scatter/gather list. Pieces are transferred in the order they are passed.
+	struct BufferSegment final
+	{
+		void* data;
+		size_t size;
+	};
+
+	enum class TransferStatus : uint8_t
+	{
+		Error = 0,
+		Transferred = 1, //Some bytes were transferred. Fewer bytes than requested can be transferred.
+		WouldBlock = 2, //Nothing was transferred because the socket isn't ready. It's not an error.
+		ConnectionClosed = 3, //Another host gracefully closed the connection and all data was received.
+		DatagramIsTruncated = 4, //The received datagram didn't fit into the buffers, so the rest of it was discarded.
+	};
+
+	//Describes one datagram for the batch functions.
+	struct alignas(8) Datagram final
+	{
+		ErrorIPSocketAddress socketAddressInNetworkBO; //The destination for sending or the source for receiving.
+
+		const BufferSegment* segments;
+		int32_t segmentCount; //Must be within the inclusive range of 1 to 1024.
+
+		Bool isTruncated; //Set by the receiving function if the datagram didn't fit into the segments.
+
+		std::byte __padding[3]; //This must be ignored.
+
+		size_t transferredByteCount; //Set by the functions.
+	};
+
+	enum class IOEngine : uint8_t
+	{
+		Readiness = 0, //Sockets are polled for readiness, then transferred with separate calls.
+		Completion = 1, //Operations are submitted to a completion queue and their results are reaped in batches.
+	};
+
+	enum class CompletionType : uint8_t
+	{
+		Accept = 1,
+		Connect = 2,
+		Send = 3,
+		Receive = 4,
+		DestroySocket = 5,
+	};
+
+	struct alignas(8) Completion final
+	{
+		uint64_t tag; //The value passed when the operation was submitted.
+
+		//For accepting, it's the accepted socket, which is null if the operation failed.
+		//For other operations, it's the socket the operation was submitted for.
+		void* socketHandle;
+
+		size_t transferredByteCount; //Only set for sending and receiving.
+
+		TransferStatus status; //TransferStatus::WouldBlock and TransferStatus::DatagramIsTruncated are never set.
+		CompletionType type;
+
+		std::byte __padding[6]; //This must be ignored.
+	};
+
+	//Reports that zero-copy sends with IDs within the inclusive range of firstSendID to lastSendID are completed,
+	//so their memory may be reused. IDs wrap around after UINT32_MAX.
+	struct alignas(4) ZeroCopySendCompletion final
+	{
+		uint32_t firstSendID;
+		uint32_t lastSendID;
+
+		//The system copied the data anyway, e.g. because the connection is over loopback.
+		//If it happens repeatedly, sending without zero-copy is cheaper.
+		Bool wasCopied;
+
+		std::byte __padding[3]; //This must be ignored.
+	};
+
+	//Counters only grow. Take two snapshots and subtract them to get the rates.
+	struct alignas(8) IOStatistics final
+	{
+		uint64_t sentByteCount;
+		uint64_t sendCallCount; //Every system call counts, even the ones which transferred nothing.
+		uint64_t receivedByteCount;
+		uint64_t receiveCallCount;
+		uint64_t wouldBlockCount; //The calls which returned TransferStatus::WouldBlock.
+		uint64_t acceptCount; //Accepted connections.
+		uint64_t connectCount; //Started connection attempts.
+
+		//Indexed by the Error value. Errors with values of 63 or greater are counted at the last index.
+		uint64_t errorCounts[64];
+	};
+
+	//The state the system keeps for a TCP connection. Values the system doesn't provide are zero.
+	struct alignas(8) TCPConnectionInfo final
+	{
+		uint64_t deliveryRateInBytesPerSecond; //The recent rate the peer acknowledged the data at.
+		uint64_t pacingRateInBytesPerSecond; //UINT64_MAX means that the sending isn't paced.
+
+		uint32_t smoothedRoundTripTimeInMicroseconds;
+		uint32_t roundTripTimeVarianceInMicroseconds;
+
+		//Segment counts can be turned into byte counts by multiplying them by the segment size.
+		uint32_t congestionWindowInSegments;
+		uint32_t unacknowledgedSegmentCount;
+		uint32_t maxSegmentSize;
+
+		uint32_t retransmittedSegmentCount; //Since the connection was established.
+		uint32_t notSentByteCount; //Bytes which are in the send buffer, but aren't sent yet.
+
+		Bool isValid; //Only set by GetTCPConnectionInfos.
+
+		std::byte __padding[3]; //This must be ignored.
+	};
+
+	enum class LatencyHistogramKind : uint8_t
+	{
+		ConnectionEstablishment = 0, //From creating a connected TCP socket to the library noticing that the connection is established.
+		AcceptQueueDwell = 1, //From the handshake completion to accepting the connection. It has a 1 ms resolution and is off by default.
+		SendCall = 2, //The duration of one send system call.
+	};
+
+	//Values are in nanoseconds. Buckets below 16 are exact, then every power of two is split into 16 buckets,
+	//so a value is known with a precision of 6.25%. Values above about 18 minutes are counted in the last bucket.
+	//Use GetLatencyHistogramBucketLowerBound and GetLatencyHistogramPercentile to read the histogram.
+	struct alignas(8) LatencyHistogram final
+	{
+		uint64_t bucketCounts[592];
+		uint64_t totalCount;
+		uint64_t sumInNanoseconds; //Divide it by the total count to get the mean.
+	};
+
+	struct alignas(8) BufferPoolSizeClassStatistics final
+	{
+		uint64_t blockSize;
+		uint64_t blockCount; //Blocks the pool has reserved memory for.
+		uint64_t usedBlockCount; //Blocks which are referenced by the user.
+		uint64_t threadCachedBlockCount; //Free blocks in the caches of the threads.
+		uint64_t sharedFreeBlockCount; //Free blocks which any thread can take.
+	};
+
+	struct alignas(8) BufferPoolStatistics final
+	{
+		BufferPoolSizeClassStatistics sizeClasses[13]; //From 256 bytes to 1 MiB.
+		uint64_t oversizedBufferCount; //Buffers greater than 1 MiB, which are allocated separately.
+		uint64_t reservedByteCount; //All the memory the pool holds, including the headers of the blocks.
+		uint64_t hugePageByteCount; //The part of the reserved memory which is backed by reserved huge pages.
+	};
+
+	//Options the WithProfile creating functions set before the socket is bound, so the socket is never used half configured.
+	//Zero fields keep the system defaults, so zero-initialize the profile and only set the wanted fields.
+	//Setting an option the protocol doesn't have, e.g. Nagle's algorithm for UDP, makes the creation fail.
+	struct alignas(8) SocketProfile final
+	{
+		//The system doubles the sizes for its bookkeeping and caps them by its limits.
+		uint32_t sendBufferSize;
+		uint32_t receiveBufferSize;
+
+		//How long receiving polls the device queue before waiting. It lowers the latency at the cost of CPU time.
+		//Values above the net.core.busy_read setting require the CAP_NET_ADMIN capability. Linux only.
+		uint32_t busyPollTimeInMicroseconds;
+
+		//How long sent data may stay unacknowledged before the connection is dropped. TCP only. Linux only.
+		uint32_t userTimeoutInMilliseconds;
+
+		//A non-zero idle time enables keepalive probes. The interval and the count can be left zero to keep the system defaults. TCP only.
+		uint32_t keepAliveIdleTimeInSeconds;
+		uint32_t keepAliveIntervalInSeconds;
+		uint32_t keepAliveProbeCount;
+
+		uint16_t destructionTimeoutInSeconds; //Only used if the timeout is enabled. See SetSocketDestructionTimeout.
+		Bool isDestructionTimeoutEnabled;
+		Bool isNaglesAlgorithmDisabled; //TCP only.
+		Bool isBroadcastEnabled; //IPv4 UDP only.
+
+		uint8_t priority; //The priority of the sent packets in the queues of the host. Values above 6 require a privilege. Linux only.
+		uint8_t typeOfService; //The IPv4 type of service or the IPv6 traffic class, e.g. a DSCP value shifted left by 2. Linux only.
+
+		std::byte __padding[5]; //This must be ignored.
+	};
 }
\ No newline at end of file
@@ -0,0 +1,44 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include "SocketDataSharing.hpp"
+
+#include "IndirectIncludes/SocketDataSharingAPIDefine.hpp"
+
+//A message framer turns the byte stream of a connected TCP socket into a stream of messages.
+//Every message is preceded by its size encoded as a varint (7 bits per byte, the lowest bits first),
+//so messages shorter than 128 bytes cost one byte of header. Many messages are sent with one system call,
+//and received messages are returned as views into the receive buffer of the framer, so they are never copied.
+//A framer must only be used by one thread at a time. After an error other than Error::MessageIsTooLarge signaled by sending,
+//the stream may be broken, so the socket should be destroyed. Currently, framers are only implemented on Linux.
+
+namespace SDS
+{
+	extern "C"
+	{
+		using MessageFramerHandle = void*;
+
+		//The max message size must be within the inclusive range of 1 to 67108864 bytes. Both hosts should use the same one.
+		//The framer neither owns nor destroys the socket. If an error occured, the returned pointer is null.
+		SOCKETDATASHARING_API MessageFramerHandle CreateMessageFramer(SocketHandle connectedSocketHandle, size_t maxMessageSize) noexcept;
+		SOCKETDATASHARING_API ErrorIndicator DestroyMessageFramer(MessageFramerHandle messageFramerHandle) noexcept;
+
+		//Every segment is one message. Messages are sent in order with as few system calls as possible (one call per 512 messages).
+		//If a message was only partly taken by the system, the rest is kept by the framer and the message counts as sent.
+		//Until the kept bytes are sent, TransferStatus::WouldBlock is returned and no messages are sent. Use FlushMessageFramer.
+		//If fewer messages than requested were sent, send the rest later. No message is sent if any of them is too large.
+		SOCKETDATASHARING_API TransferStatus SendFramedMessages(MessageFramerHandle messageFramerHandle,
+			const BufferSegment* messages, int32_t messageCount, int32_t* sentMessageCount_out) noexcept;
+
+		//Sends the bytes kept by the framer. TransferStatus::Transferred means that nothing is kept anymore.
+		SOCKETDATASHARING_API TransferStatus FlushMessageFramer(MessageFramerHandle messageFramerHandle) noexcept;
+
+		//Returns complete messages as views which stay valid until the next call of this function or the destruction of the framer.
+		//TransferStatus::Transferred is only returned with at least one message. TransferStatus::WouldBlock means that
+		//no complete message has arrived yet. Passing a non-positive capacity signals Error::InvalidOutputCapacity.
+		//Error::MessageIsTooLarge is signaled if the other host announced a message greater than the max message size.
+		//TransferStatus::ConnectionClosed is returned once all complete messages were returned. An incomplete message is discarded.
+		SOCKETDATASHARING_API TransferStatus ReceiveFramedMessages(MessageFramerHandle messageFramerHandle,
+			BufferSegment* messages_out, int32_t messageCapacity, int32_t* messageCount_out) noexcept;
+	}
+}
\ No newline at end of file
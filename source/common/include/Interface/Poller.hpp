@@ -0,0 +1,42 @@
+#pragma once
+#include <cstdint>
+#include "SocketDataSharing.hpp"
+
+#include "IndirectIncludes/SocketDataSharingAPIDefine.hpp"
+
+//A poller waits on many sockets at once and reports which of them are ready.
+//Idle sockets cost nothing while the poller is waiting. Currently, pollers are only implemented on Linux.
+
+namespace SDS
+{
+	extern "C"
+	{
+		using PollerHandle = void*;
+
+		//If an error occured, the returned pointer is null.
+		//The Shutdown function automatically destroys all created pollers.
+		SOCKETDATASHARING_API PollerHandle CreatePoller() noexcept;
+
+		//Sockets added to the poller aren't destroyed. On Linux, passing a socket handle signals Error::InvalidPollerHandle.
+		SOCKETDATASHARING_API ErrorIndicator DestroyPoller(PollerHandle pollerHandle) noexcept;
+
+		//eventFlags is a combination of the PollerEventFlag values. The tag is returned with every event of the socket.
+		//A socket can be added to any number of pollers but only once to each of them.
+		//Destroying a socket automatically removes it from all pollers.
+		SOCKETDATASHARING_API ErrorIndicator AddSocketToPoller(PollerHandle pollerHandle,
+			SocketHandle socketHandle, uint32_t eventFlags, uint64_t tag) noexcept;
+
+		//Replaces the event flags and the tag of the added socket. It also rearms a socket added with PollerEventFlag::OneShot.
+		SOCKETDATASHARING_API ErrorIndicator ModifySocketInPoller(PollerHandle pollerHandle,
+			SocketHandle socketHandle, uint32_t eventFlags, uint64_t tag) noexcept;
+
+		SOCKETDATASHARING_API ErrorIndicator RemoveSocketFromPoller(PollerHandle pollerHandle, SocketHandle socketHandle) noexcept;
+
+		//Waits until at least one added socket is ready or the timeout is expired, then fills the array with up to eventCapacity events.
+		//Passing a negative timeout waits infinitely. Passing a zero timeout returns immediately.
+		//If the timeout is expired, eventCount_out is set to zero. Being interrupted by a signal is treated the same way.
+		//The event capacity must be at least 1. Otherwise, Error::InvalidOutputCapacity is signaled.
+		SOCKETDATASHARING_API ErrorIndicator WaitForPollerEvents(PollerHandle pollerHandle, PollerEvent* events_out,
+			int32_t eventCapacity, int32_t timeoutInMilliseconds, int32_t* eventCount_out) noexcept;
+	}
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include "SocketDataSharing.hpp"
+
+#include "IndirectIncludes/SocketDataSharingAPIDefine.hpp"
+
+//A ring buffer for streamed data. Its memory is mapped twice, back to back, so the readable bytes are always contiguous,
+//even if they wrap around the end of the buffer. A partially received message never needs to be moved or copied to be parsed.
+//Receive into the buffer, parse the readable view and consume the parsed bytes. The rest stays readable for the next call.
+//A ring buffer must only be used by one thread at a time. Currently, ring buffers are only implemented on Linux.
+
+namespace SDS
+{
+	extern "C"
+	{
+		using RingBufferHandle = void*;
+
+		//The capacity must be within the inclusive range of 1 to 1073741824 bytes. It's rounded up to a multiple of the page size.
+		//If an error occured, the returned pointer is null.
+		SOCKETDATASHARING_API RingBufferHandle CreateRingBuffer(size_t minCapacity) noexcept;
+		SOCKETDATASHARING_API ErrorIndicator DestroyRingBuffer(RingBufferHandle ringBufferHandle) noexcept;
+
+		//Returns 0 if the handle is invalid.
+		SOCKETDATASHARING_API size_t GetRingBufferCapacity(RingBufferHandle ringBufferHandle) noexcept;
+
+		//This function can only be used with connected TCP sockets. It works like the Receive function with the writable view
+		//as its only segment and makes the received bytes readable. Error::RingBufferIsFull is signaled if there is no free space.
+		SOCKETDATASHARING_API TransferStatus ReceiveIntoRingBuffer(SocketHandle connectedSocketHandle,
+			RingBufferHandle ringBufferHandle, size_t* receivedByteCount_out) noexcept;
+
+		//The view points to all the readable bytes. It stays valid until the bytes are consumed or the buffer is destroyed.
+		SOCKETDATASHARING_API ErrorIndicator GetRingBufferReadableView(RingBufferHandle ringBufferHandle, BufferSegment* view_out) noexcept;
+
+		//Frees the bytes at the start of the readable view. The byte count must not exceed the size of the view.
+		SOCKETDATASHARING_API ErrorIndicator ConsumeRingBuffer(RingBufferHandle ringBufferHandle, size_t byteCount) noexcept;
+
+		//The writable view lets the data be written by other means, e.g. decompressed into the buffer.
+		//The byte count committed afterwards must not exceed the size of the view.
+		SOCKETDATASHARING_API ErrorIndicator GetRingBufferWritableView(RingBufferHandle ringBufferHandle, BufferSegment* view_out) noexcept;
+		SOCKETDATASHARING_API ErrorIndicator CommitRingBuffer(RingBufferHandle ringBufferHandle, size_t byteCount) noexcept;
+	}
+}
\ No newline at end of file
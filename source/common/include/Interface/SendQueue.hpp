@@ -0,0 +1,48 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include "SocketDataSharing.hpp"
+
+#include "IndirectIncludes/SocketDataSharingAPIDefine.hpp"
+
+//A send queue collects the messages of a connected TCP socket in user space and sends them with as few system calls as possible.
+//Enqueue the messages during an iteration of the event loop and flush the queue at its end. Small messages are copied
+//back to back into pooled blocks, so many of them are sent as one segment of one vectored write. It gives the packet count
+//of Nagle's algorithm without its delays, so the queue disables Nagle's algorithm of the socket.
+//A send queue must only be used by one thread at a time. Currently, send queues are only implemented on Linux.
+
+namespace SDS
+{
+	extern "C"
+	{
+		using SendQueueHandle = void*;
+
+		//The high-water mark is the queued byte count above which the queue reports backpressure. It must be positive.
+		//The queue neither owns nor destroys the socket. If an error occured, the returned pointer is null.
+		SOCKETDATASHARING_API SendQueueHandle CreateSendQueue(SocketHandle connectedSocketHandle, size_t highWaterMark) noexcept;
+
+		//The queued bytes which weren't sent are discarded.
+		SOCKETDATASHARING_API ErrorIndicator DestroySendQueue(SendQueueHandle sendQueueHandle) noexcept;
+
+		//The segments are copied as one message, so their memory may be reused right away. The segment count must be within
+		//the inclusive range of 1 to 1024. isAboveHighWaterMark_out is set to Bool::True if the queue is above the high-water mark.
+		//The message is queued anyway, but the caller should stop producing until a flush brings the queue below the mark.
+		//Passing null to isAboveHighWaterMark_out is legal.
+		SOCKETDATASHARING_API ErrorIndicator EnqueueMessage(SendQueueHandle sendQueueHandle, const BufferSegment* segments,
+			int32_t segmentCount, Bool* isAboveHighWaterMark_out) noexcept;
+
+		//Queues the first bytes of a buffer returned by AcquireBuffer without copying them. The queue retains the buffer
+		//and releases it when the bytes are sent, so the same buffer can be queued on many sockets. It must not be changed until then.
+		SOCKETDATASHARING_API ErrorIndicator EnqueuePooledBuffer(SendQueueHandle sendQueueHandle, void* buffer, size_t size,
+			Bool* isAboveHighWaterMark_out) noexcept;
+
+		//Sends the queued bytes with one vectored write per 1024 segments. If more writes are needed, the socket is corked
+		//between them, so no partial packets are sent. TransferStatus::Transferred means that the queue is empty.
+		//TransferStatus::WouldBlock means that some bytes are still queued. Wait for PollerEventFlag::Writable and flush again.
+		//sentByteCount_out is set to the number of bytes sent by this call.
+		SOCKETDATASHARING_API TransferStatus FlushSendQueue(SendQueueHandle sendQueueHandle, size_t* sentByteCount_out) noexcept;
+
+		//Returns the queued byte count. It's 0 if the handle is invalid.
+		SOCKETDATASHARING_API size_t GetSendQueueSize(SendQueueHandle sendQueueHandle) noexcept;
+	}
+}
\ No newline at end of file
@@ -4,7 +4,9 @@
 
 #include "IndirectIncludes/SocketDataSharingAPIDefine.hpp"
 
-//The library is not completely thread safe and uses only non-blocking sockets!
+//The library is thread safe and uses only non-blocking sockets! Functions can be called from many threads at once,
+//except Initialize and Shutdown, which must not be called while other threads are using the library.
+//A socket may be used by many threads, but concurrent transfers on one socket are ordered by the system, not by the library.
 //In order to use the static version of the library you need to define SOCKETDATASHARING_STATIC.
 
 namespace SDS
@@ -31,7 +33,8 @@ namespace SDS
 		//If the host isn't connected to any network the returned IP address count is zero but the data pointer isn't null.
 		//The NetworkIPAddresses array pointer is null only if an error occured and you don't need to deallocate the memory.
 		//The returned IPv6 addresses are in network byte order.
-		//Don't store the pointer and the size because their values may be changed after another GetNetworkIPAddressesArray call.
+		//Don't store the pointer and the size because their values may be changed after another GetNetworkIPAddressesArray call
+		//on the same thread. Every thread has its own array.
 		SOCKETDATASHARING_API NetworkIPAddresses* GetNetworkIPAddressesArray(int32_t* size_out) noexcept;
 
 		//This function accepts any addresses even zero ones.
@@ -65,10 +68,24 @@ namespace SDS
 		SOCKETDATASHARING_API SocketHandle CreateListeningIPv6TCPSocket(IPv6Address ipv6AddressInNetworkBO, 
 			uint16_t* portNumberInHostBO_inout, uint32_t pendingConnectionQueueSize) noexcept;
 
+		//These functions create a group of listening sockets bound to the same socket address. The system distributes
+		//new connections among them, so each socket can be accepted on its own thread without contention.
+		//The arguments mean the same as for a single listening socket. The queue size is applied to each socket.
+		//Passing Bool::True to shouldSteerByCPU makes the system pass a new connection to the socket whose index is the number
+		//of the CPU which received the connection modulo the socket count. Pin the thread which accepts the i-th socket to the i-th CPU
+		//to keep every connection on one core. Otherwise, the sockets are picked by the hash of the connection's socket addresses.
+		//The listening socket handle array must hold listeningSocketCount elements. Destroy each socket separately.
+		//If an error occured, no sockets are created.
+		//Currently, these functions are only implemented on Linux, because Windows doesn't distribute connections among sockets bound to one address.
+		SOCKETDATASHARING_API ErrorIndicator CreateListeningIPv4TCPSocketGroup(IPv4Address ipv4Address, uint16_t* portNumberInHostBO_inout,
+			uint32_t pendingConnectionQueueSize, int32_t listeningSocketCount, Bool shouldSteerByCPU, SocketHandle* listeningSocketHandles_out) noexcept;
+		SOCKETDATASHARING_API ErrorIndicator CreateListeningIPv6TCPSocketGroup(IPv6Address ipv6AddressInNetworkBO, uint16_t* portNumberInHostBO_inout,
+			uint32_t pendingConnectionQueueSize, int32_t listeningSocketCount, Bool shouldSteerByCPU, SocketHandle* listeningSocketHandles_out) noexcept;
+
 		//Passing a zero to portNumberToConnectFromInHostBO will use a random port number within the inclusive range of 49152 to 65535.
 		//It's recommended to do so.
 		//Passing a zero to portNumberToConnectToInHostBO or a zero address to ipv4AddressToConnectTo is illegal.
-		//Usually, the connection can't be established immediately. //TODO: finish the comment
+		//Usually, the connection can't be established immediately. Wait for PollerEventFlag::Writable and call IsTCPSocketConnected.
 		//If an error occured, the returned pointer is null.
 		SOCKETDATASHARING_API SocketHandle CreateConnectedIPv4TCPSocket(uint16_t portNumberToConnectFromInHostBO, 
 			IPv4Address ipv4AddressToConnectTo, uint16_t portNumberToConnectToInHostBO) noexcept;
@@ -76,16 +93,61 @@ namespace SDS
 		//Passing a zero to portNumberToConnectFromInHostBO will use a random port number within the inclusive range of 49152 to 65535.
 		//It's recommended to do so.
 		//Passing a zero to portNumberToConnectToInHostBO or a zero address to ipv6AddressToConnectToInHostBO is illegal.
-		//Usually, the connection can't be established immediately. //TODO: finish the comment
+		//Usually, the connection can't be established immediately. Wait for PollerEventFlag::Writable and call IsTCPSocketConnected.
 		//If an error occured, the returned pointer is null.
 		SOCKETDATASHARING_API SocketHandle CreateConnectedIPv6TCPSocket(uint16_t portNumberToConnectFromInHostBO,
 			IPv6Address ipv6AddressToConnectToInHostBO, uint16_t portNumberToConnectToInHostBO) noexcept;
 
+		//These functions work like the functions without the WithProfile suffix, but they take a profile of socket options.
+		//Its options are set before the socket is bound, listens or connects, so the socket is never used half configured,
+		//e.g. the receive buffer size is known when the TCP window is negotiated. Passing null keeps the system defaults.
+		//On Linux, the set options are remembered, so setting the same value later costs no system call.
+		//On Windows, only the buffer sizes, Nagle's algorithm, the destruction timeout, keepalive and broadcast are set.
+		//The group functions are only implemented on Linux, the same way as the functions without the suffix.
+
+		SOCKETDATASHARING_API SocketHandle CreateIPv4UDPSocketWithProfile(IPv4Address ipv4Address,
+			uint16_t* portNumberInHostBO_inout, const SocketProfile* profile) noexcept;
+		SOCKETDATASHARING_API SocketHandle CreateIPv6UDPSocketWithProfile(IPv6Address ipv6AddressInNetworkBO,
+			uint16_t* portNumberInHostBO_inout, const SocketProfile* profile) noexcept;
+
+		SOCKETDATASHARING_API SocketHandle CreateListeningIPv4TCPSocketWithProfile(IPv4Address ipv4Address,
+			uint16_t* portNumberInHostBO_inout, uint32_t pendingConnectionQueueSize, const SocketProfile* profile) noexcept;
+		SOCKETDATASHARING_API SocketHandle CreateListeningIPv6TCPSocketWithProfile(IPv6Address ipv6AddressInNetworkBO,
+			uint16_t* portNumberInHostBO_inout, uint32_t pendingConnectionQueueSize, const SocketProfile* profile) noexcept;
+
+		SOCKETDATASHARING_API ErrorIndicator CreateListeningIPv4TCPSocketGroupWithProfile(IPv4Address ipv4Address, uint16_t* portNumberInHostBO_inout,
+			uint32_t pendingConnectionQueueSize, int32_t listeningSocketCount, Bool shouldSteerByCPU, SocketHandle* listeningSocketHandles_out,
+			const SocketProfile* profile) noexcept;
+		SOCKETDATASHARING_API ErrorIndicator CreateListeningIPv6TCPSocketGroupWithProfile(IPv6Address ipv6AddressInNetworkBO, uint16_t* portNumberInHostBO_inout,
+			uint32_t pendingConnectionQueueSize, int32_t listeningSocketCount, Bool shouldSteerByCPU, SocketHandle* listeningSocketHandles_out,
+			const SocketProfile* profile) noexcept;
+
+		SOCKETDATASHARING_API SocketHandle CreateConnectedIPv4TCPSocketWithProfile(uint16_t portNumberToConnectFromInHostBO,
+			IPv4Address ipv4AddressToConnectTo, uint16_t portNumberToConnectToInHostBO, const SocketProfile* profile) noexcept;
+		SOCKETDATASHARING_API SocketHandle CreateConnectedIPv6TCPSocketWithProfile(uint16_t portNumberToConnectFromInHostBO,
+			IPv6Address ipv6AddressToConnectToInHostBO, uint16_t portNumberToConnectToInHostBO, const SocketProfile* profile) noexcept;
+
 		//This function can only be used with listening sockets.
 		//Call it to pop the pending connection queue. If the queue is empty, it will set the connectedSocketHandle_out to null.
 		//The connected socket has the same socket address as the listening socket but it also has another host's socket address.
+		//Listening sockets report PollerEventFlag::Readable when the queue isn't empty.
 		SOCKETDATASHARING_API ErrorIndicator AcceptNewConnection(SocketHandle listeningSocketHandle, SocketHandle* connectedSocketHandle_out) noexcept;
 
+		//This function can only be used with listening sockets. It pops up to the capacity of pending connections with one call per connection.
+		//Another host's socket address of each connection is returned in network byte order at the same index of anotherHostIPSocketAddresses_out.
+		//So you don't need to call GetAnotherHostIPSocketAddress. Passing null to anotherHostIPSocketAddresses_out is legal.
+		//If the address of a connection is incompatible, the connection is still accepted, but its address has ErrorIndicator::Error.
+		//If the queue is empty, connectionCount_out is set to zero.
+		//If at least one connection was accepted, no error is returned even if an error occured later.
+		SOCKETDATASHARING_API ErrorIndicator AcceptNewConnections(SocketHandle listeningSocketHandle, SocketHandle* connectedSocketHandles_out,
+			ErrorIPSocketAddress* anotherHostIPSocketAddresses_out, int32_t capacity, int32_t* connectionCount_out) noexcept;
+
+		//This function can only be used with sockets created by the CreateConnected*TCPSocket functions.
+		//It returns ErrorBool::False while the connection is still being established.
+		//If the connection attempt failed, the error is signaled the same way as if the connection had failed immediately.
+		//In that case, the socket must be destroyed.
+		SOCKETDATASHARING_API ErrorBool IsTCPSocketConnected(SocketHandle connectingSocketHandle) noexcept;
+
 		//This function returns socket addresses in network byte order. You should know what IP version the peer is using.
 		//If you don't know, check any address of the returned structure for zero.
 		SOCKETDATASHARING_API ErrorIPSocketAddress GetAnotherHostIPSocketAddress(SocketHandle connectedSocketHandle) noexcept;
@@ -93,6 +155,8 @@ namespace SDS
 		//This function may or may not destroy the socket immediately, if it is a TCP one.
 		//It depends on what you passed to the SetSocketDestructionTimeout function.
 		//The socket handle will become unusable if no error occured.
+		//On Linux, a socket handle is never reused, so passing a destroyed one signals Error::InvalidSocketHandle
+		//instead of affecting a socket created later. Passing a poller handle signals it as well.
 		SOCKETDATASHARING_API ErrorIndicator DestroySocket(SocketHandle socketHandle) noexcept;
 
 		//Nagle's algorithm creates delays to group small packets into one large packet.
@@ -114,5 +178,20 @@ namespace SDS
 		//You can call this function with sockets in any state.
 		//The option is set to Bool::False by default.
 		SOCKETDATASHARING_API ErrorIndicator SetSocketBroadcast(SocketHandle socketHandle, Bool isEnabled) noexcept;
+
+		//Sets the options of the profile on an existing socket, e.g. an accepted one. Zero fields leave their options unchanged.
+		//On Linux, options which are already set to the same values cost no system calls. If an error occured, some options may be already set.
+		SOCKETDATASHARING_API ErrorIndicator ApplySocketProfile(SocketHandle socketHandle, const SocketProfile* profile) noexcept;
+
+		//Currently, the functions below are only implemented on Linux.
+
+		//This function works with connecting and connected TCP sockets. Each call costs one system call.
+		//If an error occured, the info is unchanged.
+		SOCKETDATASHARING_API ErrorIndicator GetTCPConnectionInfo(SocketHandle tcpSocketHandle, TCPConnectionInfo* info_out) noexcept;
+
+		//Fills one info for each handle. Infos of stale handles, non-TCP sockets and failed calls have isValid set to Bool::False.
+		//Such handles don't signal errors, because connections are expected to close between samples.
+		//The returned value is the number of valid infos. It's -1 if an error occured.
+		SOCKETDATASHARING_API int32_t GetTCPConnectionInfos(const SocketHandle* tcpSocketHandles, int32_t socketCount, TCPConnectionInfo* infos_out) noexcept;
 	}
 }
\ No newline at end of file
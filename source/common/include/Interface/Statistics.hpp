@@ -0,0 +1,40 @@
+#pragma once
+#include <cstdint>
+#include "SocketDataSharing.hpp"
+
+#include "IndirectIncludes/SocketDataSharingAPIDefine.hpp"
+
+//The library counts what it does on every socket and for the whole process. Counting is always on and costs close to nothing.
+//Snapshots can be taken from any thread while other threads are transferring data. They aren't atomic as a whole,
+//so counters updated during the snapshot may be a bit ahead of the others. Currently, counters are only implemented on Linux.
+//Connection establishment is measured when the library notices it, so poll connecting sockets promptly to get meaningful values.
+
+namespace SDS
+{
+	extern "C"
+	{
+		//The counters of all sockets, including the destroyed ones, since the process started.
+		SOCKETDATASHARING_API ErrorIndicator GetStatistics(IOStatistics* statistics_out) noexcept;
+
+		//The counters of one socket since it was created. For listening sockets, acceptCount is the number of accepted connections.
+		SOCKETDATASHARING_API ErrorIndicator GetSocketStatistics(SocketHandle socketHandle, IOStatistics* statistics_out) noexcept;
+
+		//Latency histograms are recorded for the whole process. Recording never locks or allocates, so they are always on.
+		//The histogram is the difference between the current values and the values at the last reset.
+		SOCKETDATASHARING_API ErrorIndicator GetLatencyHistogram(LatencyHistogramKind kind, LatencyHistogram* histogram_out) noexcept;
+		SOCKETDATASHARING_API ErrorIndicator ResetLatencyHistogram(LatencyHistogramKind kind) noexcept;
+
+		//Measuring how long a connection waited in the accept queue costs one system call per measured connection,
+		//so LatencyHistogramKind::AcceptQueueDwell isn't recorded by default. Passing N measures every Nth connection
+		//accepted by each thread, passing 1 measures every one and passing 0 turns the measuring off again.
+		//The system tells the dwell in whole milliseconds, so the recorded values are multiples of 1 ms.
+		SOCKETDATASHARING_API void SetAcceptQueueDwellSamplingInterval(uint32_t samplingInterval) noexcept;
+
+		//The returned value is the smallest value in nanoseconds counted in the bucket. Out of range indices return UINT64_MAX.
+		SOCKETDATASHARING_API uint64_t GetLatencyHistogramBucketLowerBound(int32_t bucketIndex) noexcept;
+
+		//The percentile must be within the inclusive range of 0 to 100. The returned value is the upper bound
+		//of the bucket which contains the percentile, so it's never less than the real one. It's 0 for empty histograms.
+		SOCKETDATASHARING_API uint64_t GetLatencyHistogramPercentile(const LatencyHistogram* histogram, double percentile) noexcept;
+	}
+}
\ No newline at end of file
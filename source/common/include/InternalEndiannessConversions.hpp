@@ -10,6 +10,8 @@ inline uint64_t HostToNetworkBO(uint64_t value) noexcept
 
 #elif defined(_WIN64)
 	return htonll(value);
+#elif defined(__linux__)
+	return htobe64(value);
 #endif
 }
 
@@ -25,6 +27,8 @@ inline uint32_t HostToNetworkBO(uint32_t value) noexcept
 
 #elif defined(_WIN64)
 	return htonl(value);
+#elif defined(__linux__)
+	return htonl(value);
 #endif
 }
 
@@ -40,6 +44,8 @@ inline uint16_t HostToNetworkBO(uint16_t value) noexcept
 
 #elif defined(_WIN64)
 	return htons(value);
+#elif defined(__linux__)
+	return htons(value);
 #endif
 }
 
@@ -55,6 +61,8 @@ inline uint64_t NetworkToHostBO(uint64_t value) noexcept
 
 #elif defined(_WIN64)
 	return ntohll(value);
+#elif defined(__linux__)
+	return be64toh(value);
 #endif
 }
 
@@ -70,6 +78,8 @@ inline uint32_t NetworkToHostBO(uint32_t value) noexcept
 
 #elif defined(_WIN64)
 	return ntohl(value);
+#elif defined(__linux__)
+	return ntohl(value);
 #endif
 }
 
@@ -85,6 +95,8 @@ inline uint16_t NetworkToHostBO(uint16_t value) noexcept
 
 #elif defined(_WIN64)
 	return ntohs(value);
+#elif defined(__linux__)
+	return ntohs(value);
 #endif
 }
 
@@ -1,6 +1,13 @@
 #pragma once
+#include <atomic>
+#include <mutex>
 
 namespace State
 {
-	extern bool isInitialized;
+	//It's read with acquire semantics, so everything done by the Initialize function is visible to the thread which saw the value.
+	extern std::atomic<bool> isInitialized;
+
+	//Serializes the Initialize and Shutdown functions, so the library is never seen half initialized.
+	//Other functions never lock it.
+	extern std::mutex initializationMutex;
 }
\ No newline at end of file
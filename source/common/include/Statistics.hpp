@@ -0,0 +1,81 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <atomic>
+#include <chrono>
+#include "Error.hpp"
+
+//Counters are always on, so incrementing them must cost close to nothing.
+//Global counters are kept in per-thread shards, which are only written by their own threads, so no increment is a locked instruction.
+//The shards are preallocated. If more threads count at once than there are shards, the extra threads share one atomically incremented shard.
+//Per-socket counters are incremented atomically, because a socket may be used by many threads.
+namespace Statistics
+{
+	enum class Counter : uint8_t
+	{
+		SentByteCount,
+		SendCallCount,
+		ReceivedByteCount,
+		ReceiveCallCount,
+		WouldBlockCount,
+		AcceptCount,
+		ConnectCount,
+
+		Count,
+	};
+
+	static constexpr auto errorValueCount = (size_t)64; //Greater error values are counted as the last one.
+
+	enum class Histogram : uint8_t
+	{
+		ConnectionEstablishment,
+		AcceptQueueDwell,
+		SendCall,
+
+		Count,
+	};
+
+	//Every power of two is split into 16 buckets. Values of 2^40 nanoseconds or greater are counted in the last bucket.
+	static constexpr auto subBucketBitCount = 4;
+	static constexpr auto subBucketCount = (uint64_t)1 << subBucketBitCount;
+	static constexpr auto maxValueBitCount = 40;
+	static constexpr auto histogramBucketCount = (size_t)((maxValueBitCount - subBucketBitCount + 1) * subBucketCount);
+
+	struct ErrorCounts final
+	{
+		std::atomic<uint64_t> values[errorValueCount];
+	};
+
+	struct SocketCounters final
+	{
+		std::atomic<uint64_t> values[(size_t)Counter::Count];
+
+		//Kept with the other counters, so counting an error never allocates. They are allocated with the socket's slot.
+		ErrorCounts errorCounts;
+
+		//Must be called before the socket is used.
+		void Reset() noexcept;
+	};
+
+	//Adds the value to the calling thread's shard and, if the socket counters aren't null, to the socket counters.
+	void Count(SocketCounters* socketCounters, Counter counter, uint64_t value = (uint64_t)1) noexcept;
+
+	//Adds the value to the calling thread's shard. It neither locks nor allocates.
+	void Record(Histogram histogram, uint64_t valueInNanoseconds) noexcept;
+
+	//Measuring the accept queue dwell costs a system call, so only every Nth accepted connection of a thread is measured.
+	//The returned value is true if the calling thread's current connection must be measured. It's always false by default.
+	bool ShouldSampleAcceptQueueDwell() noexcept;
+
+	//Monotonic time for the histograms. It costs no system call.
+	inline uint64_t GetTimestamp() noexcept
+	{
+		return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	//It's called by the ErrorHandler for every reported error. The socket handle may be null or stale.
+	void CountError(SDS::Error error, const void* socketHandle) noexcept;
+
+	//Defined by the platform. The returned pointer is null if the handle is stale or invalid or the platform has no socket counters.
+	SocketCounters* FindSocketCounters(const void* socketHandle) noexcept;
+}
\ No newline at end of file
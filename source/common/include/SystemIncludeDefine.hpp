@@ -2,6 +2,8 @@
 	//TODO: include Android API
 #elif defined _WIN64
 	#include "WinAPI.hpp"
+#elif defined __linux__
+	#include "LinuxAPI.hpp"
 #else
 	#error "This platform is not supported"
 #endif
\ No newline at end of file
@@ -1,7 +1,7 @@
 #pragma once
 #include <cstddef>
 
-//Dynamic array of bytes.
+//Dynamic array of bytes. The memory comes from the buffer pool, so resizing within the capacity doesn't allocate.
 class Buffer final
 {
 public:
@@ -13,10 +13,11 @@ public:
 	Buffer(Buffer&& anotherBuffer) noexcept;
 	~Buffer() noexcept { Destruct(); }
 
-	//Passing zero will deallocate the memory.
+	//Passing zero will return the memory to the pool. The data is kept if the new size fits the capacity, otherwise it's lost.
 	void Resize(size_t newSize);
 
 	size_t GetSize() const noexcept { return m_bufferSize; }
+	size_t GetCapacity() const noexcept { return m_bufferCapacity; }
 
 	void* GetData() noexcept { return m_buffer; }
 	void* GetData() const noexcept { return m_buffer; }
@@ -26,7 +27,9 @@ public:
 
 private:
 	size_t m_bufferSize = (size_t)0;
+	size_t m_bufferCapacity = (size_t)0;
 	std::byte* m_buffer = nullptr;
 
+	void Allocate();
 	void Destruct() noexcept;
 };
\ No newline at end of file
@@ -0,0 +1,45 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+
+//Size-classed pool of I/O buffers. Blocks are carved from slabs which are never returned to the system,
+//so a buffer pointer stays valid memory for the whole process, and the steady state allocates nothing.
+//Every thread keeps a small cache of free blocks per size class, so most acquisitions and releases don't lock.
+//Every block is preceded by a header with a reference count, so one buffer can be shared by many sockets.
+//Slabs are kept per NUMA node and every thread takes its blocks from the slabs of its node, so the memory is local to the thread.
+namespace BufferPool
+{
+	static constexpr auto sizeClassCount = (size_t)13;
+	static constexpr auto minBlockSize = (size_t)256;
+	static constexpr auto maxBlockSize = minBlockSize << (sizeClassCount - (size_t)1); //1 MiB.
+	static constexpr auto slabSize = (size_t)2 * (size_t)1024 * (size_t)1024;
+	static constexpr auto blockAlignment = (size_t)64;
+	static constexpr auto maxNUMANodeCount = 8; //Memory for greater nodes isn't bound, so the system places it.
+
+	//Sizes greater than the max block size are allocated separately. The capacity is never less than the size.
+	//The returned buffer is referenced once. Returns null if the memory can't be allocated.
+	void* Acquire(size_t size, size_t& capacity_out) noexcept;
+
+	//The buffer must have been returned by Acquire and still be referenced.
+	void Retain(void* buffer) noexcept;
+
+	//The buffer is returned to the pool when the last reference is released.
+	void Release(void* buffer) noexcept;
+
+	size_t GetCapacity(const void* buffer) noexcept;
+
+	//Checks that the pointer is in the pool and looks like a referenced buffer. It's meant for the public API, so invalid pointers can be reported.
+	//Only memory of the pool is read, so any pointer can be checked.
+	bool IsBuffer(const void* buffer) noexcept;
+
+	//Negative nodes mean the node the thread runs on. The cached blocks of the previous node are returned to it.
+	void SetThreadNUMANode(int32_t numaNode) noexcept;
+
+	//Defined by the platform. The size is a multiple of the slab size and the region must be aligned to it. Regions are backed by huge pages when it's possible,
+	//and their memory is bound to the node unless it's negative. Returns null if the memory can't be allocated.
+	std::byte* AllocateRegion(size_t size, int32_t numaNode, bool& isHugePageBacked_out) noexcept;
+	void FreeRegion(std::byte* region, size_t size) noexcept;
+
+	//Defined by the platform. Returns -1 if the node can't be determined.
+	int32_t GetCurrentNUMANode() noexcept;
+}
\ No newline at end of file
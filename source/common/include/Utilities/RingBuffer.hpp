@@ -0,0 +1,48 @@
+#pragma once
+#include <cstddef>
+
+//Circular buffer of bytes. Its memory is mapped twice, back to back, so the readable and the writable regions are always contiguous,
+//even if they wrap around the end of the buffer. The readable region starts at the read offset and the writable one follows it.
+class RingBuffer final
+{
+public:
+	RingBuffer() noexcept = default;
+	RingBuffer(const RingBuffer&) = delete;
+	RingBuffer(RingBuffer&& anotherRingBuffer) noexcept;
+	~RingBuffer() noexcept { Destruct(); }
+
+	//The capacity is rounded up to the mapping granularity of the system. The previous memory is unmapped.
+	//The returned bool value is set to false if the memory can't be mapped. In that case, the error is already signaled.
+	bool Allocate(size_t minCapacity) noexcept;
+
+	size_t GetCapacity() const noexcept { return m_capacity; }
+	size_t GetReadableSize() const noexcept { return m_readableSize; }
+	size_t GetWritableSize() const noexcept { return m_capacity - m_readableSize; }
+
+	std::byte* GetReadableData() const noexcept { return m_data + m_readOffset; }
+	std::byte* GetWritableData() const noexcept { return m_data + m_readOffset + m_readableSize; }
+
+	//Makes the written bytes readable. The byte count must not exceed the writable size.
+	void Commit(size_t byteCount) noexcept { m_readableSize += byteCount; }
+
+	//Frees the read bytes. The byte count must not exceed the readable size.
+	void Consume(size_t byteCount) noexcept;
+
+	RingBuffer& operator=(const RingBuffer&) = delete;
+	RingBuffer& operator=(RingBuffer&& anotherRingBuffer) noexcept;
+
+	//Defined by the platform.
+	static size_t GetMappingGranularity() noexcept;
+
+private:
+	std::byte* m_data = nullptr;
+	size_t m_capacity = (size_t)0;
+	size_t m_readOffset = (size_t)0;
+	size_t m_readableSize = (size_t)0;
+
+	void Destruct() noexcept;
+
+	//Defined by the platform. The returned mapping is twice as large as the capacity. It's null if an error occured.
+	static std::byte* MapMirrored(size_t capacity) noexcept;
+	static void Unmap(std::byte* data, size_t capacity) noexcept;
+};
\ No newline at end of file
@@ -0,0 +1,105 @@
+#include "Contexts.hpp"
+#include "ErrorHandler.hpp"
+#include <atomic>
+#include <mutex>
+
+namespace Contexts
+{
+	//A generation is odd while its context is alive. The default context is always alive.
+	static std::atomic<uint32_t> generations[maxContextCount]{ 1 };
+	static std::mutex contextsMutex; //Creating and destroying contexts are rare, so they are allowed to lock.
+
+	struct ThreadBinding final
+	{
+		uint32_t contextIndex = defaultContextIndex;
+		uint32_t generation = 1;
+	};
+
+	static thread_local ThreadBinding threadBinding;
+
+	void* Create() noexcept
+	{
+		const std::lock_guard lock(contextsMutex);
+		for (auto contextIndex = defaultContextIndex + (uint32_t)1; contextIndex < maxContextCount; ++contextIndex)
+		{
+			const uint32_t generation = generations[contextIndex].load(std::memory_order_relaxed);
+			if ((generation & (uint32_t)1) == (uint32_t)0)
+			{
+				ErrorHandler::ResetCallback(contextIndex);
+				ErrorHandler::ResetEventQueue(contextIndex);
+				generations[contextIndex].store(generation + (uint32_t)1, std::memory_order_release);
+				return reinterpret_cast<void*>(((uint64_t)(generation + (uint32_t)1) << 32) | ((uint64_t)contextIndex + (uint64_t)1));
+			}
+		}
+
+		return nullptr;
+	}
+
+	int32_t Destroy(const void* contextHandle) noexcept
+	{
+		const int32_t contextIndex = ToIndex(contextHandle);
+		if (contextIndex == (int32_t)-1 || (uint32_t)contextIndex == defaultContextIndex)
+			return (int32_t)-1;
+
+		const std::lock_guard lock(contextsMutex);
+		auto generation = (uint32_t)(reinterpret_cast<uint64_t>(contextHandle) >> 32);
+		if (!generations[contextIndex].compare_exchange_strong(generation, generation + (uint32_t)1, std::memory_order_acq_rel))
+			return (int32_t)-1;
+
+		return contextIndex;
+	}
+
+	void DestroyAll() noexcept
+	{
+		const std::lock_guard lock(contextsMutex);
+		for (auto contextIndex = defaultContextIndex + (uint32_t)1; contextIndex < maxContextCount; ++contextIndex)
+		{
+			const uint32_t generation = generations[contextIndex].load(std::memory_order_relaxed);
+			if ((generation & (uint32_t)1) != (uint32_t)0)
+				generations[contextIndex].store(generation + (uint32_t)1, std::memory_order_release);
+		}
+	}
+
+	int32_t ToIndex(const void* contextHandle) noexcept
+	{
+		if (contextHandle == nullptr)
+			return (int32_t)defaultContextIndex;
+
+		const auto contextNumber = (uint32_t)(reinterpret_cast<uint64_t>(contextHandle) & (uint64_t)UINT32_MAX);
+		if (contextNumber == (uint32_t)0 || contextNumber > maxContextCount)
+			return (int32_t)-1;
+
+		const auto generation = (uint32_t)(reinterpret_cast<uint64_t>(contextHandle) >> 32);
+		if ((generation & (uint32_t)1) == (uint32_t)0 ||
+			generations[contextNumber - (uint32_t)1].load(std::memory_order_acquire) != generation)
+			return (int32_t)-1;
+
+		return (int32_t)(contextNumber - (uint32_t)1);
+	}
+
+	uint32_t GetCurrentIndex() noexcept
+	{
+		if (generations[threadBinding.contextIndex].load(std::memory_order_relaxed) != threadBinding.generation)
+			return defaultContextIndex;
+
+		return threadBinding.contextIndex;
+	}
+
+	void BindCurrentThread(uint32_t contextIndex) noexcept
+	{
+		threadBinding.contextIndex = contextIndex;
+		threadBinding.generation = generations[contextIndex].load(std::memory_order_relaxed);
+	}
+
+	Scope::Scope(uint32_t contextIndex) noexcept :
+		m_previousContextIndex(threadBinding.contextIndex), m_previousGeneration(threadBinding.generation)
+	{
+		BindCurrentThread(contextIndex);
+	}
+
+	Scope::~Scope() noexcept
+	{
+		threadBinding.contextIndex = m_previousContextIndex;
+		threadBinding.generation = m_previousGeneration;
+	}
+}
\ No newline at end of file
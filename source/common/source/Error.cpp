@@ -4,4 +4,51 @@
 void SDS::SetErrorOccuredCallback(ErrorOccuredCallback callback, void* callbackContext)
 {
 	ErrorHandler::SetCallback(callback, callbackContext);
+}
+
+SDS::Error SDS::GetThreadLastError(int64_t* correspondingSystemError_out) noexcept
+{
+	int64_t correspondingSystemError;
+	const Error error = ErrorHandler::GetThreadLastError(correspondingSystemError);
+	if (correspondingSystemError_out != nullptr)
+		*correspondingSystemError_out = correspondingSystemError;
+
+	return error;
+}
+
+void SDS::ClearThreadLastError() noexcept
+{
+	ErrorHandler::ClearThreadLastError();
+}
+
+void SDS::SetThreadErrorCallbackSuppression(Bool isSuppressed) noexcept
+{
+	ErrorHandler::SetThreadCallbackSuppression(isSuppressed != Bool::False);
+}
+
+SDS::ErrorIndicator SDS::EnableErrorEventQueue(int32_t capacity) noexcept
+{
+	return ErrorHandler::EnableEventQueue(capacity, Contexts::GetCurrentIndex()) ? (ErrorIndicator)1 : ErrorIndicator::Error;
+}
+
+void SDS::DisableErrorEventQueue() noexcept
+{
+	ErrorHandler::DisableEventQueue(Contexts::GetCurrentIndex());
+}
+
+SDS::ErrorIndicator SDS::PopErrorEvents(ErrorEvent* events_out, int32_t eventCapacity, int32_t* eventCount_out) noexcept
+{
+	if (events_out == nullptr || eventCount_out == nullptr)
+	{
+		ErrorHandler::SignalError(Error::PassedPointerIsNull);
+		return ErrorIndicator::Error;
+	}
+
+	*eventCount_out = ErrorHandler::PopEvents(events_out, eventCapacity, Contexts::GetCurrentIndex());
+	return (ErrorIndicator)1;
+}
+
+uint64_t SDS::GetDroppedErrorEventCount() noexcept
+{
+	return ErrorHandler::GetDroppedEventCount(Contexts::GetCurrentIndex());
 }
\ No newline at end of file
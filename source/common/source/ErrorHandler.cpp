@@ -1,37 +1,262 @@
 #include "ErrorHandler.hpp"
+#include "Statistics.hpp"
 #include <cstddef>
 #include <stdexcept>
 #include <cassert>
+#include <chrono>
+#include <mutex>
+#include <new>
 
 using namespace SDS;
 
+struct ThreadErrorState final
+{
+    Error lastError = Error::Success;
+    int64_t lastCorrespondingSystemError = 0;
+    bool isCallbackSuppressed = false;
+};
+
+static thread_local ThreadErrorState threadErrorState;
+
+//A bounded multi-producer multi-consumer ring. Every cell has a sequence number which tells whether the cell is ready
+//to be pushed to or popped from at the current position, so producers and consumers only contend on their own position.
+struct ErrorEventQueue final
+{
+    struct Cell final
+    {
+        std::atomic<uint64_t> sequence;
+        ErrorEvent event;
+    };
+
+    static constexpr auto maxCapacity = (int32_t)1048576;
+
+    uint64_t mask;
+    Cell* cells;
+
+    alignas(64) std::atomic<uint64_t> pushPosition{ 0 };
+    alignas(64) std::atomic<uint64_t> popPosition{ 0 };
+    alignas(64) std::atomic<uint64_t> droppedEventCount{ 0 };
+
+    //The returned bool value is set to false if the queue is full.
+    bool Push(const ErrorEvent& event) noexcept
+    {
+        auto position = pushPosition.load(std::memory_order_relaxed);
+        while (true)
+        {
+            auto& cell = cells[position & mask];
+            const auto difference = (int64_t)(cell.sequence.load(std::memory_order_acquire) - position);
+            if (difference == (int64_t)0)
+            {
+                if (pushPosition.compare_exchange_weak(position, position + (uint64_t)1, std::memory_order_relaxed))
+                {
+                    cell.event = event;
+                    cell.sequence.store(position + (uint64_t)1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (difference < (int64_t)0)
+            {
+                return false;
+            }
+            else
+            {
+                position = pushPosition.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    //The returned bool value is set to false if the queue is empty.
+    bool Pop(ErrorEvent& event_out) noexcept
+    {
+        auto position = popPosition.load(std::memory_order_relaxed);
+        while (true)
+        {
+            auto& cell = cells[position & mask];
+            const auto difference = (int64_t)(cell.sequence.load(std::memory_order_acquire) - (position + (uint64_t)1));
+            if (difference == (int64_t)0)
+            {
+                if (popPosition.compare_exchange_weak(position, position + (uint64_t)1, std::memory_order_relaxed))
+                {
+                    event_out = cell.event;
+                    cell.sequence.store(position + mask + (uint64_t)1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (difference < (int64_t)0)
+            {
+                return false;
+            }
+            else
+            {
+                position = popPosition.load(std::memory_order_relaxed);
+            }
+        }
+    }
+};
+
+//Every context has its own queue, which sits next to its callback binding. The queues are never freed,
+//because another thread may still be pushing to them. A context which reuses the index of a destroyed one reuses its queue.
+static std::atomic<ErrorEventQueue*> errorEventQueues[Contexts::maxContextCount]{};
+static std::atomic<bool> isErrorEventQueueEnabled[Contexts::maxContextCount]{};
+static std::mutex errorEventQueueMutex;
+
 void DoNothingWhenErrorOccured(Error, int64_t, void*) {};
-ErrorOccuredCallback ErrorHandler::m_callback = DoNothingWhenErrorOccured;
+
+const ErrorHandler::CallbackBinding ErrorHandler::m_defaultCallbackBinding{ DoNothingWhenErrorOccured, nullptr };
+std::atomic<const ErrorHandler::CallbackBinding*> ErrorHandler::m_callbackBindings[Contexts::maxContextCount]{ &m_defaultCallbackBinding };
 
 void ErrorHandler::SignalError(Error error) noexcept
 {
     assert(error != Error::Success && error != Error::UnexpectedSystemError);
-    m_callback(error, (int64_t)0, m_callbackContext);
+    ReportError(error, (int64_t)0);
 }
 
-void ErrorHandler::SetCallback(ErrorOccuredCallback callback, void* callbackContext)
+void ErrorHandler::SetCallback(ErrorOccuredCallback callback, void* callbackContext, uint32_t contextIndex)
 {
     if (callback != nullptr)
     {
         try
         {
             callback(Error::Success, (int64_t)0, callbackContext);
-
-            m_callback = callback;
-            m_callbackContext = callbackContext;
-
-            return;
         }
         catch (...)
         {
-
+            throw std::logic_error("Invalid ErrorOccuredCallback!");
         }
+
+        //Callbacks are rarely replaced, so the leaked bindings cost nothing noticeable.
+        m_callbackBindings[contextIndex].store(new CallbackBinding{ callback, callbackContext }, std::memory_order_release);
+
+        return;
     }
 
     throw std::logic_error("Invalid ErrorOccuredCallback!");
+}
+
+void ErrorHandler::ResetCallback(uint32_t contextIndex) noexcept
+{
+    if (contextIndex != Contexts::defaultContextIndex)
+        m_callbackBindings[contextIndex].store(nullptr, std::memory_order_release);
+}
+
+Error ErrorHandler::GetThreadLastError(int64_t& correspondingSystemError_out) noexcept
+{
+    correspondingSystemError_out = threadErrorState.lastCorrespondingSystemError;
+    return threadErrorState.lastError;
+}
+
+void ErrorHandler::ClearThreadLastError() noexcept
+{
+    threadErrorState.lastError = Error::Success;
+    threadErrorState.lastCorrespondingSystemError = (int64_t)0;
+}
+
+void ErrorHandler::SetThreadCallbackSuppression(bool isSuppressed) noexcept
+{
+    threadErrorState.isCallbackSuppressed = isSuppressed;
+}
+
+bool ErrorHandler::EnableEventQueue(int32_t capacity, uint32_t contextIndex) noexcept
+{
+    if (capacity < (int32_t)1 || capacity > ErrorEventQueue::maxCapacity)
+    {
+        SignalError(Error::InvalidErrorEventQueueCapacity);
+        return false;
+    }
+
+    const std::lock_guard lock(errorEventQueueMutex);
+    if (errorEventQueues[contextIndex].load(std::memory_order_relaxed) == nullptr)
+    {
+        auto cellCount = (uint64_t)1;
+        while (cellCount < (uint64_t)capacity)
+            cellCount <<= 1;
+
+        auto* const queue = new (std::nothrow) ErrorEventQueue;
+        auto* const cells = new (std::nothrow) ErrorEventQueue::Cell[cellCount];
+        if (queue == nullptr || cells == nullptr)
+        {
+            delete queue;
+            delete[] cells;
+            SignalError(Error::NotEnoughMemory);
+            return false;
+        }
+
+        for (auto i = (uint64_t)0; i < cellCount; ++i)
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+
+        queue->mask = cellCount - (uint64_t)1;
+        queue->cells = cells;
+        errorEventQueues[contextIndex].store(queue, std::memory_order_release);
+    }
+
+    isErrorEventQueueEnabled[contextIndex].store(true, std::memory_order_release);
+    return true;
+}
+
+void ErrorHandler::DisableEventQueue(uint32_t contextIndex) noexcept
+{
+    isErrorEventQueueEnabled[contextIndex].store(false, std::memory_order_release);
+}
+
+void ErrorHandler::ResetEventQueue(uint32_t contextIndex) noexcept
+{
+    DisableEventQueue(contextIndex);
+    auto* const queue = errorEventQueues[contextIndex].load(std::memory_order_acquire);
+    if (queue == nullptr)
+        return;
+
+    ErrorEvent event;
+    while (queue->Pop(event));
+    queue->droppedEventCount.store((uint64_t)0, std::memory_order_relaxed);
+}
+
+int32_t ErrorHandler::PopEvents(ErrorEvent* events_out, int32_t eventCapacity, uint32_t contextIndex) noexcept
+{
+    auto* const queue = errorEventQueues[contextIndex].load(std::memory_order_acquire);
+    if (queue == nullptr)
+        return (int32_t)0;
+
+    auto eventCount = (int32_t)0;
+    while (eventCount < eventCapacity && queue->Pop(events_out[eventCount]))
+        ++eventCount;
+
+    return eventCount;
+}
+
+uint64_t ErrorHandler::GetDroppedEventCount(uint32_t contextIndex) noexcept
+{
+    auto* const queue = errorEventQueues[contextIndex].load(std::memory_order_acquire);
+    return queue != nullptr ? queue->droppedEventCount.load(std::memory_order_relaxed) : (uint64_t)0;
+}
+
+void ErrorHandler::ReportError(Error error, int64_t correspondingSystemError) noexcept
+{
+    threadErrorState.lastError = error;
+    threadErrorState.lastCorrespondingSystemError = correspondingSystemError;
+    Statistics::CountError(error, m_currentSocketHandle);
+    if (threadErrorState.isCallbackSuppressed)
+        return;
+
+    const uint32_t contextIndex = Contexts::GetCurrentIndex();
+    if (isErrorEventQueueEnabled[contextIndex].load(std::memory_order_acquire))
+    {
+        ErrorEvent event{};
+        event.error = error;
+        event.correspondingSystemError = correspondingSystemError;
+        event.socketHandle = const_cast<void*>(m_currentSocketHandle);
+        event.timestampInNanoseconds = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+
+        auto* const queue = errorEventQueues[contextIndex].load(std::memory_order_relaxed); //It's published before the queue is enabled.
+        if (!queue->Push(event))
+            queue->droppedEventCount.fetch_add((uint64_t)1, std::memory_order_relaxed);
+
+        return;
+    }
+
+    const auto* callbackBinding = m_callbackBindings[contextIndex].load(std::memory_order_acquire);
+    if (callbackBinding == nullptr)
+        callbackBinding = m_callbackBindings[Contexts::defaultContextIndex].load(std::memory_order_acquire);
+
+    callbackBinding->callback(error, correspondingSystemError, callbackBinding->callbackContext);
 }
\ No newline at end of file
@@ -2,5 +2,6 @@
 
 namespace State
 {
-	bool isInitialized = false;
+	std::atomic<bool> isInitialized = false;
+	std::mutex initializationMutex;
 }
\ No newline at end of file
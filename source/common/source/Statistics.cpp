@@ -0,0 +1,328 @@
+#include "Statistics.hpp"
+#include "Interface/Statistics.hpp"
+#include "ErrorHandler.hpp"
+#include <mutex>
+
+namespace Statistics
+{
+	struct ThreadShard final
+	{
+		std::atomic<uint64_t> values[(size_t)Counter::Count]{};
+		std::atomic<uint64_t> errorCounts[errorValueCount]{};
+		std::atomic<uint64_t> histogramBucketCounts[(size_t)Histogram::Count][histogramBucketCount]{};
+		std::atomic<uint64_t> histogramSums[(size_t)Histogram::Count]{};
+		std::atomic<bool> isClaimed{ false };
+		const bool isShared;
+
+		constexpr explicit ThreadShard(bool isShared = false) noexcept :
+			isShared(isShared)
+		{
+
+		}
+
+		//Only the owning thread writes its shard, so a plain load and store is enough. The shared shard is written by many threads.
+		void Add(std::atomic<uint64_t>& value, uint64_t addend) noexcept
+		{
+			if (isShared)
+				value.fetch_add(addend, std::memory_order_relaxed);
+			else
+				value.store(value.load(std::memory_order_relaxed) + addend, std::memory_order_relaxed);
+		}
+	};
+
+	//Claims a shard when the thread first counts and releases it when the thread exits.
+	struct ThreadShardBinding final
+	{
+		ThreadShard* shard;
+
+		ThreadShardBinding() noexcept;
+		~ThreadShardBinding() noexcept;
+	};
+
+	//The shards are preallocated, so claiming one neither locks nor allocates. A released shard keeps its values and
+	//the next thread which claims it keeps adding to them, so the global counters never go down.
+	//Threads which find no free shard use the shared one.
+	static constexpr auto maxThreadShardCount = (size_t)256;
+	static ThreadShard threadShards[maxThreadShardCount];
+	static ThreadShard sharedShard(true);
+	static std::atomic<size_t> nextThreadShardIndex = 0;
+
+	//Histograms can't be zeroed while their threads write them, so a reset remembers the current values and they are subtracted.
+	static std::mutex histogramBaselinesMutex;
+	static uint64_t histogramBaselineBucketCounts[(size_t)Histogram::Count][histogramBucketCount];
+	static uint64_t histogramBaselineSums[(size_t)Histogram::Count];
+
+	static thread_local ThreadShardBinding threadShardBinding;
+
+	//Zero means that the accept queue dwell isn't recorded. The counter is per thread, so sampling never contends.
+	static std::atomic<uint32_t> acceptQueueDwellSamplingInterval = 0;
+	static thread_local uint32_t acceptCountSinceDwellSample = 0;
+
+	inline static void _AddTo(SDS::IOStatistics& statistics_inout, const std::atomic<uint64_t>* values, const std::atomic<uint64_t>* errorCounts) noexcept;
+	inline static size_t _ToBucketIndex(uint64_t value) noexcept;
+	inline static void _SumHistogram(Histogram histogram, uint64_t* bucketCounts_out, uint64_t& sum_out) noexcept;
+
+	void SocketCounters::Reset() noexcept
+	{
+		for (auto& value : values)
+			value.store((uint64_t)0, std::memory_order_relaxed);
+
+		for (auto& errorCount : errorCounts.values)
+			errorCount.store((uint64_t)0, std::memory_order_relaxed);
+	}
+
+	void Count(SocketCounters* socketCounters, Counter counter, uint64_t value) noexcept
+	{
+		auto& threadShard = *threadShardBinding.shard;
+		threadShard.Add(threadShard.values[(size_t)counter], value);
+		if (socketCounters != nullptr)
+			socketCounters->values[(size_t)counter].fetch_add(value, std::memory_order_relaxed);
+	}
+
+	void CountError(SDS::Error error, const void* socketHandle) noexcept
+	{
+		const auto errorIndex = (size_t)error < errorValueCount ? (size_t)error : errorValueCount - (size_t)1;
+		auto& threadShard = *threadShardBinding.shard;
+		threadShard.Add(threadShard.errorCounts[errorIndex], (uint64_t)1);
+
+		auto* const socketCounters = socketHandle != nullptr ? FindSocketCounters(socketHandle) : nullptr;
+		if (socketCounters != nullptr)
+			socketCounters->errorCounts.values[errorIndex].fetch_add((uint64_t)1, std::memory_order_relaxed);
+	}
+
+	void Record(Histogram histogram, uint64_t valueInNanoseconds) noexcept
+	{
+		auto& threadShard = *threadShardBinding.shard;
+		threadShard.Add(threadShard.histogramBucketCounts[(size_t)histogram][_ToBucketIndex(valueInNanoseconds)], (uint64_t)1);
+		threadShard.Add(threadShard.histogramSums[(size_t)histogram], valueInNanoseconds);
+	}
+
+	bool ShouldSampleAcceptQueueDwell() noexcept
+	{
+		const uint32_t samplingInterval = acceptQueueDwellSamplingInterval.load(std::memory_order_relaxed);
+		if (samplingInterval == (uint32_t)0 || ++acceptCountSinceDwellSample < samplingInterval)
+			return false;
+
+		acceptCountSinceDwellSample = 0;
+		return true;
+	}
+
+	ThreadShardBinding::ThreadShardBinding() noexcept :
+		shard(&sharedShard)
+	{
+		const size_t firstIndex = nextThreadShardIndex.fetch_add((size_t)1, std::memory_order_relaxed);
+		for (auto i = (size_t)0; i < maxThreadShardCount; ++i)
+		{
+			auto& threadShard = threadShards[(firstIndex + i) % maxThreadShardCount];
+			auto isClaimed = false;
+			if (threadShard.isClaimed.compare_exchange_strong(isClaimed, true, std::memory_order_acquire, std::memory_order_relaxed))
+			{
+				shard = &threadShard;
+				return;
+			}
+		}
+	}
+
+	ThreadShardBinding::~ThreadShardBinding() noexcept
+	{
+		if (shard != &sharedShard)
+			shard->isClaimed.store(false, std::memory_order_release);
+	}
+
+	inline void _AddTo(SDS::IOStatistics& statistics_inout, const std::atomic<uint64_t>* values, const std::atomic<uint64_t>* errorCounts) noexcept
+	{
+		statistics_inout.sentByteCount += values[(size_t)Counter::SentByteCount].load(std::memory_order_relaxed);
+		statistics_inout.sendCallCount += values[(size_t)Counter::SendCallCount].load(std::memory_order_relaxed);
+		statistics_inout.receivedByteCount += values[(size_t)Counter::ReceivedByteCount].load(std::memory_order_relaxed);
+		statistics_inout.receiveCallCount += values[(size_t)Counter::ReceiveCallCount].load(std::memory_order_relaxed);
+		statistics_inout.wouldBlockCount += values[(size_t)Counter::WouldBlockCount].load(std::memory_order_relaxed);
+		statistics_inout.acceptCount += values[(size_t)Counter::AcceptCount].load(std::memory_order_relaxed);
+		statistics_inout.connectCount += values[(size_t)Counter::ConnectCount].load(std::memory_order_relaxed);
+
+		for (auto i = (size_t)0; i < errorValueCount; ++i)
+			statistics_inout.errorCounts[i] += errorCounts[i].load(std::memory_order_relaxed);
+	}
+
+	//Values below 16 have their own buckets. Greater values are split by their highest bit and the 4 bits below it.
+	inline size_t _ToBucketIndex(uint64_t value) noexcept
+	{
+		if (value < subBucketCount)
+			return (size_t)value;
+
+		auto highestBitIndex = 0;
+		for (auto shift = 32; shift != 0; shift /= 2)
+		{
+			if ((value >> (highestBitIndex + shift)) != (uint64_t)0)
+				highestBitIndex += shift;
+		}
+
+		if (highestBitIndex >= maxValueBitCount)
+			return histogramBucketCount - (size_t)1;
+
+		const auto shift = highestBitIndex - subBucketBitCount;
+		return (size_t)(((uint64_t)shift + (uint64_t)1) * subBucketCount + ((value >> shift) & (subBucketCount - (uint64_t)1)));
+	}
+
+	inline void _SumHistogram(Histogram histogram, uint64_t* bucketCounts_out, uint64_t& sum_out) noexcept
+	{
+		const auto& sharedBucketCounts = sharedShard.histogramBucketCounts[(size_t)histogram];
+		for (auto i = (size_t)0; i < histogramBucketCount; ++i)
+			bucketCounts_out[i] = sharedBucketCounts[i].load(std::memory_order_relaxed);
+		sum_out = sharedShard.histogramSums[(size_t)histogram].load(std::memory_order_relaxed);
+
+		for (const auto& shard : threadShards)
+		{
+			const auto& bucketCounts = shard.histogramBucketCounts[(size_t)histogram];
+			for (auto i = (size_t)0; i < histogramBucketCount; ++i)
+				bucketCounts_out[i] += bucketCounts[i].load(std::memory_order_relaxed);
+			sum_out += shard.histogramSums[(size_t)histogram].load(std::memory_order_relaxed);
+		}
+	}
+}
+
+namespace SDS
+{
+	static_assert(sizeof(IOStatistics::errorCounts) / sizeof(uint64_t) == Statistics::errorValueCount);
+	static_assert(sizeof(LatencyHistogram::bucketCounts) / sizeof(uint64_t) == Statistics::histogramBucketCount);
+
+	inline static bool _IsLatencyHistogramKindValid(LatencyHistogramKind kind) noexcept;
+
+	ErrorIndicator GetStatistics(IOStatistics* statistics_out) noexcept
+	{
+		if (statistics_out == nullptr)
+		{
+			ErrorHandler::SignalError(Error::PassedPointerIsNull);
+			return ErrorIndicator::Error;
+		}
+
+		*statistics_out = {};
+
+		//The shards are never destroyed, so they are read while their threads keep writing them.
+		Statistics::_AddTo(*statistics_out, Statistics::sharedShard.values, Statistics::sharedShard.errorCounts);
+		for (const auto& shard : Statistics::threadShards)
+			Statistics::_AddTo(*statistics_out, shard.values, shard.errorCounts);
+
+		return (ErrorIndicator)1;
+	}
+
+	ErrorIndicator GetSocketStatistics(SocketHandle socketHandle, IOStatistics* statistics_out) noexcept
+	{
+		const ErrorHandler::SocketScope socketScope(socketHandle);
+		if (statistics_out == nullptr)
+		{
+			ErrorHandler::SignalError(Error::PassedPointerIsNull);
+			return ErrorIndicator::Error;
+		}
+
+		const auto* const socketCounters = Statistics::FindSocketCounters(socketHandle);
+		if (socketCounters == nullptr)
+		{
+			ErrorHandler::SignalError(Error::InvalidSocketHandle);
+			return ErrorIndicator::Error;
+		}
+
+		*statistics_out = {};
+
+		Statistics::_AddTo(*statistics_out, socketCounters->values, socketCounters->errorCounts.values);
+		return (ErrorIndicator)1;
+	}
+
+	ErrorIndicator GetLatencyHistogram(LatencyHistogramKind kind, LatencyHistogram* histogram_out) noexcept
+	{
+		if (histogram_out == nullptr)
+		{
+			ErrorHandler::SignalError(Error::PassedPointerIsNull);
+			return ErrorIndicator::Error;
+		}
+
+		if (!_IsLatencyHistogramKindValid(kind))
+			return ErrorIndicator::Error;
+
+		const auto histogram = (Statistics::Histogram)kind;
+		const std::lock_guard lock(Statistics::histogramBaselinesMutex);
+		Statistics::_SumHistogram(histogram, histogram_out->bucketCounts, histogram_out->sumInNanoseconds);
+
+		//The bucket count and the sum are read separately, so the values recorded during the call may miss one of them.
+		const auto* const baselineBucketCounts = Statistics::histogramBaselineBucketCounts[(size_t)histogram];
+		histogram_out->totalCount = (uint64_t)0;
+		for (auto i = (size_t)0; i < Statistics::histogramBucketCount; ++i)
+		{
+			histogram_out->bucketCounts[i] -= baselineBucketCounts[i];
+			histogram_out->totalCount += histogram_out->bucketCounts[i];
+		}
+
+		histogram_out->sumInNanoseconds -= Statistics::histogramBaselineSums[(size_t)histogram];
+		return (ErrorIndicator)1;
+	}
+
+	ErrorIndicator ResetLatencyHistogram(LatencyHistogramKind kind) noexcept
+	{
+		if (!_IsLatencyHistogramKindValid(kind))
+			return ErrorIndicator::Error;
+
+		const auto histogram = (Statistics::Histogram)kind;
+		const std::lock_guard lock(Statistics::histogramBaselinesMutex);
+		Statistics::_SumHistogram(histogram, Statistics::histogramBaselineBucketCounts[(size_t)histogram],
+			Statistics::histogramBaselineSums[(size_t)histogram]);
+
+		return (ErrorIndicator)1;
+	}
+
+	void SetAcceptQueueDwellSamplingInterval(uint32_t samplingInterval) noexcept
+	{
+		Statistics::acceptQueueDwellSamplingInterval.store(samplingInterval, std::memory_order_relaxed);
+	}
+
+	uint64_t GetLatencyHistogramBucketLowerBound(int32_t bucketIndex) noexcept
+	{
+		if (bucketIndex < (int32_t)0 || (size_t)bucketIndex >= Statistics::histogramBucketCount)
+			return UINT64_MAX;
+
+		if ((uint64_t)bucketIndex < Statistics::subBucketCount)
+			return (uint64_t)bucketIndex;
+
+		const auto shift = (uint64_t)bucketIndex / Statistics::subBucketCount - (uint64_t)1;
+		return (Statistics::subBucketCount + (uint64_t)bucketIndex % Statistics::subBucketCount) << shift;
+	}
+
+	uint64_t GetLatencyHistogramPercentile(const LatencyHistogram* histogram, double percentile) noexcept
+	{
+		if (histogram == nullptr)
+		{
+			ErrorHandler::SignalError(Error::PassedPointerIsNull);
+			return (uint64_t)0;
+		}
+
+		auto totalCount = (uint64_t)0;
+		for (const auto bucketCount : histogram->bucketCounts)
+			totalCount += bucketCount;
+
+		if (totalCount == (uint64_t)0)
+			return (uint64_t)0;
+
+		percentile = percentile < 0.0 ? 0.0 : (percentile > 100.0 ? 100.0 : percentile);
+		auto rank = (uint64_t)(percentile / 100.0 * (double)totalCount + 0.5);
+		rank = rank != (uint64_t)0 ? rank : (uint64_t)1;
+
+		auto count = (uint64_t)0;
+		for (auto i = (int32_t)0; i < (int32_t)Statistics::histogramBucketCount; ++i)
+		{
+			count += histogram->bucketCounts[i];
+			if (count >= rank)
+				return i + (int32_t)1 < (int32_t)Statistics::histogramBucketCount ? GetLatencyHistogramBucketLowerBound(i + (int32_t)1) - (uint64_t)1 : UINT64_MAX;
+		}
+
+		return UINT64_MAX;
+	}
+
+	inline bool _IsLatencyHistogramKindValid(LatencyHistogramKind kind) noexcept
+	{
+		if ((size_t)kind >= (size_t)Statistics::Histogram::Count)
+		{
+			ErrorHandler::SignalError(Error::InvalidLatencyHistogramKind);
+			return false;
+		}
+
+		return true;
+	}
+}
\ No newline at end of file
@@ -1,11 +1,13 @@
 #include "Utilities/Buffer.hpp"
+#include "Utilities/BufferPool.hpp"
 #include <memory>
+#include <new>
 
 Buffer::Buffer(size_t size) :
 	m_bufferSize(size)
 {
 	if (m_bufferSize != (size_t)0)
-		m_buffer = new std::byte[m_bufferSize];
+		Allocate();
 }
 
 Buffer::Buffer(Buffer&& anotherBuffer) noexcept
@@ -15,11 +17,17 @@ Buffer::Buffer(Buffer&& anotherBuffer) noexcept
 
 void Buffer::Resize(size_t newSize)
 {
+	if (newSize != (size_t)0 && newSize <= m_bufferCapacity)
+	{
+		m_bufferSize = newSize;
+		return;
+	}
+
 	Destruct();
 
 	m_bufferSize = newSize;
 	if (m_bufferSize != (size_t)0)
-		m_buffer = new std::byte[m_bufferSize];
+		Allocate();
 }
 
 Buffer& Buffer::operator=(Buffer&& anotherBuffer) noexcept
@@ -29,17 +37,34 @@ Buffer& Buffer::operator=(Buffer&& anotherBuffer) noexcept
 		Destruct();
 
 		m_bufferSize = anotherBuffer.m_bufferSize;
+		m_bufferCapacity = anotherBuffer.m_bufferCapacity;
 		m_buffer = anotherBuffer.m_buffer;
 
 		anotherBuffer.m_bufferSize = (size_t)0;
+		anotherBuffer.m_bufferCapacity = (size_t)0;
 		anotherBuffer.m_buffer = nullptr;
 	}
 
 	return *this;
 }
 
+void Buffer::Allocate()
+{
+	m_buffer = static_cast<std::byte*>(BufferPool::Acquire(m_bufferSize, m_bufferCapacity));
+	if (m_buffer == nullptr)
+	{
+		m_bufferSize = (size_t)0;
+		m_bufferCapacity = (size_t)0;
+		throw std::bad_alloc();
+	}
+}
+
 void Buffer::Destruct() noexcept
 {
-	delete[] m_buffer;
+	if (m_buffer != nullptr)
+		BufferPool::Release(m_buffer);
+
+	m_bufferSize = (size_t)0;
+	m_bufferCapacity = (size_t)0;
 	m_buffer = nullptr;
 }
\ No newline at end of file
@@ -0,0 +1,611 @@
+#include "Utilities/BufferPool.hpp"
+#include "Interface/BufferPool.hpp"
+#include "ErrorHandler.hpp"
+#include <atomic>
+#include <vector>
+#include <mutex>
+#include <new>
+
+namespace BufferPool
+{
+	static constexpr auto oversizedSizeClassIndex = (uint16_t)sizeClassCount;
+	static constexpr auto blockMagic = (uint32_t)0x42554646;
+	static constexpr auto threadCacheByteLimit = (size_t)256 * (size_t)1024;
+	static constexpr auto minBlocksPerSlab = (size_t)8;
+	static constexpr auto unboundArenaIndex = (uint16_t)maxNUMANodeCount;
+	static constexpr auto arenaCount = (size_t)maxNUMANodeCount + (size_t)1;
+
+	struct alignas(blockAlignment) BlockHeader final
+	{
+		std::atomic<uint32_t> referenceCount;
+		uint32_t magic;
+		uint16_t sizeClassIndex;
+		uint16_t arenaIndex;
+		bool isHugePageBacked; //Only used for oversized blocks, which have their own regions.
+		size_t capacity;
+		BlockHeader* nextFreeBlock;
+	};
+
+	static_assert(sizeof(BlockHeader) == blockAlignment);
+
+	//Free blocks which aren't in any thread cache. Exited threads return their cached blocks here.
+	struct SizeClass final
+	{
+		std::mutex mutex;
+		BlockHeader* freeBlocks = nullptr;
+		uint64_t freeBlockCount = (uint64_t)0;
+
+		//Blocks are carved from the current slab only when they are needed, so untouched memory stays uncommitted.
+		std::byte* slab = nullptr;
+		size_t slabRemainingSize = (size_t)0;
+
+		std::atomic<uint64_t> blockCount{ 0 };
+	};
+
+	//Every NUMA node has its own slabs. The last arena is for the threads whose node is unknown.
+	struct Arena final
+	{
+		SizeClass sizeClasses[sizeClassCount];
+	};
+
+	static Arena arenas[arenaCount];
+
+	//Marks the slabs of all regions, so IsBuffer never reads memory outside the pool. Regions are aligned to the slab size,
+	//so a header is in a region if its slab is marked. Leaves are created by the first region in their range and never freed.
+	static constexpr auto addressBitCount = 48; //User space addresses are narrower on all supported machines.
+	static constexpr auto slabBitCount = 21;
+	static constexpr auto leafBitCount = 13;
+	static constexpr auto rootBitCount = addressBitCount - slabBitCount - leafBitCount;
+
+	static_assert(slabSize == (size_t)1 << slabBitCount);
+	static_assert(slabSize % blockAlignment == (size_t)0, "A header must never straddle two slabs.");
+
+	struct RegionMapLeaf final
+	{
+		std::atomic<bool> isSlabInRegion[(size_t)1 << leafBitCount];
+	};
+
+	static std::atomic<RegionMapLeaf*> regionMap[(size_t)1 << rootBitCount];
+	static std::atomic<uint64_t> reservedByteCount{ 0 };
+	static std::atomic<uint64_t> hugePageByteCount{ 0 };
+	static std::atomic<uint64_t> oversizedBufferCount{ 0 };
+
+	//The cache is trivially destructible, so a buffer released during the thread exit still finds valid memory.
+	//The counts are only written by the owning thread and are read for the statistics.
+	struct ThreadCache final
+	{
+		BlockHeader* freeBlocks[sizeClassCount];
+		std::atomic<uint32_t> freeBlockCounts[sizeClassCount];
+		uint16_t arenaIndex;
+		bool isRegistered;
+		bool isRetired;
+	};
+
+	struct ThreadCacheRetirer final
+	{
+		~ThreadCacheRetirer() noexcept;
+	};
+
+	static std::mutex threadCachesMutex; //Locked before any size class mutex.
+	static std::vector<ThreadCache*> threadCaches;
+
+	static thread_local ThreadCache threadCache{};
+	static thread_local ThreadCacheRetirer threadCacheRetirer;
+
+	inline static uint16_t _ToSizeClassIndex(size_t size) noexcept;
+	inline static size_t _GetBlockSize(uint32_t sizeClassIndex) noexcept;
+	inline static uint32_t _GetThreadCacheLimit(uint32_t sizeClassIndex) noexcept;
+	inline static uint16_t _ToArenaIndex(int32_t numaNode) noexcept;
+	inline static int32_t _ToNUMANode(uint16_t arenaIndex) noexcept;
+	inline static ThreadCache* _GetThreadCache() noexcept;
+	inline static BlockHeader* _ToHeader(const void* buffer) noexcept;
+	inline static void* _ToBuffer(BlockHeader* header) noexcept;
+	inline static BlockHeader* _AcquireOversized(size_t size, uint16_t arenaIndex) noexcept;
+	inline static void _ReleaseOversized(BlockHeader* header) noexcept;
+	inline static uint32_t _PopSharedBlocks(uint16_t arenaIndex, uint16_t sizeClassIndex, uint32_t maxBlockCount, BlockHeader*& blocks_out) noexcept;
+	inline static void _PushSharedBlocks(uint16_t arenaIndex, uint16_t sizeClassIndex, BlockHeader* blocks, uint32_t blockCount) noexcept;
+	inline static BlockHeader* _Carve(SizeClass& sizeClass, uint16_t arenaIndex, uint16_t sizeClassIndex) noexcept;
+	inline static void _FlushThreadCache(ThreadCache& cache, uint16_t sizeClassIndex, uint32_t blockCount) noexcept;
+	inline static void _FlushThreadCache(ThreadCache& cache) noexcept;
+	inline static bool _MarkRegion(const std::byte* region, size_t size, bool isInRegion) noexcept;
+	inline static bool _IsInRegion(uintptr_t address) noexcept;
+
+	void* Acquire(size_t size, size_t& capacity_out) noexcept
+	{
+		auto* const cache = _GetThreadCache();
+		const uint16_t arenaIndex = cache != nullptr ? cache->arenaIndex : _ToArenaIndex(GetCurrentNUMANode());
+
+		BlockHeader* header;
+		if (size > maxBlockSize)
+		{
+			header = _AcquireOversized(size, arenaIndex);
+			if (header == nullptr)
+				return nullptr;
+		}
+		else
+		{
+			const uint16_t sizeClassIndex = _ToSizeClassIndex(size);
+			if (cache != nullptr && cache->freeBlocks[sizeClassIndex] == nullptr)
+			{
+				const auto blockCount = _PopSharedBlocks(arenaIndex, sizeClassIndex, _GetThreadCacheLimit(sizeClassIndex) / (uint32_t)2, cache->freeBlocks[sizeClassIndex]);
+				cache->freeBlockCounts[sizeClassIndex].store(blockCount, std::memory_order_relaxed);
+			}
+
+			if (cache != nullptr && cache->freeBlocks[sizeClassIndex] != nullptr)
+			{
+				header = cache->freeBlocks[sizeClassIndex];
+				cache->freeBlocks[sizeClassIndex] = header->nextFreeBlock;
+				cache->freeBlockCounts[sizeClassIndex].store(cache->freeBlockCounts[sizeClassIndex].load(std::memory_order_relaxed) - (uint32_t)1, std::memory_order_relaxed);
+			}
+			else if (_PopSharedBlocks(arenaIndex, sizeClassIndex, (uint32_t)1, header) == (uint32_t)0)
+			{
+				return nullptr;
+			}
+		}
+
+		header->nextFreeBlock = nullptr;
+		header->referenceCount.store((uint32_t)1, std::memory_order_relaxed);
+		capacity_out = header->capacity;
+		return _ToBuffer(header);
+	}
+
+	void Retain(void* buffer) noexcept
+	{
+		_ToHeader(buffer)->referenceCount.fetch_add((uint32_t)1, std::memory_order_relaxed);
+	}
+
+	void Release(void* buffer) noexcept
+	{
+		auto* const header = _ToHeader(buffer);
+
+		//The writes made through other references must be visible before the block is reused.
+		if (header->referenceCount.fetch_sub((uint32_t)1, std::memory_order_acq_rel) != (uint32_t)1)
+			return;
+
+		const uint16_t sizeClassIndex = header->sizeClassIndex;
+		if (sizeClassIndex == oversizedSizeClassIndex)
+		{
+			_ReleaseOversized(header);
+			return;
+		}
+
+		//Blocks of other nodes go straight back to their arenas, so a thread cache only holds local memory.
+		auto* const cache = _GetThreadCache();
+		if (cache == nullptr || cache->arenaIndex != header->arenaIndex)
+		{
+			header->nextFreeBlock = nullptr;
+			_PushSharedBlocks(header->arenaIndex, sizeClassIndex, header, (uint32_t)1);
+			return;
+		}
+
+		header->nextFreeBlock = cache->freeBlocks[sizeClassIndex];
+		cache->freeBlocks[sizeClassIndex] = header;
+
+		const uint32_t blockCount = cache->freeBlockCounts[sizeClassIndex].load(std::memory_order_relaxed) + (uint32_t)1;
+		cache->freeBlockCounts[sizeClassIndex].store(blockCount, std::memory_order_relaxed);
+		if (blockCount > _GetThreadCacheLimit(sizeClassIndex))
+			_FlushThreadCache(*cache, sizeClassIndex, blockCount / (uint32_t)2);
+	}
+
+	size_t GetCapacity(const void* buffer) noexcept
+	{
+		return _ToHeader(buffer)->capacity;
+	}
+
+	bool IsBuffer(const void* buffer) noexcept
+	{
+		const auto address = reinterpret_cast<uintptr_t>(buffer);
+		if (address % blockAlignment != (uintptr_t)0 || address < (uintptr_t)sizeof(BlockHeader) ||
+			!_IsInRegion(address - (uintptr_t)sizeof(BlockHeader)))
+		{
+			return false;
+		}
+
+		const auto* const header = _ToHeader(buffer);
+		return header->magic == blockMagic && header->referenceCount.load(std::memory_order_relaxed) != (uint32_t)0;
+	}
+
+	void SetThreadNUMANode(int32_t numaNode) noexcept
+	{
+		auto* const cache = _GetThreadCache();
+		if (cache == nullptr)
+			return;
+
+		const uint16_t arenaIndex = _ToArenaIndex(numaNode >= (int32_t)0 ? numaNode : GetCurrentNUMANode());
+		if (arenaIndex == cache->arenaIndex)
+			return;
+
+		_FlushThreadCache(*cache);
+		cache->arenaIndex = arenaIndex;
+	}
+
+	ThreadCacheRetirer::~ThreadCacheRetirer() noexcept
+	{
+		if (!threadCache.isRegistered)
+			return;
+
+		const std::lock_guard lock(threadCachesMutex);
+		for (auto i = (size_t)0; i < threadCaches.size(); ++i)
+		{
+			if (threadCaches[i] == &threadCache)
+			{
+				threadCaches[i] = threadCaches.back();
+				threadCaches.pop_back();
+				break;
+			}
+		}
+
+		_FlushThreadCache(threadCache);
+		threadCache.isRetired = true;
+	}
+
+	uint16_t _ToSizeClassIndex(size_t size) noexcept
+	{
+		auto sizeClassIndex = (uint16_t)0;
+		while (_GetBlockSize(sizeClassIndex) < size)
+			++sizeClassIndex;
+
+		return sizeClassIndex;
+	}
+
+	size_t _GetBlockSize(uint32_t sizeClassIndex) noexcept
+	{
+		return minBlockSize << sizeClassIndex;
+	}
+
+	uint32_t _GetThreadCacheLimit(uint32_t sizeClassIndex) noexcept
+	{
+		const size_t blockCount = threadCacheByteLimit / _GetBlockSize(sizeClassIndex);
+		return blockCount < (size_t)2 ? (uint32_t)2 : (blockCount > (size_t)64 ? (uint32_t)64 : (uint32_t)blockCount);
+	}
+
+	uint16_t _ToArenaIndex(int32_t numaNode) noexcept
+	{
+		return numaNode >= (int32_t)0 && numaNode < (int32_t)maxNUMANodeCount ? (uint16_t)numaNode : unboundArenaIndex;
+	}
+
+	int32_t _ToNUMANode(uint16_t arenaIndex) noexcept
+	{
+		return arenaIndex != unboundArenaIndex ? (int32_t)arenaIndex : (int32_t)-1;
+	}
+
+	ThreadCache* _GetThreadCache() noexcept
+	{
+		if (threadCache.isRetired)
+			return nullptr;
+
+		if (!threadCache.isRegistered)
+		{
+			try
+			{
+				const std::lock_guard lock(threadCachesMutex);
+				threadCaches.push_back(&threadCache);
+			}
+			catch (...)
+			{
+				return nullptr;
+			}
+
+			//Touching the retirer constructs it, so the cache is flushed when the thread exits.
+			static_cast<void>(&threadCacheRetirer);
+			threadCache.arenaIndex = _ToArenaIndex(GetCurrentNUMANode());
+			threadCache.isRegistered = true;
+		}
+
+		return &threadCache;
+	}
+
+	BlockHeader* _ToHeader(const void* buffer) noexcept
+	{
+		return reinterpret_cast<BlockHeader*>(const_cast<std::byte*>(static_cast<const std::byte*>(buffer)) - sizeof(BlockHeader));
+	}
+
+	void* _ToBuffer(BlockHeader* header) noexcept
+	{
+		return reinterpret_cast<std::byte*>(header) + sizeof(BlockHeader);
+	}
+
+	BlockHeader* _AcquireOversized(size_t size, uint16_t arenaIndex) noexcept
+	{
+		if (size > SIZE_MAX - sizeof(BlockHeader) - slabSize)
+			return nullptr;
+
+		//The region is rounded up to the slab size, so the rest of it is given to the buffer.
+		const size_t regionSize = (sizeof(BlockHeader) + size + slabSize - (size_t)1) / slabSize * slabSize;
+		bool isHugePageBacked;
+		auto* const region = AllocateRegion(regionSize, _ToNUMANode(arenaIndex), isHugePageBacked);
+		if (region == nullptr)
+			return nullptr;
+
+		if (!_MarkRegion(region, regionSize, true))
+		{
+			FreeRegion(region, regionSize);
+			return nullptr;
+		}
+
+		auto* const header = new (region) BlockHeader{};
+		header->magic = blockMagic;
+		header->sizeClassIndex = oversizedSizeClassIndex;
+		header->arenaIndex = arenaIndex;
+		header->isHugePageBacked = isHugePageBacked;
+		header->capacity = regionSize - sizeof(BlockHeader);
+
+		reservedByteCount.fetch_add(regionSize, std::memory_order_relaxed);
+		if (isHugePageBacked)
+			hugePageByteCount.fetch_add(regionSize, std::memory_order_relaxed);
+
+		oversizedBufferCount.fetch_add((uint64_t)1, std::memory_order_relaxed);
+		return header;
+	}
+
+	void _ReleaseOversized(BlockHeader* header) noexcept
+	{
+		const size_t regionSize = sizeof(BlockHeader) + header->capacity;
+		reservedByteCount.fetch_sub(regionSize, std::memory_order_relaxed);
+		if (header->isHugePageBacked)
+			hugePageByteCount.fetch_sub(regionSize, std::memory_order_relaxed);
+
+		oversizedBufferCount.fetch_sub((uint64_t)1, std::memory_order_relaxed);
+		header->magic = (uint32_t)0;
+		_MarkRegion(reinterpret_cast<std::byte*>(header), regionSize, false);
+		FreeRegion(reinterpret_cast<std::byte*>(header), regionSize);
+	}
+
+	uint32_t _PopSharedBlocks(uint16_t arenaIndex, uint16_t sizeClassIndex, uint32_t maxBlockCount, BlockHeader*& blocks_out) noexcept
+	{
+		auto& sizeClass = arenas[arenaIndex].sizeClasses[sizeClassIndex];
+		const std::lock_guard lock(sizeClass.mutex);
+
+		blocks_out = nullptr;
+		auto blockCount = (uint32_t)0;
+		while (blockCount < maxBlockCount)
+		{
+			auto* header = sizeClass.freeBlocks;
+			if (header != nullptr)
+			{
+				sizeClass.freeBlocks = header->nextFreeBlock;
+				--sizeClass.freeBlockCount;
+			}
+			else
+			{
+				header = _Carve(sizeClass, arenaIndex, sizeClassIndex);
+				if (header == nullptr)
+					break;
+			}
+
+			header->nextFreeBlock = blocks_out;
+			blocks_out = header;
+			++blockCount;
+		}
+
+		return blockCount;
+	}
+
+	void _PushSharedBlocks(uint16_t arenaIndex, uint16_t sizeClassIndex, BlockHeader* blocks, uint32_t blockCount) noexcept
+	{
+		auto* lastBlock = blocks;
+		while (lastBlock->nextFreeBlock != nullptr)
+			lastBlock = lastBlock->nextFreeBlock;
+
+		auto& sizeClass = arenas[arenaIndex].sizeClasses[sizeClassIndex];
+		const std::lock_guard lock(sizeClass.mutex);
+		lastBlock->nextFreeBlock = sizeClass.freeBlocks;
+		sizeClass.freeBlocks = blocks;
+		sizeClass.freeBlockCount += blockCount;
+	}
+
+	BlockHeader* _Carve(SizeClass& sizeClass, uint16_t arenaIndex, uint16_t sizeClassIndex) noexcept
+	{
+		const size_t blockSize = _GetBlockSize(sizeClassIndex);
+		const size_t blockStride = sizeof(BlockHeader) + blockSize;
+		if (sizeClass.slabRemainingSize < blockStride)
+		{
+			//Big blocks get slabs of many slab sizes, so a slab never holds only a couple of them.
+			const size_t size = (blockStride * minBlocksPerSlab + slabSize - (size_t)1) / slabSize * slabSize;
+			bool isHugePageBacked;
+			auto* const slab = AllocateRegion(size, _ToNUMANode(arenaIndex), isHugePageBacked);
+			if (slab == nullptr)
+				return nullptr;
+
+			if (!_MarkRegion(slab, size, true))
+			{
+				FreeRegion(slab, size);
+				return nullptr;
+			}
+
+			sizeClass.slab = slab;
+			sizeClass.slabRemainingSize = size;
+			reservedByteCount.fetch_add(size, std::memory_order_relaxed);
+			if (isHugePageBacked)
+				hugePageByteCount.fetch_add(size, std::memory_order_relaxed);
+		}
+
+		auto* const header = new (sizeClass.slab) BlockHeader{};
+		header->magic = blockMagic;
+		header->sizeClassIndex = sizeClassIndex;
+		header->arenaIndex = arenaIndex;
+		header->capacity = blockSize;
+
+		sizeClass.slab += blockStride;
+		sizeClass.slabRemainingSize -= blockStride;
+		sizeClass.blockCount.store(sizeClass.blockCount.load(std::memory_order_relaxed) + (uint64_t)1, std::memory_order_relaxed);
+		return header;
+	}
+
+	void _FlushThreadCache(ThreadCache& cache, uint16_t sizeClassIndex, uint32_t blockCount) noexcept
+	{
+		auto* const blocks = cache.freeBlocks[sizeClassIndex];
+		auto* lastBlock = blocks;
+		for (auto i = (uint32_t)1; i < blockCount; ++i)
+			lastBlock = lastBlock->nextFreeBlock;
+
+		cache.freeBlocks[sizeClassIndex] = lastBlock->nextFreeBlock;
+		cache.freeBlockCounts[sizeClassIndex].store(cache.freeBlockCounts[sizeClassIndex].load(std::memory_order_relaxed) - blockCount, std::memory_order_relaxed);
+
+		lastBlock->nextFreeBlock = nullptr;
+		_PushSharedBlocks(cache.arenaIndex, sizeClassIndex, blocks, blockCount);
+	}
+
+	void _FlushThreadCache(ThreadCache& cache) noexcept
+	{
+		for (auto sizeClassIndex = (uint16_t)0; sizeClassIndex < (uint16_t)sizeClassCount; ++sizeClassIndex)
+		{
+			const uint32_t blockCount = cache.freeBlockCounts[sizeClassIndex].load(std::memory_order_relaxed);
+			if (blockCount != (uint32_t)0)
+				_FlushThreadCache(cache, sizeClassIndex, blockCount);
+		}
+	}
+
+	//The returned bool value is set to false if a leaf can't be allocated. Unmarking never fails.
+	bool _MarkRegion(const std::byte* region, size_t size, bool isInRegion) noexcept
+	{
+		const auto firstSlabNumber = (uint64_t)reinterpret_cast<uintptr_t>(region) >> slabBitCount;
+		const auto slabCount = (uint64_t)(size >> slabBitCount);
+		if ((firstSlabNumber + slabCount) >> (leafBitCount + rootBitCount) != (uint64_t)0)
+			return !isInRegion;
+
+		for (auto slabNumber = firstSlabNumber; slabNumber < firstSlabNumber + slabCount; ++slabNumber)
+		{
+			auto& leafPointer = regionMap[(size_t)(slabNumber >> leafBitCount)];
+			auto* leaf = leafPointer.load(std::memory_order_acquire);
+			if (leaf == nullptr)
+			{
+				if (!isInRegion)
+					continue;
+
+				auto* const newLeaf = new (std::nothrow) RegionMapLeaf{};
+				if (newLeaf == nullptr)
+				{
+					_MarkRegion(region, (size_t)(slabNumber - firstSlabNumber) << slabBitCount, false);
+					return false;
+				}
+
+				if (leafPointer.compare_exchange_strong(leaf, newLeaf, std::memory_order_acq_rel))
+					leaf = newLeaf;
+				else
+					delete newLeaf;
+			}
+
+			leaf->isSlabInRegion[(size_t)(slabNumber & (((uint64_t)1 << leafBitCount) - (uint64_t)1))].store(isInRegion, std::memory_order_release);
+		}
+
+		return true;
+	}
+
+	bool _IsInRegion(uintptr_t address) noexcept
+	{
+		const auto slabNumber = (uint64_t)address >> slabBitCount;
+		if (slabNumber >> (leafBitCount + rootBitCount) != (uint64_t)0)
+			return false;
+
+		const auto* const leaf = regionMap[(size_t)(slabNumber >> leafBitCount)].load(std::memory_order_acquire);
+		return leaf != nullptr &&
+			leaf->isSlabInRegion[(size_t)(slabNumber & (((uint64_t)1 << leafBitCount) - (uint64_t)1))].load(std::memory_order_acquire);
+	}
+}
+
+namespace SDS
+{
+	static_assert(sizeof(BufferPoolStatistics::sizeClasses) / sizeof(BufferPoolSizeClassStatistics) == BufferPool::sizeClassCount);
+
+	inline static bool _IsBufferValid(const void* buffer) noexcept;
+
+	void* AcquireBuffer(size_t size, size_t* capacity_out) noexcept
+	{
+		size_t capacity;
+		auto* const buffer = BufferPool::Acquire(size, capacity);
+		if (buffer == nullptr)
+		{
+			ErrorHandler::SignalError(Error::NotEnoughMemory);
+			return nullptr;
+		}
+
+		if (capacity_out != nullptr)
+			*capacity_out = capacity;
+
+		return buffer;
+	}
+
+	ErrorIndicator RetainBuffer(void* buffer) noexcept
+	{
+		if (!_IsBufferValid(buffer))
+			return ErrorIndicator::Error;
+
+		BufferPool::Retain(buffer);
+		return (ErrorIndicator)1;
+	}
+
+	ErrorIndicator ReleaseBuffer(void* buffer) noexcept
+	{
+		if (!_IsBufferValid(buffer))
+			return ErrorIndicator::Error;
+
+		BufferPool::Release(buffer);
+		return (ErrorIndicator)1;
+	}
+
+	size_t GetBufferCapacity(const void* buffer) noexcept
+	{
+		return _IsBufferValid(buffer) ? BufferPool::GetCapacity(buffer) : (size_t)0;
+	}
+
+	ErrorIndicator GetBufferPoolStatistics(BufferPoolStatistics* statistics_out) noexcept
+	{
+		if (statistics_out == nullptr)
+		{
+			ErrorHandler::SignalError(Error::PassedPointerIsNull);
+			return ErrorIndicator::Error;
+		}
+
+		*statistics_out = {};
+
+		//The lock only keeps the caches from being destroyed. The owning threads keep using them without locking.
+		const std::lock_guard lock(BufferPool::threadCachesMutex);
+		for (auto sizeClassIndex = (uint32_t)0; sizeClassIndex < (uint32_t)BufferPool::sizeClassCount; ++sizeClassIndex)
+		{
+			auto& sizeClassStatistics = statistics_out->sizeClasses[sizeClassIndex];
+			sizeClassStatistics.blockSize = (uint64_t)BufferPool::_GetBlockSize(sizeClassIndex);
+			for (const auto* const cache : BufferPool::threadCaches)
+				sizeClassStatistics.threadCachedBlockCount += (uint64_t)cache->freeBlockCounts[sizeClassIndex].load(std::memory_order_relaxed);
+
+			for (auto& arena : BufferPool::arenas)
+			{
+				auto& sizeClass = arena.sizeClasses[sizeClassIndex];
+				const std::lock_guard sizeClassLock(sizeClass.mutex);
+				sizeClassStatistics.sharedFreeBlockCount += sizeClass.freeBlockCount;
+				sizeClassStatistics.blockCount += sizeClass.blockCount.load(std::memory_order_relaxed);
+			}
+
+			//The cached counts are read without locking, so they may be a bit off while other threads use the pool.
+			const uint64_t freeBlockCount = sizeClassStatistics.threadCachedBlockCount + sizeClassStatistics.sharedFreeBlockCount;
+			sizeClassStatistics.usedBlockCount = sizeClassStatistics.blockCount > freeBlockCount ? sizeClassStatistics.blockCount - freeBlockCount : (uint64_t)0;
+		}
+
+		statistics_out->oversizedBufferCount = BufferPool::oversizedBufferCount.load(std::memory_order_relaxed);
+		statistics_out->reservedByteCount = BufferPool::reservedByteCount.load(std::memory_order_relaxed);
+		statistics_out->hugePageByteCount = BufferPool::hugePageByteCount.load(std::memory_order_relaxed);
+		return (ErrorIndicator)1;
+	}
+
+	void SetThreadBufferNUMANode(int32_t numaNode) noexcept
+	{
+		BufferPool::SetThreadNUMANode(numaNode);
+	}
+
+	bool _IsBufferValid(const void* buffer) noexcept
+	{
+		if (buffer == nullptr)
+		{
+			ErrorHandler::SignalError(Error::PassedPointerIsNull);
+			return false;
+		}
+
+		if (!BufferPool::IsBuffer(buffer))
+		{
+			ErrorHandler::SignalError(Error::InvalidBuffer);
+			return false;
+		}
+
+		return true;
+	}
+}
\ No newline at end of file
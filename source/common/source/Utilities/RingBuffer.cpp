@@ -0,0 +1,186 @@
+#include "Utilities/RingBuffer.hpp"
+#include "Interface/RingBuffer.hpp"
+#include "ErrorHandler.hpp"
+#include <memory>
+#include <new>
+
+RingBuffer::RingBuffer(RingBuffer&& anotherRingBuffer) noexcept
+{
+	(*this) = std::move(anotherRingBuffer);
+}
+
+bool RingBuffer::Allocate(size_t minCapacity) noexcept
+{
+	Destruct();
+
+	const size_t granularity = GetMappingGranularity();
+	const size_t capacity = (minCapacity + granularity - (size_t)1) / granularity * granularity;
+	m_data = MapMirrored(capacity);
+	if (m_data == nullptr)
+		return false;
+
+	m_capacity = capacity;
+	return true;
+}
+
+void RingBuffer::Consume(size_t byteCount) noexcept
+{
+	m_readableSize -= byteCount;
+
+	//An empty buffer starts over, so small messages keep reusing the same cache lines.
+	m_readOffset = m_readableSize != (size_t)0 ? m_readOffset + byteCount : (size_t)0;
+	if (m_readOffset >= m_capacity)
+		m_readOffset -= m_capacity;
+}
+
+RingBuffer& RingBuffer::operator=(RingBuffer&& anotherRingBuffer) noexcept
+{
+	if (this != &anotherRingBuffer)
+	{
+		Destruct();
+
+		m_data = anotherRingBuffer.m_data;
+		m_capacity = anotherRingBuffer.m_capacity;
+		m_readOffset = anotherRingBuffer.m_readOffset;
+		m_readableSize = anotherRingBuffer.m_readableSize;
+
+		anotherRingBuffer.m_data = nullptr;
+		anotherRingBuffer.m_capacity = (size_t)0;
+		anotherRingBuffer.m_readOffset = (size_t)0;
+		anotherRingBuffer.m_readableSize = (size_t)0;
+	}
+
+	return *this;
+}
+
+void RingBuffer::Destruct() noexcept
+{
+	if (m_data != nullptr)
+		Unmap(m_data, m_capacity);
+
+	m_data = nullptr;
+	m_capacity = (size_t)0;
+	m_readOffset = (size_t)0;
+	m_readableSize = (size_t)0;
+}
+
+namespace SDS
+{
+	static constexpr auto maxRingBufferCapacity = (size_t)1073741824;
+
+	inline static RingBuffer* _ToRingBuffer(RingBufferHandle ringBufferHandle) noexcept;
+
+	RingBufferHandle CreateRingBuffer(size_t minCapacity) noexcept
+	{
+		if (minCapacity == (size_t)0 || minCapacity > maxRingBufferCapacity)
+		{
+			ErrorHandler::SignalError(Error::InvalidRingBufferCapacity);
+			return nullptr;
+		}
+
+		auto* const ringBuffer = new (std::nothrow) RingBuffer();
+		if (ringBuffer == nullptr)
+		{
+			ErrorHandler::SignalError(Error::NotEnoughMemory);
+			return nullptr;
+		}
+
+		if (!ringBuffer->Allocate(minCapacity))
+		{
+			delete ringBuffer;
+			return nullptr;
+		}
+
+		return ringBuffer;
+	}
+
+	ErrorIndicator DestroyRingBuffer(RingBufferHandle ringBufferHandle) noexcept
+	{
+		auto* const ringBuffer = _ToRingBuffer(ringBufferHandle);
+		if (ringBuffer == nullptr)
+			return ErrorIndicator::Error;
+
+		delete ringBuffer;
+		return (ErrorIndicator)1;
+	}
+
+	size_t GetRingBufferCapacity(RingBufferHandle ringBufferHandle) noexcept
+	{
+		const auto* const ringBuffer = _ToRingBuffer(ringBufferHandle);
+		return ringBuffer != nullptr ? ringBuffer->GetCapacity() : (size_t)0;
+	}
+
+	ErrorIndicator GetRingBufferReadableView(RingBufferHandle ringBufferHandle, BufferSegment* view_out) noexcept
+	{
+		const auto* const ringBuffer = _ToRingBuffer(ringBufferHandle);
+		if (ringBuffer == nullptr)
+			return ErrorIndicator::Error;
+
+		if (view_out == nullptr)
+		{
+			ErrorHandler::SignalError(Error::PassedPointerIsNull);
+			return ErrorIndicator::Error;
+		}
+
+		view_out->data = ringBuffer->GetReadableData();
+		view_out->size = ringBuffer->GetReadableSize();
+		return (ErrorIndicator)1;
+	}
+
+	ErrorIndicator ConsumeRingBuffer(RingBufferHandle ringBufferHandle, size_t byteCount) noexcept
+	{
+		auto* const ringBuffer = _ToRingBuffer(ringBufferHandle);
+		if (ringBuffer == nullptr)
+			return ErrorIndicator::Error;
+
+		if (byteCount > ringBuffer->GetReadableSize())
+		{
+			ErrorHandler::SignalError(Error::InvalidRingBufferByteCount);
+			return ErrorIndicator::Error;
+		}
+
+		ringBuffer->Consume(byteCount);
+		return (ErrorIndicator)1;
+	}
+
+	ErrorIndicator GetRingBufferWritableView(RingBufferHandle ringBufferHandle, BufferSegment* view_out) noexcept
+	{
+		const auto* const ringBuffer = _ToRingBuffer(ringBufferHandle);
+		if (ringBuffer == nullptr)
+			return ErrorIndicator::Error;
+
+		if (view_out == nullptr)
+		{
+			ErrorHandler::SignalError(Error::PassedPointerIsNull);
+			return ErrorIndicator::Error;
+		}
+
+		view_out->data = ringBuffer->GetWritableData();
+		view_out->size = ringBuffer->GetWritableSize();
+		return (ErrorIndicator)1;
+	}
+
+	ErrorIndicator CommitRingBuffer(RingBufferHandle ringBufferHandle, size_t byteCount) noexcept
+	{
+		auto* const ringBuffer = _ToRingBuffer(ringBufferHandle);
+		if (ringBuffer == nullptr)
+			return ErrorIndicator::Error;
+
+		if (byteCount > ringBuffer->GetWritableSize())
+		{
+			ErrorHandler::SignalError(Error::InvalidRingBufferByteCount);
+			return ErrorIndicator::Error;
+		}
+
+		ringBuffer->Commit(byteCount);
+		return (ErrorIndicator)1;
+	}
+
+	inline RingBuffer* _ToRingBuffer(RingBufferHandle ringBufferHandle) noexcept
+	{
+		if (ringBufferHandle == nullptr)
+			ErrorHandler::SignalError(Error::InvalidRingBufferHandle);
+
+		return static_cast<RingBuffer*>(ringBufferHandle);
+	}
+}
\ No newline at end of file
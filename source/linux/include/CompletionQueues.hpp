@@ -0,0 +1,15 @@
+#pragma once
+
+//Completion queues keep references to the sockets registered with them,
+//so the rest of the library must tell them when a socket is destroyed.
+namespace CompletionQueues
+{
+	//Selects the preferred engine if the system supports it. It's called by the Initialize function.
+	void SelectIOEngine() noexcept;
+
+	//Must be called before the descriptor is closed. Otherwise, a new socket with the same descriptor may be mistaken for the old one.
+	void Forget(int nativeHandle) noexcept;
+
+	//Destroys all completion queues. It's called by the Shutdown function.
+	void DestroyAll() noexcept;
+}
@@ -0,0 +1,137 @@
+#pragma once
+#include <cstdint>
+#include <atomic>
+#include "IndirectIncludes/Types.hpp"
+#include "Statistics.hpp"
+
+//Handles returned by the library are indices into a table of native descriptors combined with generation counters.
+//The generation of a table slot changes when its descriptor is unregistered, so a stale handle is never mistaken
+//for a newer handle which reuses the slot. Looking up a handle never locks, so it can be done from many threads at once.
+//Every context has its own table, so contexts never contend with each other. A handle also keeps the index of its context.
+namespace NativeHandles
+{
+	enum class HandleRole : uint8_t
+	{
+		Poller,
+		UDPSocket,
+		BoundTCPSocket, //It's about to become listening.
+		ListeningTCPSocket,
+		ConnectingTCPSocket,
+		ConnectedTCPSocket,
+	};
+
+	//Options which are set through the library. Their values are remembered, so setting the same value again costs no system call.
+	enum class CachedOption : uint8_t
+	{
+		NaglesAlgorithm,
+		DestructionTimeout,
+		Broadcast,
+		ZeroCopy,
+		UDPSegmentation,
+		UDPCoalescing,
+		Cork,
+		SendBufferSize,
+		ReceiveBufferSize,
+		BusyPoll,
+		UserTimeout,
+		KeepAlive,
+		KeepAliveIdleTime,
+		KeepAliveInterval,
+		KeepAliveProbeCount,
+		Priority,
+		TypeOfService,
+
+		Count,
+	};
+
+	//The metadata of a slot is reset when a new descriptor is registered in it.
+	struct HandleMetadata final
+	{
+		std::atomic<HandleRole> role;
+		int addressFamily; //AF_UNSPEC for pollers. It never changes while the descriptor is registered.
+
+		//Values are stored incremented by one. Zero means that the value is unknown, because the system defaults vary.
+		std::atomic<uint32_t> cachedOptionValues[(size_t)CachedOption::Count];
+
+		//0 means unknown, 1 means that the address is being written and 2 means known.
+		std::atomic<uint8_t> anotherHostSocketAddressState;
+		SDS::ErrorIPSocketAddress anotherHostSocketAddressInNetworkBO;
+
+		Statistics::SocketCounters counters;
+
+		//The time the connection attempt was started. Zero means that there is no attempt to measure.
+		std::atomic<uint64_t> connectionStartTimestamp;
+
+		bool HasOptionValue(CachedOption option, uint32_t value) const noexcept
+		{
+			return cachedOptionValues[(size_t)option].load(std::memory_order_relaxed) == value + (uint32_t)1;
+		}
+
+		void CacheOptionValue(CachedOption option, uint32_t value) noexcept
+		{
+			cachedOptionValues[(size_t)option].store(value + (uint32_t)1, std::memory_order_relaxed);
+		}
+
+		bool GetAnotherHostSocketAddress(SDS::ErrorIPSocketAddress& socketAddressInNetworkBO_out) const noexcept
+		{
+			if (anotherHostSocketAddressState.load(std::memory_order_acquire) != (uint8_t)2)
+				return false;
+
+			socketAddressInNetworkBO_out = anotherHostSocketAddressInNetworkBO;
+			return true;
+		}
+
+		//Only the first call for an attempt records its duration, so polling an established connection again records nothing.
+		void RecordConnectionEstablishment() noexcept
+		{
+			const uint64_t startTimestamp = connectionStartTimestamp.exchange((uint64_t)0, std::memory_order_relaxed);
+			if (startTimestamp != (uint64_t)0)
+				Statistics::Record(Statistics::Histogram::ConnectionEstablishment, Statistics::GetTimestamp() - startTimestamp);
+		}
+
+		//Only the first address is remembered. The peer of a connected socket never changes.
+		void CacheAnotherHostSocketAddress(const SDS::ErrorIPSocketAddress& socketAddressInNetworkBO) noexcept
+		{
+			auto state = (uint8_t)0;
+			if (anotherHostSocketAddressState.compare_exchange_strong(state, (uint8_t)1, std::memory_order_acquire))
+			{
+				anotherHostSocketAddressInNetworkBO = socketAddressInNetworkBO;
+				anotherHostSocketAddressState.store((uint8_t)2, std::memory_order_release);
+			}
+		}
+	};
+
+	//Remembers the descriptor in the table of the current context so that the Shutdown function can close it.
+	//The returned handle is null only if an error occured. In that case, the descriptor is closed.
+	void* Register(int nativeHandle, HandleRole role, int addressFamily) noexcept;
+
+	//Records how long the accepted connection waited in the accept queue if the connection is sampled.
+	//The system only tells it in milliseconds.
+	void RecordAcceptQueueDwell(int nativeSocket) noexcept;
+
+	//The index is taken from the handle without checking it, so the handle may be stale.
+	uint32_t GetContextIndex(const void* handle) noexcept;
+
+	//The returned descriptor is -1 if the handle is stale or invalid, so the system call it's passed to fails with EBADF.
+	int ToNativeHandle(const void* handle) noexcept;
+	int ToNativeHandle(const void* handle, HandleMetadata*& metadata_out) noexcept;
+
+	//The returned pointer is null if the handle is stale or invalid.
+	HandleMetadata* GetMetadata(const void* handle) noexcept;
+
+	//Makes the handle stale and returns its descriptor, which must be closed by the caller.
+	//The returned descriptor is -1 if the handle is already stale or invalid, or if it's a poller handle and isPoller is false
+	//or the other way around. Only one of the concurrent calls can succeed.
+	int Unregister(const void* handle, bool isPoller) noexcept;
+
+	//Sets the option with setsockopt, unless the remembered value of the option is the same. The cached value identifies the option value.
+	//If an error occured, it's signaled and the remembered value is unchanged.
+	SDS::ErrorIndicator SetOption(const void* socketHandle, CachedOption option, int level, int name,
+		const void* optionValue, uint32_t optionValueSize, uint32_t cachedValue) noexcept;
+
+	//Closes all descriptors registered in the context and makes their handles stale.
+	void CloseAll(uint32_t contextIndex) noexcept;
+
+	//Closes all registered descriptors of all contexts and makes their handles stale.
+	void CloseAll() noexcept;
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include "IndirectIncludes/Types.hpp"
+#include "InternalTypeUtils.hpp"
+#include "LinuxAPI.hpp"
+
+//The IP address version of ErrorIPSocketAddress is chosen by checking the IPv4 address for zero.
+namespace NativeSocketAddresses
+{
+	//The socket address buffer can hold any IP socket address. The returned value is the size of the used part.
+	inline socklen_t ToNative(const SDS::ErrorIPSocketAddress& socketAddressInNetworkBO, sockaddr_in6& nativeSocketAddress_out) noexcept
+	{
+		nativeSocketAddress_out = {};
+		if (!InternalIPv4AddressUtils::IsZero(socketAddressInNetworkBO.v4))
+		{
+			auto& nativeIPv4SocketAddress = reinterpret_cast<sockaddr_in&>(nativeSocketAddress_out);
+			nativeIPv4SocketAddress.sin_family = AF_INET;
+			nativeIPv4SocketAddress.sin_port = socketAddressInNetworkBO.port;
+			InternalIPv4AddressUtils::CopyTo(&nativeIPv4SocketAddress.sin_addr, socketAddressInNetworkBO.v4);
+
+			return (socklen_t)sizeof(sockaddr_in);
+		}
+
+		nativeSocketAddress_out.sin6_family = AF_INET6;
+		nativeSocketAddress_out.sin6_port = socketAddressInNetworkBO.port;
+		nativeSocketAddress_out.sin6_flowinfo = socketAddressInNetworkBO.v6.flowInfo;
+		InternalIPv6AddressUtils::CopyTo(&nativeSocketAddress_out.sin6_addr, socketAddressInNetworkBO.v6);
+		nativeSocketAddress_out.sin6_scope_id = socketAddressInNetworkBO.v6.scopeID;
+
+		return (socklen_t)sizeof(sockaddr_in6);
+	}
+
+	//The returned bool value is set to false if the address doesn't belong to any IP address family.
+	//The error indicator is set only if the function succeeded.
+	inline bool FromNative(const sockaddr_in6& nativeSocketAddress, socklen_t nativeSocketAddressSize,
+		SDS::ErrorIPSocketAddress& socketAddressInNetworkBO_out) noexcept
+	{
+		socketAddressInNetworkBO_out = {};
+		socketAddressInNetworkBO_out.port = nativeSocketAddress.sin6_port;
+
+		if (nativeSocketAddress.sin6_family == AF_INET)
+		{
+			InternalIPv4AddressUtils::CopyFrom(&reinterpret_cast<const sockaddr_in&>(nativeSocketAddress).sin_addr,
+				socketAddressInNetworkBO_out.v4);
+		}
+		else if (nativeSocketAddress.sin6_family == AF_INET6 && nativeSocketAddressSize <= (socklen_t)sizeof(sockaddr_in6))
+		{
+			InternalIPv6AddressUtils::CopyFrom(&nativeSocketAddress.sin6_addr, socketAddressInNetworkBO_out.v6);
+			socketAddressInNetworkBO_out.v6.flowInfo = nativeSocketAddress.sin6_flowinfo;
+			socketAddressInNetworkBO_out.v6.scopeID = nativeSocketAddress.sin6_scope_id;
+		}
+		else
+		{
+			return false;
+		}
+
+		socketAddressInNetworkBO_out.errorIndicator = (SDS::ErrorIndicator)1;
+		return true;
+	}
+}
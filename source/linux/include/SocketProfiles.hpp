@@ -0,0 +1,153 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include "IndirectIncludes/Types.hpp"
+#include "LinuxAPI.hpp"
+#include "ErrorHandler.hpp"
+#include "NativeHandles.hpp"
+
+//A profile is turned into the list of options which differ from the defaults of a new socket, so a zeroed profile costs no system calls.
+//The list is set on a new descriptor before it's bound, then the values are cached in the metadata of its handle.
+//The cached values are the same as the ones of the setters, so setting an option the profile has already set costs no system call.
+namespace SocketProfiles
+{
+	struct Option final
+	{
+		NativeHandles::CachedOption cachedOption;
+		int level;
+		int name;
+
+		union
+		{
+			int integer;
+			linger lingerValue;
+		} value;
+
+		socklen_t valueSize;
+		uint32_t cachedValue;
+	};
+
+	struct Options final
+	{
+		Option options[(size_t)NativeHandles::CachedOption::Count]; //Every option is listed once at most.
+		size_t count;
+
+		void Add(NativeHandles::CachedOption cachedOption, int level, int name, int value) noexcept
+		{
+			auto& option = options[count++];
+			option.cachedOption = cachedOption;
+			option.level = level;
+			option.name = name;
+			option.value.integer = value;
+			option.valueSize = (socklen_t)sizeof(int);
+			option.cachedValue = (uint32_t)value;
+		}
+	};
+
+	//The system caps the buffer sizes itself, but it takes them as int.
+	inline int ToBufferSize(uint32_t size) noexcept
+	{
+		return size > (uint32_t)INT_MAX ? INT_MAX : (int)size;
+	}
+
+	inline void GetOptions(const SDS::SocketProfile& profile, int addressFamily, Options& options_out) noexcept
+	{
+		using NativeHandles::CachedOption;
+
+		options_out.count = (size_t)0;
+		if (profile.sendBufferSize != (uint32_t)0)
+			options_out.Add(CachedOption::SendBufferSize, SOL_SOCKET, SO_SNDBUF, ToBufferSize(profile.sendBufferSize));
+		if (profile.receiveBufferSize != (uint32_t)0)
+			options_out.Add(CachedOption::ReceiveBufferSize, SOL_SOCKET, SO_RCVBUF, ToBufferSize(profile.receiveBufferSize));
+		if (profile.busyPollTimeInMicroseconds != (uint32_t)0)
+			options_out.Add(CachedOption::BusyPoll, SOL_SOCKET, SO_BUSY_POLL, (int)profile.busyPollTimeInMicroseconds);
+		if (profile.userTimeoutInMilliseconds != (uint32_t)0)
+			options_out.Add(CachedOption::UserTimeout, IPPROTO_TCP, TCP_USER_TIMEOUT, (int)profile.userTimeoutInMilliseconds);
+
+		if (profile.keepAliveIdleTimeInSeconds != (uint32_t)0)
+		{
+			options_out.Add(CachedOption::KeepAlive, SOL_SOCKET, SO_KEEPALIVE, 1);
+			options_out.Add(CachedOption::KeepAliveIdleTime, IPPROTO_TCP, TCP_KEEPIDLE, (int)profile.keepAliveIdleTimeInSeconds);
+			if (profile.keepAliveIntervalInSeconds != (uint32_t)0)
+				options_out.Add(CachedOption::KeepAliveInterval, IPPROTO_TCP, TCP_KEEPINTVL, (int)profile.keepAliveIntervalInSeconds);
+			if (profile.keepAliveProbeCount != (uint32_t)0)
+				options_out.Add(CachedOption::KeepAliveProbeCount, IPPROTO_TCP, TCP_KEEPCNT, (int)profile.keepAliveProbeCount);
+		}
+
+		if (profile.isDestructionTimeoutEnabled != SDS::Bool::False)
+		{
+			auto& option = options_out.options[options_out.count++];
+			option.cachedOption = CachedOption::DestructionTimeout;
+			option.level = SOL_SOCKET;
+			option.name = SO_LINGER;
+			option.value.lingerValue = { 1, (int)profile.destructionTimeoutInSeconds };
+			option.valueSize = (socklen_t)sizeof(linger);
+			option.cachedValue = ((uint32_t)1 << 16) | (uint32_t)profile.destructionTimeoutInSeconds;
+		}
+
+		if (profile.isNaglesAlgorithmDisabled != SDS::Bool::False)
+			options_out.Add(CachedOption::NaglesAlgorithm, IPPROTO_TCP, TCP_NODELAY, 1);
+		if (profile.isBroadcastEnabled != SDS::Bool::False)
+			options_out.Add(CachedOption::Broadcast, SOL_SOCKET, SO_BROADCAST, 1);
+
+		if (profile.typeOfService != (uint8_t)0)
+		{
+			if (addressFamily == AF_INET)
+				options_out.Add(CachedOption::TypeOfService, IPPROTO_IP, IP_TOS, (int)profile.typeOfService);
+			else
+				options_out.Add(CachedOption::TypeOfService, IPPROTO_IPV6, IPV6_TCLASS, (int)profile.typeOfService);
+		}
+
+		//Setting the IPv4 type of service also sets the priority, so the priority is set after it.
+		if (profile.priority != (uint8_t)0)
+			options_out.Add(CachedOption::Priority, SOL_SOCKET, SO_PRIORITY, (int)profile.priority);
+	}
+
+	//For descriptors which aren't registered yet. Call Cache after registering.
+	//The returned bool value is set to false if an option couldn't be set. In that case, the error is already signaled.
+	inline bool Set(int nativeSocket, const Options& options) noexcept
+	{
+		for (auto i = (size_t)0; i < options.count; ++i)
+		{
+			const auto& option = options.options[i];
+			if (setsockopt(nativeSocket, option.level, option.name, &option.value, option.valueSize) != 0)
+			{
+				ErrorHandler::Handle_setsockopt();
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	inline void Cache(NativeHandles::HandleMetadata& metadata, const Options& options) noexcept
+	{
+		for (auto i = (size_t)0; i < options.count; ++i)
+			metadata.CacheOptionValue(options.options[i].cachedOption, options.options[i].cachedValue);
+	}
+
+	//For registered sockets. Options whose cached values are the same are skipped.
+	inline SDS::ErrorIndicator Set(const void* socketHandle, const Options& options) noexcept
+	{
+		auto* const metadata = NativeHandles::GetMetadata(socketHandle);
+		for (auto i = (size_t)0; i < options.count; ++i)
+		{
+			const auto& option = options.options[i];
+
+			//A new IPv4 type of service changes the priority, so the cached priority is forgotten.
+			if (metadata != nullptr && option.level == IPPROTO_IP && option.name == IP_TOS &&
+				!metadata->HasOptionValue(option.cachedOption, option.cachedValue))
+			{
+				metadata->cachedOptionValues[(size_t)NativeHandles::CachedOption::Priority].store((uint32_t)0, std::memory_order_relaxed);
+			}
+
+			if (NativeHandles::SetOption(socketHandle, option.cachedOption, option.level, option.name,
+				&option.value, (uint32_t)option.valueSize, option.cachedValue) == SDS::ErrorIndicator::Error)
+			{
+				return SDS::ErrorIndicator::Error;
+			}
+		}
+
+		return (SDS::ErrorIndicator)1;
+	}
+}
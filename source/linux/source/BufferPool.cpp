@@ -0,0 +1,70 @@
+#include "Utilities/BufferPool.hpp"
+#include "LinuxAPI.hpp"
+
+namespace BufferPool
+{
+    static constexpr auto hugePageSizeFlag = 21 << MAP_HUGE_SHIFT; //2 MiB, which is the slab size.
+    static constexpr auto preferredMemoryPolicy = 1; //MPOL_PREFERRED. The memory is taken from other nodes when the node runs out of it.
+
+    inline static std::byte* _MapTransparentHugePageRegion(size_t size) noexcept;
+
+    std::byte* AllocateRegion(size_t size, int32_t numaNode, bool& isHugePageBacked_out) noexcept
+    {
+        //Reserved huge pages are only available if the administrator has set them up, so their absence is common.
+        auto* region = static_cast<std::byte*>(mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | hugePageSizeFlag, -1, 0));
+        isHugePageBacked_out = region != MAP_FAILED;
+        if (!isHugePageBacked_out)
+        {
+            region = _MapTransparentHugePageRegion(size);
+            if (region == nullptr)
+                return nullptr;
+        }
+
+        //Pages are allocated when they are touched, so binding the untouched region places all its memory.
+        //Binding fails if the system has no NUMA support, then the memory is placed as usual.
+        if (numaNode >= (int32_t)0)
+        {
+            const auto nodeMask = (unsigned long)1 << numaNode;
+            syscall(SYS_mbind, region, size, preferredMemoryPolicy, &nodeMask, sizeof(nodeMask) * CHAR_BIT + (size_t)1, 0);
+        }
+
+        return region;
+    }
+
+    void FreeRegion(std::byte* region, size_t size) noexcept
+    {
+        munmap(region, size); //In this context, it can't fail.
+    }
+
+    int32_t GetCurrentNUMANode() noexcept
+    {
+        unsigned int cpu;
+        unsigned int numaNode;
+        if (syscall(SYS_getcpu, &cpu, &numaNode, nullptr) == -1)
+            return (int32_t)-1;
+
+        return (int32_t)numaNode;
+    }
+
+    std::byte* _MapTransparentHugePageRegion(size_t size) noexcept
+    {
+        //Transparent huge pages are only used for the parts of the region which are aligned to the huge page size,
+        //so more is mapped and the unaligned ends are unmapped.
+        const size_t mappedSize = size + slabSize;
+        auto* const mappedRegion = static_cast<std::byte*>(mmap(nullptr, mappedSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+        if (mappedRegion == MAP_FAILED)
+            return nullptr;
+
+        const auto misalignment = (size_t)(reinterpret_cast<uintptr_t>(mappedRegion) % slabSize);
+        auto* const region = mappedRegion + (misalignment != (size_t)0 ? slabSize - misalignment : (size_t)0);
+        if (region != mappedRegion)
+            munmap(mappedRegion, (size_t)(region - mappedRegion));
+
+        auto* const regionEnd = region + size;
+        if (regionEnd != mappedRegion + mappedSize)
+            munmap(regionEnd, (size_t)(mappedRegion + mappedSize - regionEnd));
+
+        madvise(region, size, MADV_HUGEPAGE); //If transparent huge pages are disabled, it fails and normal pages are used.
+        return region;
+    }
+}
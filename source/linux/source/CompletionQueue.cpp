@@ -0,0 +1,1002 @@
+#include "CompletionQueue.hpp"
+#include "LinuxAPI.hpp"
+#include "State.hpp"
+#include "ErrorHandler.hpp"
+#include "NativeHandles.hpp"
+#include "NativeSocketAddresses.hpp"
+#include "CompletionQueues.hpp"
+#include "Contexts.hpp"
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <cstring>
+#include <new>
+
+namespace SDS
+{
+    //Operations are identified by their indices. Poll requests linked before retried operations are identified by this value.
+    static constexpr auto linkedPollUserData = UINT64_MAX;
+    static constexpr auto maxCapacity = (int32_t)4096;
+    static constexpr auto maxCompletionQueueCount = (uint32_t)1024;
+
+    //The descriptor is used as the index in the registered file table. Older kernels don't allow bigger tables.
+    static constexpr auto maxRegisteredFileCount = (rlim_t)32768;
+
+    struct Operation final
+    {
+        uint64_t tag;
+        void* socketHandle; //Reported by the completion. The socket handle of a destroyed socket is already stale.
+        int nativeSocket;
+        int addressFamily; //Used for accepting. It's the address family of the accepted socket.
+        CompletionType type;
+        msghdr message; //Used for sending and receiving.
+        sockaddr_in6 socketAddress; //Used for connecting. It can hold any IP socket address.
+        socklen_t socketAddressSize;
+    };
+
+    //Reads and writes of the ring indices shared with the system are ordered with acquire and release semantics.
+    struct CompletionQueue final
+    {
+        int ring = -1;
+        void* ringMemory = MAP_FAILED;
+        size_t ringMemorySize = 0;
+        io_uring_sqe* submissionQueueEntries = static_cast<io_uring_sqe*>(MAP_FAILED);
+        size_t submissionQueueEntriesSize = 0;
+
+        uint32_t* submissionQueueHead;
+        uint32_t* submissionQueueTail;
+        uint32_t* submissionQueueArray;
+        uint32_t submissionQueueMask;
+        uint32_t submissionQueueEntryCount;
+        uint32_t pendingSubmissionCount = 0;
+        uint32_t queuedCloseCount = 0; //The handles of the closed sockets are already stale, so the closes must complete before the ring is closed.
+
+        uint32_t* completionQueueHead;
+        uint32_t* completionQueueTail;
+        io_uring_cqe* completionQueueEntries;
+        uint32_t completionQueueMask;
+
+        std::vector<Operation> operations;
+        std::vector<uint32_t> freeOperationIndices;
+
+        //Sockets are registered lazily, on their first operation. The flags are written under the registered files mutex,
+        //so a socket destroyed by another thread is never registered after it was forgotten.
+        std::mutex registeredFilesMutex;
+        std::unique_ptr<std::atomic<bool>[]> isFileRegistered;
+        size_t registeredFileCount = 0;
+    };
+
+    //A handle keeps the slot index incremented by one in the low half, so it's never null, and the slot generation in the high half.
+    //The generation of a slot changes when its queue is destroyed, so a stale handle is never mistaken for a newer queue which reuses the slot.
+    //Looking up a handle never locks. Creating and destroying queues are rare, so they are allowed to lock.
+    struct CompletionQueueSlot final
+    {
+        std::atomic<CompletionQueue*> queue{ nullptr };
+        std::atomic<uint32_t> generation{ 0 };
+    };
+
+    static std::mutex completionQueuesMutex;
+    static CompletionQueueSlot completionQueueSlots[maxCompletionQueueCount];
+    static std::atomic<size_t> completionQueueCount = 0; //Lets sockets be forgotten without locking while there are no queues.
+
+    //The preferred engine is written under the initialization mutex. The selected engine is published by the Initialize function.
+    static std::atomic<IOEngine> preferredIOEngine = IOEngine::Readiness;
+    static std::atomic<IOEngine> selectedIOEngine = IOEngine::Readiness;
+
+    inline static int _SetUpRing(uint32_t entryCount, io_uring_params& parameters) noexcept;
+    inline static int _EnterRing(int ring, uint32_t submissionCount, uint32_t minCompletionCount,
+        uint32_t flags, const void* argument, size_t argumentSize) noexcept;
+    inline static int _RegisterWithRing(int ring, uint32_t opcode, const void* argument, uint32_t argumentCount) noexcept;
+    inline static bool _IsCompletionEngineSupported() noexcept;
+    inline static bool _MapRing(CompletionQueue& queue, const io_uring_params& parameters) noexcept;
+    inline static void _DrainRing(CompletionQueue& queue) noexcept;
+    inline static void _ReleaseCompletionQueue(CompletionQueue* queue) noexcept;
+    inline static void _FreeCompletionQueueSlot(CompletionQueueSlot& slot) noexcept;
+    inline static CompletionQueue* _ToCompletionQueue(CompletionQueueHandle completionQueueHandle) noexcept;
+    inline static bool _UseRegisteredFile(CompletionQueue& queue, int nativeSocket) noexcept;
+    inline static void _UnregisterFile(CompletionQueue& queue, int nativeSocket) noexcept;
+    inline static bool _SubmitToRing(CompletionQueue& queue) noexcept;
+    inline static bool _ReserveSubmissionQueueEntries(CompletionQueue& queue, uint32_t entryCount) noexcept;
+    inline static io_uring_sqe& _TakeSubmissionQueueEntry(CompletionQueue& queue) noexcept;
+    inline static uint32_t _TakeOperation(CompletionQueue& queue) noexcept;
+    inline static bool _QueueOperation(CompletionQueue& queue, uint32_t operationIndex, bool shouldWaitForReadiness) noexcept;
+    inline static bool _SubmitOperation(CompletionQueue& queue, CompletionType type, SocketHandle socketHandle, uint64_t tag,
+        const BufferSegment* segments = nullptr, int32_t segmentCount = 0) noexcept;
+    inline static bool _CompleteOperation(CompletionQueue& queue, uint32_t operationIndex, int result, Completion& completion_out) noexcept;
+    inline static int32_t _ReapCompletions(CompletionQueue& queue, Completion* completions_out, int32_t completionCapacity) noexcept;
+
+    ErrorIndicator SetPreferredIOEngine(IOEngine ioEngine) noexcept
+    {
+        const std::lock_guard lock(State::initializationMutex);
+        if (State::isInitialized.load(std::memory_order_relaxed))
+        {
+            ErrorHandler::SignalError(Error::IsAlreadyInitialized);
+            return ErrorIndicator::Error;
+        }
+
+        preferredIOEngine.store(ioEngine, std::memory_order_relaxed);
+        return (ErrorIndicator)1;
+    }
+
+    IOEngine GetSelectedIOEngine() noexcept
+    {
+        return selectedIOEngine.load(std::memory_order_relaxed);
+    }
+
+    CompletionQueueHandle CreateCompletionQueue(int32_t capacity) noexcept
+    {
+        if (!State::isInitialized.load(std::memory_order_acquire))
+        {
+            ErrorHandler::SignalError(Error::IsNotInitialized);
+            return nullptr;
+        }
+
+        if (selectedIOEngine.load(std::memory_order_relaxed) != IOEngine::Completion)
+        {
+            ErrorHandler::SignalError(Error::CompletionEngineIsNotSelected);
+            return nullptr;
+        }
+
+        if (capacity < (int32_t)1 || capacity > maxCapacity)
+        {
+            ErrorHandler::SignalError(Error::InvalidCompletionQueueCapacity);
+            return nullptr;
+        }
+
+        auto* const queue = new (std::nothrow) CompletionQueue;
+        if (queue == nullptr)
+        {
+            ErrorHandler::SignalError(Error::NotEnoughMemory);
+            return nullptr;
+        }
+
+        try
+        {
+            queue->operations.resize((size_t)capacity);
+            queue->freeOperationIndices.reserve((size_t)capacity);
+            for (auto i = (uint32_t)capacity; i > (uint32_t)0; --i)
+                queue->freeOperationIndices.push_back(i - (uint32_t)1);
+
+            //Every operation may take two entries at once: a poll request and the operation itself.
+            io_uring_params parameters{};
+            queue->ring = _SetUpRing((uint32_t)capacity * (uint32_t)2, parameters);
+            if (queue->ring == -1)
+            {
+                ErrorHandler::Handle_io_uring_setup();
+                _ReleaseCompletionQueue(queue);
+                return nullptr;
+            }
+
+            if (!_MapRing(*queue, parameters))
+            {
+                _ReleaseCompletionQueue(queue);
+                return nullptr;
+            }
+
+            //The table is sparse, so it costs nothing until sockets are registered.
+            //If it can't be registered, descriptors are passed directly, which is slower but correct.
+            rlimit descriptorLimit;
+            if (getrlimit(RLIMIT_NOFILE, &descriptorLimit) == 0)
+            {
+                const auto registeredFileCount = descriptorLimit.rlim_cur < maxRegisteredFileCount ? descriptorLimit.rlim_cur : maxRegisteredFileCount;
+                const std::vector<int> emptyRegisteredFiles((size_t)registeredFileCount, -1);
+                if (_RegisterWithRing(queue->ring, IORING_REGISTER_FILES, emptyRegisteredFiles.data(), (uint32_t)registeredFileCount) == 0)
+                {
+                    queue->isFileRegistered = std::make_unique<std::atomic<bool>[]>((size_t)registeredFileCount);
+                    queue->registeredFileCount = (size_t)registeredFileCount;
+                }
+            }
+
+            const std::lock_guard lock(completionQueuesMutex);
+            for (auto slotIndex = (uint32_t)0; slotIndex < maxCompletionQueueCount; ++slotIndex)
+            {
+                auto& slot = completionQueueSlots[slotIndex];
+                if (slot.queue.load(std::memory_order_relaxed) == nullptr)
+                {
+                    //The generation was changed before the slot was freed, so a lookup which sees the new queue sees the new generation as well.
+                    slot.queue.store(queue, std::memory_order_release);
+                    completionQueueCount.fetch_add((size_t)1, std::memory_order_release);
+
+                    const uint64_t generation = slot.generation.load(std::memory_order_relaxed);
+                    return reinterpret_cast<CompletionQueueHandle>((generation << 32) | ((uint64_t)slotIndex + (uint64_t)1));
+                }
+            }
+
+            throw std::bad_alloc();
+        }
+        catch (...)
+        {
+            ErrorHandler::SignalError(Error::NotEnoughMemory);
+        }
+
+        _ReleaseCompletionQueue(queue);
+        return nullptr;
+    }
+
+    ErrorIndicator DestroyCompletionQueue(CompletionQueueHandle completionQueueHandle) noexcept
+    {
+        if (!State::isInitialized.load(std::memory_order_acquire))
+        {
+            ErrorHandler::SignalError(Error::IsNotInitialized);
+            return ErrorIndicator::Error;
+        }
+
+        //The queue is looked up and removed at once, so it can't be destroyed twice.
+        CompletionQueue* queue;
+        {
+            const std::lock_guard lock(completionQueuesMutex);
+            queue = _ToCompletionQueue(completionQueueHandle);
+            if (queue == nullptr)
+                return ErrorIndicator::Error;
+
+            _FreeCompletionQueueSlot(completionQueueSlots[(uint32_t)reinterpret_cast<uint64_t>(completionQueueHandle) - (uint32_t)1]);
+        }
+
+        _ReleaseCompletionQueue(queue);
+        return (ErrorIndicator)1;
+    }
+
+    ErrorIndicator SubmitAccept(CompletionQueueHandle completionQueueHandle, SocketHandle listeningSocketHandle, uint64_t tag) noexcept
+    {
+        const ErrorHandler::SocketScope socketScope(listeningSocketHandle);
+        auto* const queue = _ToCompletionQueue(completionQueueHandle);
+        if (queue == nullptr || !_SubmitOperation(*queue, CompletionType::Accept, listeningSocketHandle, tag))
+            return ErrorIndicator::Error;
+
+        return (ErrorIndicator)1;
+    }
+
+    SocketHandle SubmitConnect(CompletionQueueHandle completionQueueHandle, const ErrorIPSocketAddress* destinationInNetworkBO, uint64_t tag) noexcept
+    {
+        auto* const queue = _ToCompletionQueue(completionQueueHandle);
+        if (queue == nullptr)
+            return nullptr;
+
+        if (destinationInNetworkBO == nullptr)
+        {
+            ErrorHandler::SignalError(Error::PassedPointerIsNull);
+            return nullptr;
+        }
+
+        if (destinationInNetworkBO->port == (uint16_t)0)
+        {
+            ErrorHandler::SignalError(Error::PortNumberIsInvalid);
+            return nullptr;
+        }
+
+        const uint32_t operationIndex = _TakeOperation(*queue);
+        if (operationIndex == UINT32_MAX)
+            return nullptr;
+
+        const uint64_t connectionStartTimestamp = Statistics::GetTimestamp();
+        auto& operation = queue->operations[operationIndex];
+        operation.socketAddressSize = NativeSocketAddresses::ToNative(*destinationInNetworkBO, operation.socketAddress);
+
+        const int connectingSocket = socket(operation.socketAddress.sin6_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, IPPROTO_TCP);
+        if (connectingSocket == -1)
+        {
+            ErrorHandler::Handle_socket(operation.socketAddress.sin6_family, SOCK_STREAM, IPPROTO_TCP);
+            queue->freeOperationIndices.push_back(operationIndex);
+            return nullptr;
+        }
+
+        auto* const connectingSocketHandle = NativeHandles::Register(connectingSocket,
+            NativeHandles::HandleRole::ConnectingTCPSocket, operation.socketAddress.sin6_family);
+        if (connectingSocketHandle == nullptr)
+        {
+            queue->freeOperationIndices.push_back(operationIndex);
+            return nullptr;
+        }
+
+        auto* const metadata = NativeHandles::GetMetadata(connectingSocketHandle);
+        metadata->connectionStartTimestamp.store(connectionStartTimestamp, std::memory_order_relaxed);
+        Statistics::Count(&metadata->counters, Statistics::Counter::ConnectCount);
+
+        operation.tag = tag;
+        operation.socketHandle = connectingSocketHandle;
+        operation.nativeSocket = connectingSocket;
+        operation.type = CompletionType::Connect;
+        if (!_QueueOperation(*queue, operationIndex, false))
+        {
+            queue->freeOperationIndices.push_back(operationIndex);
+            close(NativeHandles::Unregister(connectingSocketHandle, false)); //In this context, it doesn't matter if it fails.
+            return nullptr;
+        }
+
+        return connectingSocketHandle;
+    }
+
+    ErrorIndicator SubmitSend(CompletionQueueHandle completionQueueHandle,
+        SocketHandle connectedSocketHandle, const BufferSegment* segments, int32_t segmentCount, uint64_t tag) noexcept
+    {
+        const ErrorHandler::SocketScope socketScope(connectedSocketHandle);
+        auto* const queue = _ToCompletionQueue(completionQueueHandle);
+        if (queue == nullptr ||
+            !_SubmitOperation(*queue, CompletionType::Send, connectedSocketHandle, tag, segments, segmentCount))
+        {
+            return ErrorIndicator::Error;
+        }
+
+        return (ErrorIndicator)1;
+    }
+
+    ErrorIndicator SubmitReceive(CompletionQueueHandle completionQueueHandle,
+        SocketHandle connectedSocketHandle, const BufferSegment* segments, int32_t segmentCount, uint64_t tag) noexcept
+    {
+        const ErrorHandler::SocketScope socketScope(connectedSocketHandle);
+        auto* const queue = _ToCompletionQueue(completionQueueHandle);
+        if (queue == nullptr ||
+            !_SubmitOperation(*queue, CompletionType::Receive, connectedSocketHandle, tag, segments, segmentCount))
+        {
+            return ErrorIndicator::Error;
+        }
+
+        return (ErrorIndicator)1;
+    }
+
+    ErrorIndicator SubmitDestroySocket(CompletionQueueHandle completionQueueHandle, SocketHandle socketHandle, uint64_t tag) noexcept
+    {
+        const ErrorHandler::SocketScope socketScope(socketHandle);
+        auto* const queue = _ToCompletionQueue(completionQueueHandle);
+        if (queue == nullptr || !_SubmitOperation(*queue, CompletionType::DestroySocket, socketHandle, tag))
+            return ErrorIndicator::Error;
+
+        return (ErrorIndicator)1;
+    }
+
+    ErrorIndicator WaitForCompletions(CompletionQueueHandle completionQueueHandle, Completion* completions_out,
+        int32_t completionCapacity, int32_t timeoutInMilliseconds, int32_t* completionCount_out) noexcept
+    {
+        auto* const queue = _ToCompletionQueue(completionQueueHandle);
+        if (queue == nullptr)
+            return ErrorIndicator::Error;
+
+        if (completions_out == nullptr || completionCount_out == nullptr)
+        {
+            ErrorHandler::SignalError(Error::PassedPointerIsNull);
+            return ErrorIndicator::Error;
+        }
+
+        //Nothing could be reaped, so an infinite wait would never end.
+        if (completionCapacity < (int32_t)1)
+        {
+            ErrorHandler::SignalError(Error::InvalidOutputCapacity);
+            return ErrorIndicator::Error;
+        }
+
+        __kernel_timespec timeout{};
+        timeout.tv_sec = (int64_t)(timeoutInMilliseconds / 1000);
+        timeout.tv_nsec = (int64_t)(timeoutInMilliseconds % 1000) * (int64_t)1000000;
+
+        io_uring_getevents_arg waitArgument{};
+        waitArgument.sigmask_sz = (uint32_t)(_NSIG / 8);
+        waitArgument.ts = timeoutInMilliseconds < (int32_t)0 ? (uint64_t)0 : (uint64_t)reinterpret_cast<uintptr_t>(&timeout);
+
+        auto completionCount = _ReapCompletions(*queue, completions_out, completionCapacity);
+
+        //Retried operations aren't reported, so waiting infinitely must continue until a completion is reaped.
+        //A finite timeout is waited for only once.
+        auto hasWaited = false;
+        auto isTimeoutExpired = false;
+        while (!isTimeoutExpired && (queue->pendingSubmissionCount != (uint32_t)0 ||
+            (completionCount == (int32_t)0 && timeoutInMilliseconds != (int32_t)0 && (!hasWaited || timeoutInMilliseconds < (int32_t)0))))
+        {
+            const bool shouldWait = completionCount == (int32_t)0 && timeoutInMilliseconds != (int32_t)0 &&
+                (!hasWaited || timeoutInMilliseconds < (int32_t)0);
+            const int submittedEntryCount = _EnterRing(queue->ring, queue->pendingSubmissionCount, shouldWait ? 1u : 0u,
+                shouldWait ? (uint32_t)(IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG) : 0u,
+                shouldWait ? &waitArgument : nullptr, shouldWait ? sizeof(io_uring_getevents_arg) : (size_t)0);
+            if (submittedEntryCount == -1)
+            {
+                if (errno == EINTR)
+                    break;
+
+                //EBUSY means that the completions must be reaped first.
+                isTimeoutExpired = errno == ETIME;
+                if (!isTimeoutExpired && errno != EBUSY)
+                {
+                    ErrorHandler::Handle_io_uring_enter();
+                    *completionCount_out = completionCount;
+                    return ErrorIndicator::Error;
+                }
+            }
+            else
+            {
+                queue->pendingSubmissionCount -= (uint32_t)submittedEntryCount;
+            }
+
+            hasWaited |= shouldWait;
+            completionCount += _ReapCompletions(*queue, completions_out + completionCount, completionCapacity - completionCount);
+        }
+
+        *completionCount_out = completionCount;
+        return (ErrorIndicator)1;
+    }
+
+    inline int _SetUpRing(uint32_t entryCount, io_uring_params& parameters) noexcept
+    {
+        return (int)syscall(__NR_io_uring_setup, entryCount, &parameters);
+    }
+
+    inline int _EnterRing(int ring, uint32_t submissionCount, uint32_t minCompletionCount,
+        uint32_t flags, const void* argument, size_t argumentSize) noexcept
+    {
+        return (int)syscall(__NR_io_uring_enter, ring, submissionCount, minCompletionCount, flags, argument, argumentSize);
+    }
+
+    inline int _RegisterWithRing(int ring, uint32_t opcode, const void* argument, uint32_t argumentCount) noexcept
+    {
+        return (int)syscall(__NR_io_uring_register, ring, opcode, argument, argumentCount);
+    }
+
+    //The system may lack io_uring, have it disabled or lack the needed operations and features.
+    inline bool _IsCompletionEngineSupported() noexcept
+    {
+        static constexpr auto requiredFeatures = (uint32_t)(IORING_FEAT_SINGLE_MMAP | IORING_FEAT_NODROP | IORING_FEAT_SUBMIT_STABLE |
+            IORING_FEAT_FAST_POLL | IORING_FEAT_POLL_32BITS | IORING_FEAT_EXT_ARG | IORING_FEAT_CQE_SKIP);
+        static constexpr uint8_t requiredOperations[]
+        {
+            IORING_OP_ACCEPT, IORING_OP_CONNECT, IORING_OP_SENDMSG, IORING_OP_RECVMSG, IORING_OP_CLOSE, IORING_OP_POLL_ADD,
+        };
+
+        io_uring_params parameters{};
+        const int ring = _SetUpRing(1u, parameters);
+        if (ring == -1)
+            return false;
+
+        alignas(io_uring_probe) std::byte probeMemory[sizeof(io_uring_probe) + sizeof(io_uring_probe_op) * IORING_OP_LAST]{};
+        auto& probe = *reinterpret_cast<io_uring_probe*>(probeMemory);
+
+        auto isSupported = (parameters.features & requiredFeatures) == requiredFeatures &&
+            _RegisterWithRing(ring, IORING_REGISTER_PROBE, &probe, (uint32_t)IORING_OP_LAST) == 0;
+        for (const auto requiredOperation : requiredOperations)
+            isSupported = isSupported && requiredOperation <= probe.last_op && (probe.ops[requiredOperation].flags & IO_URING_OP_SUPPORTED) != 0;
+
+        close(ring); //In this context, it doesn't matter if it fails.
+        return isSupported;
+    }
+
+    inline bool _MapRing(CompletionQueue& queue, const io_uring_params& parameters) noexcept
+    {
+        //Both rings share one mapping because IORING_FEAT_SINGLE_MMAP is required.
+        const size_t submissionQueueSize = parameters.sq_off.array + parameters.sq_entries * sizeof(uint32_t);
+        const size_t completionQueueSize = parameters.cq_off.cqes + parameters.cq_entries * sizeof(io_uring_cqe);
+        queue.ringMemorySize = submissionQueueSize > completionQueueSize ? submissionQueueSize : completionQueueSize;
+        queue.ringMemory = mmap(nullptr, queue.ringMemorySize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, queue.ring, IORING_OFF_SQ_RING);
+        if (queue.ringMemory == MAP_FAILED)
+        {
+            ErrorHandler::Handle_mmap();
+            return false;
+        }
+
+        queue.submissionQueueEntriesSize = parameters.sq_entries * sizeof(io_uring_sqe);
+        queue.submissionQueueEntries = static_cast<io_uring_sqe*>(mmap(nullptr, queue.submissionQueueEntriesSize,
+            PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, queue.ring, IORING_OFF_SQES));
+        if (queue.submissionQueueEntries == MAP_FAILED)
+        {
+            ErrorHandler::Handle_mmap();
+            return false;
+        }
+
+        auto* const ringMemory = static_cast<std::byte*>(queue.ringMemory);
+        queue.submissionQueueHead = reinterpret_cast<uint32_t*>(ringMemory + parameters.sq_off.head);
+        queue.submissionQueueTail = reinterpret_cast<uint32_t*>(ringMemory + parameters.sq_off.tail);
+        queue.submissionQueueArray = reinterpret_cast<uint32_t*>(ringMemory + parameters.sq_off.array);
+        queue.submissionQueueMask = *reinterpret_cast<uint32_t*>(ringMemory + parameters.sq_off.ring_mask);
+        queue.submissionQueueEntryCount = parameters.sq_entries;
+
+        queue.completionQueueHead = reinterpret_cast<uint32_t*>(ringMemory + parameters.cq_off.head);
+        queue.completionQueueTail = reinterpret_cast<uint32_t*>(ringMemory + parameters.cq_off.tail);
+        queue.completionQueueEntries = reinterpret_cast<io_uring_cqe*>(ringMemory + parameters.cq_off.cqes);
+        queue.completionQueueMask = *reinterpret_cast<uint32_t*>(ringMemory + parameters.cq_off.ring_mask);
+
+        return true;
+    }
+
+    //Closing the ring cancels pending operations, but it neither submits queued entries nor closes sockets accepted into unreaped completions.
+    //So the queued closes are submitted and waited for, and the sockets accepted meanwhile are closed. Nothing is reported.
+    inline void _DrainRing(CompletionQueue& queue) noexcept
+    {
+        while (true)
+        {
+            uint32_t head = *queue.completionQueueHead;
+            const uint32_t tail = __atomic_load_n(queue.completionQueueTail, __ATOMIC_ACQUIRE);
+            for (; head != tail; ++head)
+            {
+                const auto& entry = queue.completionQueueEntries[head & queue.completionQueueMask];
+                if (entry.user_data == linkedPollUserData)
+                    continue;
+
+                const auto& operation = queue.operations[(size_t)entry.user_data];
+                if (operation.type == CompletionType::Accept && entry.res >= 0)
+                    close(entry.res); //In this context, it doesn't matter if it fails.
+                else if (operation.type == CompletionType::DestroySocket)
+                    --queue.queuedCloseCount;
+            }
+
+            __atomic_store_n(queue.completionQueueHead, head, __ATOMIC_RELEASE);
+            if (queue.pendingSubmissionCount == (uint32_t)0 && queue.queuedCloseCount == (uint32_t)0)
+                return;
+
+            const uint32_t minCompletionCount = queue.queuedCloseCount != (uint32_t)0 ? 1u : 0u;
+            const int submittedEntryCount = _EnterRing(queue.ring, queue.pendingSubmissionCount, minCompletionCount,
+                minCompletionCount != 0u ? (uint32_t)IORING_ENTER_GETEVENTS : 0u, nullptr, (size_t)0);
+            if (submittedEntryCount == -1)
+            {
+                //EBUSY means that the completions must be reaped first. Any other failure leaves the rest to closing the ring.
+                if (errno != EINTR && errno != EBUSY)
+                    return;
+            }
+            else
+            {
+                queue.pendingSubmissionCount -= (uint32_t)submittedEntryCount;
+            }
+        }
+    }
+
+    //Closing the ring cancels all pending operations and releases the registered files.
+    inline void _ReleaseCompletionQueue(CompletionQueue* queue) noexcept
+    {
+        if (queue->submissionQueueEntries != MAP_FAILED && queue->ringMemory != MAP_FAILED)
+            _DrainRing(*queue);
+
+        if (queue->submissionQueueEntries != MAP_FAILED)
+            munmap(queue->submissionQueueEntries, queue->submissionQueueEntriesSize);
+        if (queue->ringMemory != MAP_FAILED)
+            munmap(queue->ringMemory, queue->ringMemorySize);
+        if (queue->ring != -1)
+            close(queue->ring); //In this context, it doesn't matter if it fails.
+
+        delete queue;
+    }
+
+    //Must be called with the queues mutex locked.
+    inline void _FreeCompletionQueueSlot(CompletionQueueSlot& slot) noexcept
+    {
+        slot.generation.store(slot.generation.load(std::memory_order_relaxed) + (uint32_t)1, std::memory_order_relaxed);
+        slot.queue.store(nullptr, std::memory_order_release);
+        completionQueueCount.fetch_sub((size_t)1, std::memory_order_release);
+    }
+
+    //Handles of destroyed queues aren't dereferenced, because their slots either are empty or have newer generations.
+    inline CompletionQueue* _ToCompletionQueue(CompletionQueueHandle completionQueueHandle) noexcept
+    {
+        if (!State::isInitialized.load(std::memory_order_acquire))
+        {
+            ErrorHandler::SignalError(Error::IsNotInitialized);
+            return nullptr;
+        }
+
+        const auto handle = reinterpret_cast<uint64_t>(completionQueueHandle);
+        const auto slotNumber = (uint32_t)handle;
+        if (slotNumber != (uint32_t)0 && slotNumber <= maxCompletionQueueCount)
+        {
+            //The queue is read before the generation, so a newer queue is never returned for a stale handle.
+            const auto& slot = completionQueueSlots[slotNumber - (uint32_t)1];
+            auto* const queue = slot.queue.load(std::memory_order_acquire);
+            if (queue != nullptr && slot.generation.load(std::memory_order_relaxed) == (uint32_t)(handle >> 32))
+                return queue;
+        }
+
+        ErrorHandler::SignalError(Error::InvalidCompletionQueueHandle);
+        return nullptr;
+    }
+
+    //Registered files save the descriptor lookup and reference counting on every operation.
+    //The returned value is false if the descriptor must be passed directly. It's not an error.
+    inline bool _UseRegisteredFile(CompletionQueue& queue, int nativeSocket) noexcept
+    {
+        if (nativeSocket < 0 || (size_t)nativeSocket >= queue.registeredFileCount)
+            return false;
+
+        auto& isFileRegistered = queue.isFileRegistered[(size_t)nativeSocket];
+        if (isFileRegistered.load(std::memory_order_acquire))
+            return true;
+
+        const std::lock_guard lock(queue.registeredFilesMutex);
+        io_uring_files_update update{};
+        update.offset = (uint32_t)nativeSocket;
+        update.fds = (uint64_t)reinterpret_cast<uintptr_t>(&nativeSocket);
+        if (_RegisterWithRing(queue.ring, IORING_REGISTER_FILES_UPDATE, &update, 1u) != 1)
+            return false;
+
+        isFileRegistered.store(true, std::memory_order_release);
+        return true;
+    }
+
+    //Must be called with the registered files mutex of the queue locked.
+    inline void _UnregisterFile(CompletionQueue& queue, int nativeSocket) noexcept
+    {
+        if (nativeSocket < 0 || (size_t)nativeSocket >= queue.registeredFileCount ||
+            !queue.isFileRegistered[(size_t)nativeSocket].load(std::memory_order_relaxed))
+            return;
+
+        static constexpr int emptyRegisteredFile = -1;
+        io_uring_files_update update{};
+        update.offset = (uint32_t)nativeSocket;
+        update.fds = (uint64_t)reinterpret_cast<uintptr_t>(&emptyRegisteredFile);
+        _RegisterWithRing(queue.ring, IORING_REGISTER_FILES_UPDATE, &update, 1u); //In this context, it doesn't matter if it fails.
+
+        queue.isFileRegistered[(size_t)nativeSocket].store(false, std::memory_order_release);
+    }
+
+    inline bool _SubmitToRing(CompletionQueue& queue) noexcept
+    {
+        while (queue.pendingSubmissionCount != (uint32_t)0)
+        {
+            const int submittedEntryCount = _EnterRing(queue.ring, queue.pendingSubmissionCount, 0u, 0u, nullptr, (size_t)0);
+            if (submittedEntryCount == -1)
+            {
+                if (errno == EINTR)
+                    continue;
+
+                ErrorHandler::Handle_io_uring_enter();
+                return false;
+            }
+
+            queue.pendingSubmissionCount -= (uint32_t)submittedEntryCount;
+        }
+
+        return true;
+    }
+
+    //The ring has twice as many entries as the queue capacity, so it's only full if the entries were never submitted.
+    inline bool _ReserveSubmissionQueueEntries(CompletionQueue& queue, uint32_t entryCount) noexcept
+    {
+        const uint32_t usedEntryCount = *queue.submissionQueueTail - __atomic_load_n(queue.submissionQueueHead, __ATOMIC_ACQUIRE);
+        return queue.submissionQueueEntryCount - usedEntryCount >= entryCount || _SubmitToRing(queue);
+    }
+
+    inline io_uring_sqe& _TakeSubmissionQueueEntry(CompletionQueue& queue) noexcept
+    {
+        const uint32_t tail = *queue.submissionQueueTail;
+        const uint32_t index = tail & queue.submissionQueueMask;
+
+        auto& entry = queue.submissionQueueEntries[index];
+        std::memset(&entry, 0, sizeof(io_uring_sqe));
+        queue.submissionQueueArray[index] = index;
+
+        __atomic_store_n(queue.submissionQueueTail, tail + (uint32_t)1, __ATOMIC_RELEASE);
+        ++queue.pendingSubmissionCount;
+        return entry;
+    }
+
+    //The returned value is UINT32_MAX if the queue is full.
+    inline uint32_t _TakeOperation(CompletionQueue& queue) noexcept
+    {
+        if (queue.freeOperationIndices.empty())
+        {
+            ErrorHandler::SignalError(Error::TooManyPendingOperations);
+            return UINT32_MAX;
+        }
+
+        const uint32_t operationIndex = queue.freeOperationIndices.back();
+        queue.freeOperationIndices.pop_back();
+        return operationIndex;
+    }
+
+    //If shouldWaitForReadiness is true, the operation is linked after a poll request, so it's issued only when the socket is ready.
+    //It's needed because operations on non-blocking sockets fail with EAGAIN instead of waiting.
+    inline bool _QueueOperation(CompletionQueue& queue, uint32_t operationIndex, bool shouldWaitForReadiness) noexcept
+    {
+        const auto& operation = queue.operations[operationIndex];
+        const bool isFileRegistered = operation.type != CompletionType::DestroySocket && _UseRegisteredFile(queue, operation.nativeSocket);
+        const auto fileFlags = isFileRegistered ? (uint8_t)IOSQE_FIXED_FILE : (uint8_t)0;
+
+        if (!_ReserveSubmissionQueueEntries(queue, shouldWaitForReadiness ? 2u : 1u))
+            return false;
+
+        if (shouldWaitForReadiness)
+        {
+            //The poll request produces a completion only if it fails. In that case, the operation is canceled.
+            auto& pollEntry = _TakeSubmissionQueueEntry(queue);
+            pollEntry.opcode = IORING_OP_POLL_ADD;
+            pollEntry.flags = (uint8_t)(fileFlags | IOSQE_IO_LINK | IOSQE_CQE_SKIP_SUCCESS);
+            pollEntry.fd = operation.nativeSocket;
+            pollEntry.poll32_events = operation.type == CompletionType::Accept || operation.type == CompletionType::Receive ?
+                (uint32_t)POLLIN : (uint32_t)POLLOUT;
+            pollEntry.user_data = linkedPollUserData;
+        }
+
+        auto& entry = _TakeSubmissionQueueEntry(queue);
+        entry.flags = fileFlags;
+        entry.fd = operation.nativeSocket;
+        entry.user_data = (uint64_t)operationIndex;
+        switch (operation.type)
+        {
+        case CompletionType::Accept:
+            entry.opcode = IORING_OP_ACCEPT;
+            entry.accept_flags = (uint32_t)(SOCK_NONBLOCK | SOCK_CLOEXEC);
+            break;
+
+        case CompletionType::Connect:
+            entry.opcode = IORING_OP_CONNECT;
+            entry.addr = (uint64_t)reinterpret_cast<uintptr_t>(&operation.socketAddress);
+            entry.off = (uint64_t)operation.socketAddressSize;
+            break;
+
+        case CompletionType::Send:
+            entry.opcode = IORING_OP_SENDMSG;
+            entry.addr = (uint64_t)reinterpret_cast<uintptr_t>(&operation.message);
+            entry.len = 1u;
+            entry.msg_flags = (uint32_t)MSG_NOSIGNAL;
+            break;
+
+        case CompletionType::Receive:
+            entry.opcode = IORING_OP_RECVMSG;
+            entry.addr = (uint64_t)reinterpret_cast<uintptr_t>(&operation.message);
+            entry.len = 1u;
+            break;
+
+        case CompletionType::DestroySocket:
+            entry.opcode = IORING_OP_CLOSE;
+            break;
+        }
+
+        return true;
+    }
+
+    inline bool _SubmitOperation(CompletionQueue& queue, CompletionType type, SocketHandle socketHandle, uint64_t tag,
+        const BufferSegment* segments, int32_t segmentCount) noexcept
+    {
+        if (type == CompletionType::Send || type == CompletionType::Receive)
+        {
+            if (segments == nullptr)
+            {
+                ErrorHandler::SignalError(Error::PassedPointerIsNull);
+                return false;
+            }
+
+            if (segmentCount < (int32_t)1 || segmentCount > (int32_t)IOV_MAX)
+            {
+                ErrorHandler::SignalError(Error::TooManyBufferSegments);
+                return false;
+            }
+        }
+
+        NativeHandles::HandleMetadata* metadata;
+        int nativeSocket = NativeHandles::ToNativeHandle(socketHandle, metadata);
+        if (metadata == nullptr)
+        {
+            ErrorHandler::SignalError(Error::InvalidSocketHandle);
+            return false;
+        }
+
+        const uint32_t operationIndex = _TakeOperation(queue);
+        if (operationIndex == UINT32_MAX)
+            return false;
+
+        //The socket handle must become stale before the descriptor can be reused by a new socket.
+        //Only one of the concurrent calls with the same handle can succeed, so the descriptor is never closed twice.
+        if (type == CompletionType::DestroySocket)
+        {
+            nativeSocket = NativeHandles::Unregister(socketHandle, false);
+            if (nativeSocket == -1)
+            {
+                queue.freeOperationIndices.push_back(operationIndex);
+                ErrorHandler::SignalError(Error::InvalidSocketHandle);
+                return false;
+            }
+
+            CompletionQueues::Forget(nativeSocket);
+        }
+
+        auto& operation = queue.operations[operationIndex];
+        operation.tag = tag;
+        operation.socketHandle = socketHandle;
+        operation.nativeSocket = nativeSocket;
+        operation.addressFamily = metadata->addressFamily;
+        operation.type = type;
+        operation.message = {};
+        operation.message.msg_iov = reinterpret_cast<iovec*>(const_cast<BufferSegment*>(segments));
+        operation.message.msg_iovlen = (size_t)segmentCount;
+
+        if (!_QueueOperation(queue, operationIndex, false))
+        {
+            queue.freeOperationIndices.push_back(operationIndex);
+            if (type == CompletionType::DestroySocket)
+                close(nativeSocket); //The handle is already invalid, so the socket is destroyed anyway.
+
+            return false;
+        }
+
+        if (type == CompletionType::DestroySocket)
+            ++queue.queuedCloseCount;
+
+        return true;
+    }
+
+    //The returned value is false if the operation was retried, so there is no completion to report.
+    inline bool _CompleteOperation(CompletionQueue& queue, uint32_t operationIndex, int result, Completion& completion_out) noexcept
+    {
+        const auto& operation = queue.operations[operationIndex];
+        const ErrorHandler::SocketScope socketScope(operation.socketHandle);
+        const int errorCode = -result;
+        auto hasFailed = result < 0;
+        if (operation.type == CompletionType::DestroySocket)
+            --queue.queuedCloseCount;
+
+        //The socket wasn't ready. EINTR can only be returned if the operation was interrupted before it was started.
+        if (hasFailed && operation.type != CompletionType::DestroySocket &&
+            (errorCode == EAGAIN || errorCode == EWOULDBLOCK || errorCode == EINTR || errorCode == EINPROGRESS || errorCode == EALREADY))
+        {
+            if (_QueueOperation(queue, operationIndex, true))
+                return false;
+        }
+        //Linux passes the already pending network errors of the new connection to accept. The connection is dropped,
+        //so the next one is accepted.
+        else if (hasFailed && operation.type == CompletionType::Accept && (errorCode == ECONNABORTED || errorCode == ENETDOWN ||
+            errorCode == EPROTO || errorCode == ENOPROTOOPT || errorCode == EHOSTDOWN || errorCode == ENONET ||
+            errorCode == EHOSTUNREACH || errorCode == ENETUNREACH))
+        {
+            if (_QueueOperation(queue, operationIndex, false))
+                return false;
+        }
+        //A repeated connection attempt reports that the first one has succeeded. The descriptor is released even if close fails.
+        else if ((operation.type == CompletionType::Connect && errorCode == EISCONN) ||
+            (operation.type == CompletionType::DestroySocket && errorCode == EINPROGRESS))
+        {
+            hasFailed = false;
+        }
+        else if (hasFailed)
+        {
+            errno = errorCode;
+            switch (operation.type)
+            {
+            case CompletionType::Accept:
+                ErrorHandler::Handle_accept();
+                break;
+
+            case CompletionType::Connect:
+                ErrorHandler::Handle_connect();
+                break;
+
+            case CompletionType::Send:
+                ErrorHandler::Handle_sendmsg();
+                break;
+
+            case CompletionType::Receive:
+                ErrorHandler::Handle_recvmsg();
+                break;
+
+            case CompletionType::DestroySocket:
+                ErrorHandler::Handle_close();
+                break;
+            }
+        }
+
+        completion_out.tag = operation.tag;
+        completion_out.socketHandle = operation.socketHandle;
+        completion_out.transferredByteCount = (size_t)0;
+        completion_out.status = hasFailed ? TransferStatus::Error : TransferStatus::Transferred;
+        completion_out.type = operation.type;
+
+        if (!hasFailed)
+        {
+            switch (operation.type)
+            {
+            case CompletionType::Accept:
+            {
+                //The accepted socket belongs to the context of the listening socket.
+                const Contexts::Scope scope(NativeHandles::GetContextIndex(operation.socketHandle));
+                NativeHandles::RecordAcceptQueueDwell(result);
+                completion_out.socketHandle = NativeHandles::Register(result,
+                    NativeHandles::HandleRole::ConnectedTCPSocket, operation.addressFamily);
+                if (completion_out.socketHandle == nullptr)
+                    completion_out.status = TransferStatus::Error;
+                else
+                    Statistics::Count(Statistics::FindSocketCounters(operation.socketHandle), Statistics::Counter::AcceptCount);
+                break;
+            }
+
+            case CompletionType::Connect:
+            {
+                auto* const metadata = NativeHandles::GetMetadata(operation.socketHandle);
+                if (metadata != nullptr)
+                    metadata->RecordConnectionEstablishment();
+                break;
+            }
+
+            case CompletionType::Send:
+            {
+                auto* const counters = Statistics::FindSocketCounters(operation.socketHandle);
+                Statistics::Count(counters, Statistics::Counter::SendCallCount);
+                Statistics::Count(counters, Statistics::Counter::SentByteCount, (uint64_t)result);
+                completion_out.transferredByteCount = (size_t)result;
+                break;
+            }
+
+            case CompletionType::Receive:
+            {
+                auto* const counters = Statistics::FindSocketCounters(operation.socketHandle);
+                Statistics::Count(counters, Statistics::Counter::ReceiveCallCount);
+                Statistics::Count(counters, Statistics::Counter::ReceivedByteCount, (uint64_t)result);
+                completion_out.transferredByteCount = (size_t)result;
+                if (result == 0)
+                {
+                    //Nothing can be received into empty segments, so it doesn't mean that the connection is closed.
+                    for (size_t i = 0; i < operation.message.msg_iovlen; ++i)
+                    {
+                        if (operation.message.msg_iov[i].iov_len != (size_t)0)
+                        {
+                            completion_out.status = TransferStatus::ConnectionClosed;
+                            break;
+                        }
+                    }
+                }
+                break;
+            }
+
+            default:
+                break;
+            }
+        }
+        else if (operation.type == CompletionType::Accept)
+        {
+            completion_out.socketHandle = nullptr;
+        }
+
+        queue.freeOperationIndices.push_back(operationIndex);
+        return true;
+    }
+
+    inline int32_t _ReapCompletions(CompletionQueue& queue, Completion* completions_out, int32_t completionCapacity) noexcept
+    {
+        uint32_t head = *queue.completionQueueHead;
+        const uint32_t tail = __atomic_load_n(queue.completionQueueTail, __ATOMIC_ACQUIRE);
+
+        auto completionCount = (int32_t)0;
+        for (; head != tail && completionCount < completionCapacity; ++head)
+        {
+            const auto& entry = queue.completionQueueEntries[head & queue.completionQueueMask];
+
+            //A failed poll request cancels the linked operation, which reports the failure itself.
+            if (entry.user_data != linkedPollUserData &&
+                _CompleteOperation(queue, (uint32_t)entry.user_data, entry.res, completions_out[completionCount]))
+            {
+                ++completionCount;
+            }
+        }
+
+        __atomic_store_n(queue.completionQueueHead, head, __ATOMIC_RELEASE);
+        return completionCount;
+    }
+}
+
+void CompletionQueues::SelectIOEngine() noexcept
+{
+    SDS::selectedIOEngine.store(SDS::preferredIOEngine.load(std::memory_order_relaxed) == SDS::IOEngine::Completion &&
+        SDS::_IsCompletionEngineSupported() ? SDS::IOEngine::Completion : SDS::IOEngine::Readiness, std::memory_order_relaxed);
+}
+
+void CompletionQueues::Forget(int nativeHandle) noexcept
+{
+    if (SDS::completionQueueCount.load(std::memory_order_acquire) == (size_t)0)
+        return;
+
+    const std::lock_guard lock(SDS::completionQueuesMutex);
+    for (auto& slot : SDS::completionQueueSlots)
+    {
+        auto* const queue = slot.queue.load(std::memory_order_relaxed);
+        if (queue != nullptr)
+        {
+            const std::lock_guard registeredFilesLock(queue->registeredFilesMutex);
+            SDS::_UnregisterFile(*queue, nativeHandle);
+        }
+    }
+}
+
+void CompletionQueues::DestroyAll() noexcept
+{
+    const std::lock_guard lock(SDS::completionQueuesMutex);
+    for (auto& slot : SDS::completionQueueSlots)
+    {
+        auto* const queue = slot.queue.load(std::memory_order_relaxed);
+        if (queue != nullptr)
+        {
+            SDS::_FreeCompletionQueueSlot(slot);
+            SDS::_ReleaseCompletionQueue(queue);
+        }
+    }
+}
@@ -0,0 +1,222 @@
+#include "Context.hpp"
+#include "LinuxAPI.hpp"
+#include "State.hpp"
+#include "ErrorHandler.hpp"
+#include "Contexts.hpp"
+#include "NativeHandles.hpp"
+
+namespace SDS
+{
+    template<typename ResultType, typename CreateFunction>
+    inline static ResultType _CreateInContext(ContextHandle contextHandle, ResultType errorResult, CreateFunction create) noexcept;
+
+    ContextHandle CreateContext() noexcept
+    {
+        if (!State::isInitialized.load(std::memory_order_acquire))
+        {
+            ErrorHandler::SignalError(Error::IsNotInitialized);
+            return nullptr;
+        }
+
+        auto* const contextHandle = Contexts::Create();
+        if (contextHandle == nullptr)
+            ErrorHandler::SignalError(Error::ContextLimitIsReached);
+
+        return contextHandle;
+    }
+
+    ErrorIndicator DestroyContext(ContextHandle contextHandle) noexcept
+    {
+        const int32_t contextIndex = Contexts::Destroy(contextHandle);
+        if (contextIndex == (int32_t)-1)
+        {
+            ErrorHandler::SignalError(Error::InvalidContextHandle);
+            return ErrorIndicator::Error;
+        }
+
+        //The handle is already stale, so no socket can be created in the context while its sockets are being closed.
+        NativeHandles::CloseAll((uint32_t)contextIndex);
+        return (ErrorIndicator)1;
+    }
+
+    ErrorIndicator SetContextErrorOccuredCallback(ContextHandle contextHandle, ErrorOccuredCallback callback, void* callbackContext)
+    {
+        const int32_t contextIndex = Contexts::ToIndex(contextHandle);
+        if (contextIndex == (int32_t)-1)
+        {
+            ErrorHandler::SignalError(Error::InvalidContextHandle);
+            return ErrorIndicator::Error;
+        }
+
+        ErrorHandler::SetCallback(callback, callbackContext, (uint32_t)contextIndex);
+        return (ErrorIndicator)1;
+    }
+
+    ErrorIndicator BindThreadToContext(ContextHandle contextHandle) noexcept
+    {
+        const int32_t contextIndex = Contexts::ToIndex(contextHandle);
+        if (contextIndex == (int32_t)-1)
+        {
+            ErrorHandler::SignalError(Error::InvalidContextHandle);
+            return ErrorIndicator::Error;
+        }
+
+        Contexts::BindCurrentThread((uint32_t)contextIndex);
+        return (ErrorIndicator)1;
+    }
+
+    SocketHandle CreateIPv4UDPSocketInContext(ContextHandle contextHandle, IPv4Address ipv4Address, uint16_t* portNumberInHostBO_inout) noexcept
+    {
+        return CreateIPv4UDPSocketInContextWithProfile(contextHandle, ipv4Address, portNumberInHostBO_inout, nullptr);
+    }
+
+    SocketHandle CreateIPv6UDPSocketInContext(ContextHandle contextHandle, IPv6Address ipv6AddressInNetworkBO, uint16_t* portNumberInHostBO_inout) noexcept
+    {
+        return CreateIPv6UDPSocketInContextWithProfile(contextHandle, ipv6AddressInNetworkBO, portNumberInHostBO_inout, nullptr);
+    }
+
+    SocketHandle CreateListeningIPv4TCPSocketInContext(ContextHandle contextHandle, IPv4Address ipv4Address,
+        uint16_t* portNumberInHostBO_inout, uint32_t pendingConnectionQueueSize) noexcept
+    {
+        return CreateListeningIPv4TCPSocketInContextWithProfile(contextHandle, ipv4Address, portNumberInHostBO_inout,
+            pendingConnectionQueueSize, nullptr);
+    }
+
+    SocketHandle CreateListeningIPv6TCPSocketInContext(ContextHandle contextHandle, IPv6Address ipv6AddressInNetworkBO,
+        uint16_t* portNumberInHostBO_inout, uint32_t pendingConnectionQueueSize) noexcept
+    {
+        return CreateListeningIPv6TCPSocketInContextWithProfile(contextHandle, ipv6AddressInNetworkBO, portNumberInHostBO_inout,
+            pendingConnectionQueueSize, nullptr);
+    }
+
+    ErrorIndicator CreateListeningIPv4TCPSocketGroupInContext(ContextHandle contextHandle, IPv4Address ipv4Address,
+        uint16_t* portNumberInHostBO_inout, uint32_t pendingConnectionQueueSize, int32_t listeningSocketCount, Bool shouldSteerByCPU,
+        SocketHandle* listeningSocketHandles_out) noexcept
+    {
+        return CreateListeningIPv4TCPSocketGroupInContextWithProfile(contextHandle, ipv4Address, portNumberInHostBO_inout,
+            pendingConnectionQueueSize, listeningSocketCount, shouldSteerByCPU, listeningSocketHandles_out, nullptr);
+    }
+
+    ErrorIndicator CreateListeningIPv6TCPSocketGroupInContext(ContextHandle contextHandle, IPv6Address ipv6AddressInNetworkBO,
+        uint16_t* portNumberInHostBO_inout, uint32_t pendingConnectionQueueSize, int32_t listeningSocketCount, Bool shouldSteerByCPU,
+        SocketHandle* listeningSocketHandles_out) noexcept
+    {
+        return CreateListeningIPv6TCPSocketGroupInContextWithProfile(contextHandle, ipv6AddressInNetworkBO, portNumberInHostBO_inout,
+            pendingConnectionQueueSize, listeningSocketCount, shouldSteerByCPU, listeningSocketHandles_out, nullptr);
+    }
+
+    SocketHandle CreateConnectedIPv4TCPSocketInContext(ContextHandle contextHandle, uint16_t portNumberToConnectFromInHostBO,
+        IPv4Address ipv4AddressToConnectTo, uint16_t portNumberToConnectToInHostBO) noexcept
+    {
+        return CreateConnectedIPv4TCPSocketInContextWithProfile(contextHandle, portNumberToConnectFromInHostBO,
+            ipv4AddressToConnectTo, portNumberToConnectToInHostBO, nullptr);
+    }
+
+    SocketHandle CreateConnectedIPv6TCPSocketInContext(ContextHandle contextHandle, uint16_t portNumberToConnectFromInHostBO,
+        IPv6Address ipv6AddressToConnectToInHostBO, uint16_t portNumberToConnectToInHostBO) noexcept
+    {
+        return CreateConnectedIPv6TCPSocketInContextWithProfile(contextHandle, portNumberToConnectFromInHostBO,
+            ipv6AddressToConnectToInHostBO, portNumberToConnectToInHostBO, nullptr);
+    }
+
+    PollerHandle CreatePollerInContext(ContextHandle contextHandle) noexcept
+    {
+        return _CreateInContext(contextHandle, (PollerHandle)nullptr, []()
+            {
+                return CreatePoller();
+            });
+    }
+
+    SocketHandle CreateIPv4UDPSocketInContextWithProfile(ContextHandle contextHandle, IPv4Address ipv4Address,
+        uint16_t* portNumberInHostBO_inout, const SocketProfile* profile) noexcept
+    {
+        return _CreateInContext(contextHandle, (SocketHandle)nullptr, [&]()
+            {
+                return CreateIPv4UDPSocketWithProfile(ipv4Address, portNumberInHostBO_inout, profile);
+            });
+    }
+
+    SocketHandle CreateIPv6UDPSocketInContextWithProfile(ContextHandle contextHandle, IPv6Address ipv6AddressInNetworkBO,
+        uint16_t* portNumberInHostBO_inout, const SocketProfile* profile) noexcept
+    {
+        return _CreateInContext(contextHandle, (SocketHandle)nullptr, [&]()
+            {
+                return CreateIPv6UDPSocketWithProfile(ipv6AddressInNetworkBO, portNumberInHostBO_inout, profile);
+            });
+    }
+
+    SocketHandle CreateListeningIPv4TCPSocketInContextWithProfile(ContextHandle contextHandle, IPv4Address ipv4Address,
+        uint16_t* portNumberInHostBO_inout, uint32_t pendingConnectionQueueSize, const SocketProfile* profile) noexcept
+    {
+        return _CreateInContext(contextHandle, (SocketHandle)nullptr, [&]()
+            {
+                return CreateListeningIPv4TCPSocketWithProfile(ipv4Address, portNumberInHostBO_inout, pendingConnectionQueueSize, profile);
+            });
+    }
+
+    SocketHandle CreateListeningIPv6TCPSocketInContextWithProfile(ContextHandle contextHandle, IPv6Address ipv6AddressInNetworkBO,
+        uint16_t* portNumberInHostBO_inout, uint32_t pendingConnectionQueueSize, const SocketProfile* profile) noexcept
+    {
+        return _CreateInContext(contextHandle, (SocketHandle)nullptr, [&]()
+            {
+                return CreateListeningIPv6TCPSocketWithProfile(ipv6AddressInNetworkBO, portNumberInHostBO_inout, pendingConnectionQueueSize, profile);
+            });
+    }
+
+    ErrorIndicator CreateListeningIPv4TCPSocketGroupInContextWithProfile(ContextHandle contextHandle, IPv4Address ipv4Address,
+        uint16_t* portNumberInHostBO_inout, uint32_t pendingConnectionQueueSize, int32_t listeningSocketCount, Bool shouldSteerByCPU,
+        SocketHandle* listeningSocketHandles_out, const SocketProfile* profile) noexcept
+    {
+        return _CreateInContext(contextHandle, ErrorIndicator::Error, [&]()
+            {
+                return CreateListeningIPv4TCPSocketGroupWithProfile(ipv4Address, portNumberInHostBO_inout, pendingConnectionQueueSize,
+                    listeningSocketCount, shouldSteerByCPU, listeningSocketHandles_out, profile);
+            });
+    }
+
+    ErrorIndicator CreateListeningIPv6TCPSocketGroupInContextWithProfile(ContextHandle contextHandle, IPv6Address ipv6AddressInNetworkBO,
+        uint16_t* portNumberInHostBO_inout, uint32_t pendingConnectionQueueSize, int32_t listeningSocketCount, Bool shouldSteerByCPU,
+        SocketHandle* listeningSocketHandles_out, const SocketProfile* profile) noexcept
+    {
+        return _CreateInContext(contextHandle, ErrorIndicator::Error, [&]()
+            {
+                return CreateListeningIPv6TCPSocketGroupWithProfile(ipv6AddressInNetworkBO, portNumberInHostBO_inout, pendingConnectionQueueSize,
+                    listeningSocketCount, shouldSteerByCPU, listeningSocketHandles_out, profile);
+            });
+    }
+
+    SocketHandle CreateConnectedIPv4TCPSocketInContextWithProfile(ContextHandle contextHandle, uint16_t portNumberToConnectFromInHostBO,
+        IPv4Address ipv4AddressToConnectTo, uint16_t portNumberToConnectToInHostBO, const SocketProfile* profile) noexcept
+    {
+        return _CreateInContext(contextHandle, (SocketHandle)nullptr, [&]()
+            {
+                return CreateConnectedIPv4TCPSocketWithProfile(portNumberToConnectFromInHostBO, ipv4AddressToConnectTo,
+                    portNumberToConnectToInHostBO, profile);
+            });
+    }
+
+    SocketHandle CreateConnectedIPv6TCPSocketInContextWithProfile(ContextHandle contextHandle, uint16_t portNumberToConnectFromInHostBO,
+        IPv6Address ipv6AddressToConnectToInHostBO, uint16_t portNumberToConnectToInHostBO, const SocketProfile* profile) noexcept
+    {
+        return _CreateInContext(contextHandle, (SocketHandle)nullptr, [&]()
+            {
+                return CreateConnectedIPv6TCPSocketWithProfile(portNumberToConnectFromInHostBO, ipv6AddressToConnectToInHostBO,
+                    portNumberToConnectToInHostBO, profile);
+            });
+    }
+
+    //The calling thread works on the context only for the duration of the call, so its own binding is unchanged.
+    template<typename ResultType, typename CreateFunction>
+    inline ResultType _CreateInContext(ContextHandle contextHandle, ResultType errorResult, CreateFunction create) noexcept
+    {
+        const int32_t contextIndex = Contexts::ToIndex(contextHandle);
+        if (contextIndex == (int32_t)-1)
+        {
+            ErrorHandler::SignalError(Error::InvalidContextHandle);
+            return errorResult;
+        }
+
+        const Contexts::Scope scope((uint32_t)contextIndex);
+        return create();
+    }
+}
\ No newline at end of file
@@ -0,0 +1,840 @@
+#include "DataTransfer.hpp"
+#include "LinuxAPI.hpp"
+#include "ErrorHandler.hpp"
+#include "NativeHandles.hpp"
+#include "NativeSocketAddresses.hpp"
+#include "Statistics.hpp"
+#include <cstddef>
+#include <cstring>
+#include <atomic>
+
+namespace SDS
+{
+    //The segments are passed to the system without conversion.
+    static_assert(sizeof(BufferSegment) == sizeof(iovec) &&
+        offsetof(BufferSegment, data) == offsetof(iovec, iov_base) && offsetof(BufferSegment, size) == offsetof(iovec, iov_len));
+
+    static constexpr auto maxBatchChunkSize = (int32_t)64;
+    static constexpr auto maxSegmentedDatagramSize = (size_t)65507; //The maximum UDP payload of an IPv4 datagram.
+    static constexpr auto maxSegmentedDatagramCount = (size_t)64; //Older kernels don't accept more segments.
+
+    static std::atomic<size_t> zeroCopySendThreshold = (size_t)10240;
+
+    static constexpr auto maxFileChunkSize = (uint64_t)0x7FFFF000; //The maximum byte count transferred by one system call.
+    static constexpr auto preferredPipeCapacity = 1048576; //The default capacity of 64 KiB would need many calls for large files.
+
+    //The pipe is reused by the thread. It's closed when the thread exits or after an error, so no stale data is left in it.
+    struct SplicePipe final
+    {
+        int readingEnd = -1;
+        int writingEnd = -1;
+        size_t capacity = 0;
+
+        ~SplicePipe() noexcept
+        {
+            Close();
+        }
+
+        void Close() noexcept
+        {
+            if (readingEnd != -1)
+            {
+                close(readingEnd); //In this context, it doesn't matter if it fails.
+                close(writingEnd);
+                readingEnd = writingEnd = -1;
+            }
+        }
+    };
+
+    static thread_local SplicePipe splicePipe;
+
+    inline static bool _AreSegmentsValid(const BufferSegment* segments, int32_t segmentCount, const void* byteCount_out) noexcept;
+    inline static bool _AreDatagramsValid(const Datagram* datagrams, int32_t datagramCount, const int32_t* datagramCount_out) noexcept;
+    inline static TransferStatus _SendMessage(SocketHandle socketHandle, msghdr& message, size_t& sentByteCount_out, int flags = 0) noexcept;
+    inline static TransferStatus _ReceiveMessage(SocketHandle socketHandle, msghdr& message, size_t& receivedByteCount_out) noexcept;
+    inline static bool _OpenSplicePipe() noexcept;
+    inline static int _ToNativeHandle(SocketHandle socketHandle, Statistics::SocketCounters*& counters_out) noexcept;
+
+    TransferStatus Send(SocketHandle connectedSocketHandle, const BufferSegment* segments, int32_t segmentCount, size_t* sentByteCount_out) noexcept
+    {
+        const ErrorHandler::SocketScope socketScope(connectedSocketHandle);
+        if (!_AreSegmentsValid(segments, segmentCount, sentByteCount_out))
+            return TransferStatus::Error;
+
+        msghdr message{};
+        message.msg_iov = reinterpret_cast<iovec*>(const_cast<BufferSegment*>(segments));
+        message.msg_iovlen = (size_t)segmentCount;
+
+        return _SendMessage(connectedSocketHandle, message, *sentByteCount_out);
+    }
+
+    TransferStatus Receive(SocketHandle connectedSocketHandle, const BufferSegment* segments, int32_t segmentCount, size_t* receivedByteCount_out) noexcept
+    {
+        const ErrorHandler::SocketScope socketScope(connectedSocketHandle);
+        if (!_AreSegmentsValid(segments, segmentCount, receivedByteCount_out))
+            return TransferStatus::Error;
+
+        msghdr message{};
+        message.msg_iov = reinterpret_cast<iovec*>(const_cast<BufferSegment*>(segments));
+        message.msg_iovlen = (size_t)segmentCount;
+
+        const auto transferStatus = _ReceiveMessage(connectedSocketHandle, message, *receivedByteCount_out);
+        if (transferStatus == TransferStatus::Transferred && *receivedByteCount_out == (size_t)0)
+        {
+            //Zero bytes mean the end of the stream only if there was some space to receive into.
+            for (auto i = 0; i < segmentCount; ++i)
+                if (segments[i].size != (size_t)0)
+                    return TransferStatus::ConnectionClosed;
+        }
+
+        return transferStatus;
+    }
+
+    TransferStatus SendTo(SocketHandle udpSocketHandle, const BufferSegment* segments, int32_t segmentCount,
+        const ErrorIPSocketAddress* destinationInNetworkBO, size_t* sentByteCount_out) noexcept
+    {
+        const ErrorHandler::SocketScope socketScope(udpSocketHandle);
+        if (!_AreSegmentsValid(segments, segmentCount, sentByteCount_out))
+            return TransferStatus::Error;
+
+        if (destinationInNetworkBO == nullptr)
+        {
+            ErrorHandler::SignalError(Error::PassedPointerIsNull);
+            return TransferStatus::Error;
+        }
+
+        sockaddr_in6 destination; //Used as a buffer for any IP address family.
+
+        msghdr message{};
+        message.msg_name = &destination;
+        message.msg_namelen = NativeSocketAddresses::ToNative(*destinationInNetworkBO, destination);
+        message.msg_iov = reinterpret_cast<iovec*>(const_cast<BufferSegment*>(segments));
+        message.msg_iovlen = (size_t)segmentCount;
+
+        return _SendMessage(udpSocketHandle, message, *sentByteCount_out);
+    }
+
+    TransferStatus ReceiveFrom(SocketHandle udpSocketHandle, const BufferSegment* segments, int32_t segmentCount,
+        ErrorIPSocketAddress* sourceInNetworkBO_out, size_t* receivedByteCount_out) noexcept
+    {
+        const ErrorHandler::SocketScope socketScope(udpSocketHandle);
+        if (!_AreSegmentsValid(segments, segmentCount, receivedByteCount_out))
+            return TransferStatus::Error;
+
+        sockaddr_in6 source; //Used as a buffer for any IP address family.
+
+        msghdr message{};
+        if (sourceInNetworkBO_out != nullptr)
+        {
+            message.msg_name = &source;
+            message.msg_namelen = (socklen_t)sizeof(sockaddr_in6);
+        }
+
+        message.msg_iov = reinterpret_cast<iovec*>(const_cast<BufferSegment*>(segments));
+        message.msg_iovlen = (size_t)segmentCount;
+
+        const auto transferStatus = _ReceiveMessage(udpSocketHandle, message, *receivedByteCount_out);
+        if (transferStatus == TransferStatus::Error || transferStatus == TransferStatus::WouldBlock)
+            return transferStatus;
+
+        if (sourceInNetworkBO_out != nullptr)
+            NativeSocketAddresses::FromNative(source, message.msg_namelen, *sourceInNetworkBO_out);
+
+        if ((message.msg_flags & MSG_TRUNC) != 0)
+            return TransferStatus::DatagramIsTruncated;
+
+        return transferStatus;
+    }
+
+    TransferStatus SendDatagramBatch(SocketHandle udpSocketHandle, Datagram* datagrams, int32_t datagramCount, int32_t* sentDatagramCount_out) noexcept
+    {
+        const ErrorHandler::SocketScope socketScope(udpSocketHandle);
+        if (!_AreDatagramsValid(datagrams, datagramCount, sentDatagramCount_out))
+            return TransferStatus::Error;
+
+        Statistics::SocketCounters* counters;
+        const int nativeSocket = _ToNativeHandle(udpSocketHandle, counters);
+
+        mmsghdr messages[maxBatchChunkSize];
+        sockaddr_in6 destinations[maxBatchChunkSize]; //Used as buffers for any IP address family.
+
+        auto sentDatagramCount = (int32_t)0;
+        while (sentDatagramCount < datagramCount)
+        {
+            const auto chunkSize = datagramCount - sentDatagramCount < maxBatchChunkSize ? datagramCount - sentDatagramCount : maxBatchChunkSize;
+            for (auto i = (int32_t)0; i < chunkSize; ++i)
+            {
+                const auto& datagram = datagrams[sentDatagramCount + i];
+
+                messages[i].msg_hdr = {};
+                messages[i].msg_hdr.msg_name = &destinations[i];
+                messages[i].msg_hdr.msg_namelen = NativeSocketAddresses::ToNative(datagram.socketAddressInNetworkBO, destinations[i]);
+                messages[i].msg_hdr.msg_iov = reinterpret_cast<iovec*>(const_cast<BufferSegment*>(datagram.segments));
+                messages[i].msg_hdr.msg_iovlen = (size_t)datagram.segmentCount;
+            }
+
+            const uint64_t sendStartTimestamp = Statistics::GetTimestamp();
+            int chunkSentDatagramCount;
+            do
+                chunkSentDatagramCount = sendmmsg(nativeSocket, messages, (unsigned int)chunkSize, MSG_NOSIGNAL);
+            while (chunkSentDatagramCount == -1 && errno == EINTR);
+
+            Statistics::Record(Statistics::Histogram::SendCall, Statistics::GetTimestamp() - sendStartTimestamp);
+            Statistics::Count(counters, Statistics::Counter::SendCallCount);
+            if (chunkSentDatagramCount == -1)
+            {
+                *sentDatagramCount_out = sentDatagramCount;
+                if (errno == EAGAIN || errno == EWOULDBLOCK)
+                {
+                    Statistics::Count(counters, Statistics::Counter::WouldBlockCount);
+                    return sentDatagramCount != (int32_t)0 ? TransferStatus::Transferred : TransferStatus::WouldBlock;
+                }
+
+                ErrorHandler::Handle_sendmsg();
+                return sentDatagramCount != (int32_t)0 ? TransferStatus::Transferred : TransferStatus::Error;
+            }
+
+            auto chunkSentByteCount = (uint64_t)0;
+            for (auto i = 0; i < chunkSentDatagramCount; ++i)
+            {
+                datagrams[sentDatagramCount + i].transferredByteCount = (size_t)messages[i].msg_len;
+                chunkSentByteCount += (uint64_t)messages[i].msg_len;
+            }
+
+            Statistics::Count(counters, Statistics::Counter::SentByteCount, chunkSentByteCount);
+
+            sentDatagramCount += (int32_t)chunkSentDatagramCount;
+            if (chunkSentDatagramCount < (int)chunkSize)
+                break;
+        }
+
+        *sentDatagramCount_out = sentDatagramCount;
+        return TransferStatus::Transferred;
+    }
+
+    TransferStatus ReceiveDatagramBatch(SocketHandle udpSocketHandle, Datagram* datagrams, int32_t datagramCount, int32_t* receivedDatagramCount_out) noexcept
+    {
+        const ErrorHandler::SocketScope socketScope(udpSocketHandle);
+        if (!_AreDatagramsValid(datagrams, datagramCount, receivedDatagramCount_out))
+            return TransferStatus::Error;
+
+        Statistics::SocketCounters* counters;
+        const int nativeSocket = _ToNativeHandle(udpSocketHandle, counters);
+
+        mmsghdr messages[maxBatchChunkSize];
+        sockaddr_in6 sources[maxBatchChunkSize]; //Used as buffers for any IP address family.
+
+        auto receivedDatagramCount = (int32_t)0;
+        while (receivedDatagramCount < datagramCount)
+        {
+            const auto chunkSize = datagramCount - receivedDatagramCount < maxBatchChunkSize ? datagramCount - receivedDatagramCount : maxBatchChunkSize;
+            for (auto i = (int32_t)0; i < chunkSize; ++i)
+            {
+                const auto& datagram = datagrams[receivedDatagramCount + i];
+
+                messages[i].msg_hdr = {};
+                messages[i].msg_hdr.msg_name = &sources[i];
+                messages[i].msg_hdr.msg_namelen = (socklen_t)sizeof(sockaddr_in6);
+                messages[i].msg_hdr.msg_iov = reinterpret_cast<iovec*>(const_cast<BufferSegment*>(datagram.segments));
+                messages[i].msg_hdr.msg_iovlen = (size_t)datagram.segmentCount;
+            }
+
+            int chunkReceivedDatagramCount;
+            do
+                chunkReceivedDatagramCount = recvmmsg(nativeSocket, messages, (unsigned int)chunkSize, 0, nullptr);
+            while (chunkReceivedDatagramCount == -1 && errno == EINTR);
+
+            Statistics::Count(counters, Statistics::Counter::ReceiveCallCount);
+            if (chunkReceivedDatagramCount == -1)
+            {
+                *receivedDatagramCount_out = receivedDatagramCount;
+                if (errno == EAGAIN || errno == EWOULDBLOCK)
+                {
+                    Statistics::Count(counters, Statistics::Counter::WouldBlockCount);
+                    return receivedDatagramCount != (int32_t)0 ? TransferStatus::Transferred : TransferStatus::WouldBlock;
+                }
+
+                ErrorHandler::Handle_recvmsg();
+                return receivedDatagramCount != (int32_t)0 ? TransferStatus::Transferred : TransferStatus::Error;
+            }
+
+            auto chunkReceivedByteCount = (uint64_t)0;
+            for (auto i = 0; i < chunkReceivedDatagramCount; ++i)
+            {
+                auto& datagram = datagrams[receivedDatagramCount + i];
+
+                NativeSocketAddresses::FromNative(sources[i], messages[i].msg_hdr.msg_namelen, datagram.socketAddressInNetworkBO);
+                datagram.isTruncated = (messages[i].msg_hdr.msg_flags & MSG_TRUNC) != 0 ? Bool::True : Bool::False;
+                datagram.transferredByteCount = (size_t)messages[i].msg_len;
+                chunkReceivedByteCount += (uint64_t)messages[i].msg_len;
+            }
+
+            Statistics::Count(counters, Statistics::Counter::ReceivedByteCount, chunkReceivedByteCount);
+
+            receivedDatagramCount += (int32_t)chunkReceivedDatagramCount;
+            if (chunkReceivedDatagramCount < (int)chunkSize)
+                break;
+        }
+
+        *receivedDatagramCount_out = receivedDatagramCount;
+        return TransferStatus::Transferred;
+    }
+
+    ErrorIndicator SetTCPSocketZeroCopy(SocketHandle tcpSocketHandle, Bool isEnabled) noexcept
+    {
+        const ErrorHandler::SocketScope socketScope(tcpSocketHandle);
+        const int optionValue = isEnabled != Bool::False ? 1 : 0;
+        return NativeHandles::SetOption(tcpSocketHandle, NativeHandles::CachedOption::ZeroCopy, SOL_SOCKET, SO_ZEROCOPY,
+            &optionValue, (uint32_t)sizeof(int), (uint32_t)optionValue);
+    }
+
+    void SetZeroCopySendThreshold(size_t thresholdInBytes) noexcept
+    {
+        zeroCopySendThreshold.store(thresholdInBytes, std::memory_order_relaxed);
+    }
+
+    TransferStatus SendZeroCopy(SocketHandle connectedSocketHandle, const BufferSegment* segments,
+        int32_t segmentCount, size_t* sentByteCount_out, Bool* isZeroCopy_out) noexcept
+    {
+        const ErrorHandler::SocketScope socketScope(connectedSocketHandle);
+        if (!_AreSegmentsValid(segments, segmentCount, sentByteCount_out))
+            return TransferStatus::Error;
+
+        if (isZeroCopy_out == nullptr)
+        {
+            ErrorHandler::SignalError(Error::PassedPointerIsNull);
+            return TransferStatus::Error;
+        }
+
+        msghdr message{};
+        message.msg_iov = reinterpret_cast<iovec*>(const_cast<BufferSegment*>(segments));
+        message.msg_iovlen = (size_t)segmentCount;
+
+        auto totalSize = (size_t)0;
+        for (auto i = (int32_t)0; i < segmentCount; ++i)
+            totalSize += segments[i].size;
+
+        //Without SO_ZEROCOPY, the system silently copies the payload and reports no completion, so it's sent as usual.
+        NativeHandles::HandleMetadata* metadata;
+        const int nativeSocket = NativeHandles::ToNativeHandle(connectedSocketHandle, metadata);
+        *isZeroCopy_out = Bool::False;
+        if (totalSize < zeroCopySendThreshold.load(std::memory_order_relaxed) ||
+            metadata == nullptr || !metadata->HasOptionValue(NativeHandles::CachedOption::ZeroCopy, (uint32_t)1))
+        {
+            return _SendMessage(connectedSocketHandle, message, *sentByteCount_out);
+        }
+
+        auto* const counters = &metadata->counters;
+        const uint64_t sendStartTimestamp = Statistics::GetTimestamp();
+        ssize_t sentByteCount;
+        do
+            sentByteCount = sendmsg(nativeSocket, &message, MSG_ZEROCOPY | MSG_NOSIGNAL);
+        while (sentByteCount == -1 && errno == EINTR);
+
+        //ENOBUFS means that the pinned memory limit of the socket is reached. The payload is copied instead.
+        //The copying send records its own statistics, so the failed call isn't counted.
+        if (sentByteCount == -1 && errno == ENOBUFS)
+            return _SendMessage(connectedSocketHandle, message, *sentByteCount_out);
+
+        Statistics::Record(Statistics::Histogram::SendCall, Statistics::GetTimestamp() - sendStartTimestamp);
+        Statistics::Count(counters, Statistics::Counter::SendCallCount);
+
+        if (sentByteCount == -1)
+        {
+            *sentByteCount_out = (size_t)0;
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+            {
+                Statistics::Count(counters, Statistics::Counter::WouldBlockCount);
+                return TransferStatus::WouldBlock;
+            }
+
+            ErrorHandler::Handle_sendmsg();
+            return TransferStatus::Error;
+        }
+
+        Statistics::Count(counters, Statistics::Counter::SentByteCount, (uint64_t)sentByteCount);
+        *sentByteCount_out = (size_t)sentByteCount;
+        *isZeroCopy_out = Bool::True;
+        return TransferStatus::Transferred;
+    }
+
+    TransferStatus ReceiveZeroCopySendCompletions(SocketHandle connectedSocketHandle,
+        ZeroCopySendCompletion* completions_out, int32_t completionCapacity, int32_t* completionCount_out) noexcept
+    {
+        const ErrorHandler::SocketScope socketScope(connectedSocketHandle);
+        if (completions_out == nullptr || completionCount_out == nullptr)
+        {
+            ErrorHandler::SignalError(Error::PassedPointerIsNull);
+            return TransferStatus::Error;
+        }
+
+        *completionCount_out = (int32_t)0;
+
+        //The system merges consecutive completions, so one message usually reports many sends.
+        //Other entries are errors of the socket. They can't be read again, so they are signaled.
+        auto hasErrorOccured = false;
+        while (*completionCount_out < completionCapacity)
+        {
+            alignas(cmsghdr) std::byte controlMessageBuffer[CMSG_SPACE(sizeof(sock_extended_err) + sizeof(sockaddr_in6))];
+            msghdr message{};
+            message.msg_control = controlMessageBuffer;
+            message.msg_controllen = sizeof(controlMessageBuffer);
+
+            ssize_t result;
+            do
+                result = recvmsg(NativeHandles::ToNativeHandle(connectedSocketHandle), &message, MSG_ERRQUEUE);
+            while (result == -1 && errno == EINTR);
+
+            if (result == -1)
+            {
+                if (errno == EAGAIN || errno == EWOULDBLOCK)
+                    break;
+
+                ErrorHandler::Handle_recvmsg();
+                return *completionCount_out != (int32_t)0 ? TransferStatus::Transferred : TransferStatus::Error;
+            }
+
+            for (const cmsghdr* controlMessage = CMSG_FIRSTHDR(&message); controlMessage != nullptr;
+                controlMessage = CMSG_NXTHDR(&message, const_cast<cmsghdr*>(controlMessage)))
+            {
+                if (!(controlMessage->cmsg_level == SOL_IP && controlMessage->cmsg_type == IP_RECVERR) &&
+                    !(controlMessage->cmsg_level == SOL_IPV6 && controlMessage->cmsg_type == IPV6_RECVERR))
+                    continue;
+
+                sock_extended_err extendedError;
+                std::memcpy(&extendedError, CMSG_DATA(controlMessage), sizeof(sock_extended_err));
+                if (extendedError.ee_errno != 0)
+                {
+                    ErrorHandler::Handle_sock_extended_err((int)extendedError.ee_errno);
+                    hasErrorOccured = true;
+                    continue;
+                }
+
+                if (extendedError.ee_origin != SO_EE_ORIGIN_ZEROCOPY)
+                    continue;
+
+                auto& completion = completions_out[*completionCount_out];
+                completion.firstSendID = extendedError.ee_info;
+                completion.lastSendID = extendedError.ee_data;
+                completion.wasCopied = (extendedError.ee_code & SO_EE_CODE_ZEROCOPY_COPIED) != 0 ? Bool::True : Bool::False;
+                ++*completionCount_out;
+            }
+        }
+
+        if (*completionCount_out != (int32_t)0)
+            return TransferStatus::Transferred;
+
+        return hasErrorOccured ? TransferStatus::Error : TransferStatus::WouldBlock;
+    }
+
+    TransferStatus SendFileRange(SocketHandle connectedSocketHandle, int32_t fileDescriptor,
+        uint64_t offset, uint64_t length, uint64_t* sentByteCount_out) noexcept
+    {
+        const ErrorHandler::SocketScope socketScope(connectedSocketHandle);
+        if (sentByteCount_out == nullptr)
+        {
+            ErrorHandler::SignalError(Error::PassedPointerIsNull);
+            return TransferStatus::Error;
+        }
+
+        *sentByteCount_out = (uint64_t)0;
+
+        Statistics::SocketCounters* counters;
+        const int nativeSocket = _ToNativeHandle(connectedSocketHandle, counters);
+
+        auto fileOffset = (off_t)offset;
+        auto isEndOfFileReached = false;
+        while (*sentByteCount_out < length)
+        {
+            const uint64_t remainingByteCount = length - *sentByteCount_out;
+            const ssize_t sentByteCount = sendfile(nativeSocket, (int)fileDescriptor,
+                &fileOffset, (size_t)(remainingByteCount < maxFileChunkSize ? remainingByteCount : maxFileChunkSize));
+            if (sentByteCount == -1)
+            {
+                if (errno == EINTR)
+                    continue;
+
+                Statistics::Count(counters, Statistics::Counter::SendCallCount);
+                if (errno == EAGAIN || errno == EWOULDBLOCK)
+                {
+                    Statistics::Count(counters, Statistics::Counter::WouldBlockCount);
+                    break;
+                }
+
+                ErrorHandler::Handle_sendfile();
+                return *sentByteCount_out != (uint64_t)0 ? TransferStatus::Transferred : TransferStatus::Error;
+            }
+
+            Statistics::Count(counters, Statistics::Counter::SendCallCount);
+            if (sentByteCount == 0) //The end of the file is reached.
+            {
+                isEndOfFileReached = true;
+                break;
+            }
+
+            Statistics::Count(counters, Statistics::Counter::SentByteCount, (uint64_t)sentByteCount);
+            *sentByteCount_out += (uint64_t)sentByteCount;
+        }
+
+        //Waiting for the socket wouldn't help if the file has ended, so the end of the file isn't reported as TransferStatus::WouldBlock.
+        return *sentByteCount_out != (uint64_t)0 || length == (uint64_t)0 || isEndOfFileReached ?
+            TransferStatus::Transferred : TransferStatus::WouldBlock;
+    }
+
+    TransferStatus SendFileRangeByPath(SocketHandle connectedSocketHandle, const char* filePath,
+        uint64_t offset, uint64_t length, uint64_t* sentByteCount_out) noexcept
+    {
+        const ErrorHandler::SocketScope socketScope(connectedSocketHandle);
+        if (filePath == nullptr || sentByteCount_out == nullptr)
+        {
+            ErrorHandler::SignalError(Error::PassedPointerIsNull);
+            return TransferStatus::Error;
+        }
+
+        int fileDescriptor;
+        do
+            fileDescriptor = open(filePath, O_RDONLY | O_CLOEXEC);
+        while (fileDescriptor == -1 && errno == EINTR);
+
+        if (fileDescriptor == -1)
+        {
+            ErrorHandler::Handle_open();
+            *sentByteCount_out = (uint64_t)0;
+            return TransferStatus::Error;
+        }
+
+        const TransferStatus status = SendFileRange(connectedSocketHandle, (int32_t)fileDescriptor, offset, length, sentByteCount_out);
+        close(fileDescriptor); //In this context, it doesn't matter if it fails.
+        return status;
+    }
+
+    TransferStatus ReceiveToFile(SocketHandle connectedSocketHandle, int32_t fileDescriptor,
+        uint64_t offset, uint64_t length, uint64_t* receivedByteCount_out) noexcept
+    {
+        const ErrorHandler::SocketScope socketScope(connectedSocketHandle);
+        if (receivedByteCount_out == nullptr)
+        {
+            ErrorHandler::SignalError(Error::PassedPointerIsNull);
+            return TransferStatus::Error;
+        }
+
+        *receivedByteCount_out = (uint64_t)0;
+        if (length == (uint64_t)0)
+            return TransferStatus::Transferred;
+
+        if (splicePipe.readingEnd == -1 && !_OpenSplicePipe())
+            return TransferStatus::Error;
+
+        Statistics::SocketCounters* counters;
+        const int nativeSocket = _ToNativeHandle(connectedSocketHandle, counters);
+
+        auto fileOffset = (loff_t)offset;
+        auto isConnectionClosed = false;
+        while (*receivedByteCount_out < length)
+        {
+            const uint64_t remainingByteCount = length - *receivedByteCount_out;
+            const ssize_t receivedByteCount = splice(nativeSocket, nullptr, splicePipe.writingEnd, nullptr,
+                (size_t)(remainingByteCount < (uint64_t)splicePipe.capacity ? remainingByteCount : (uint64_t)splicePipe.capacity),
+                SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+            if (receivedByteCount == -1)
+            {
+                if (errno == EINTR)
+                    continue;
+
+                Statistics::Count(counters, Statistics::Counter::ReceiveCallCount);
+                if (errno == EAGAIN || errno == EWOULDBLOCK)
+                {
+                    Statistics::Count(counters, Statistics::Counter::WouldBlockCount);
+                    break;
+                }
+
+                ErrorHandler::Handle_splice();
+                return *receivedByteCount_out != (uint64_t)0 ? TransferStatus::Transferred : TransferStatus::Error;
+            }
+
+            Statistics::Count(counters, Statistics::Counter::ReceiveCallCount);
+            if (receivedByteCount == 0)
+            {
+                isConnectionClosed = true;
+                break;
+            }
+
+            Statistics::Count(counters, Statistics::Counter::ReceivedByteCount, (uint64_t)receivedByteCount);
+
+            //The pipe is emptied completely, so the next call starts with an empty pipe.
+            for (auto writtenByteCount = (ssize_t)0; writtenByteCount < receivedByteCount;)
+            {
+                const ssize_t result = splice(splicePipe.readingEnd, nullptr, (int)fileDescriptor, &fileOffset,
+                    (size_t)(receivedByteCount - writtenByteCount), SPLICE_F_MOVE);
+                if (result == -1)
+                {
+                    if (errno == EINTR)
+                        continue;
+
+                    ErrorHandler::Handle_splice();
+                    splicePipe.Close();
+                    return TransferStatus::Error;
+                }
+
+                writtenByteCount += result;
+            }
+
+            *receivedByteCount_out += (uint64_t)receivedByteCount;
+        }
+
+        if (*receivedByteCount_out != (uint64_t)0)
+            return TransferStatus::Transferred;
+
+        return isConnectionClosed ? TransferStatus::ConnectionClosed : TransferStatus::WouldBlock;
+    }
+
+    ErrorIndicator SetUDPSocketSegmentationOffload(SocketHandle udpSocketHandle, uint16_t segmentSize) noexcept
+    {
+        const ErrorHandler::SocketScope socketScope(udpSocketHandle);
+        const auto optionValue = (int)segmentSize;
+        return NativeHandles::SetOption(udpSocketHandle, NativeHandles::CachedOption::UDPSegmentation, SOL_UDP, UDP_SEGMENT,
+            &optionValue, (uint32_t)sizeof(int), (uint32_t)optionValue);
+    }
+
+    ErrorIndicator SetUDPSocketCoalescingOffload(SocketHandle udpSocketHandle, Bool isEnabled) noexcept
+    {
+        const ErrorHandler::SocketScope socketScope(udpSocketHandle);
+        const int optionValue = isEnabled != Bool::False ? 1 : 0;
+        return NativeHandles::SetOption(udpSocketHandle, NativeHandles::CachedOption::UDPCoalescing, SOL_UDP, UDP_GRO,
+            &optionValue, (uint32_t)sizeof(int), (uint32_t)optionValue);
+    }
+
+    TransferStatus SendSegmentedDatagrams(SocketHandle udpSocketHandle, const BufferSegment* segments, int32_t segmentCount,
+        const ErrorIPSocketAddress* destinationInNetworkBO, uint16_t segmentSize, size_t* sentByteCount_out) noexcept
+    {
+        const ErrorHandler::SocketScope socketScope(udpSocketHandle);
+        if (!_AreSegmentsValid(segments, segmentCount, sentByteCount_out))
+            return TransferStatus::Error;
+
+        if (destinationInNetworkBO == nullptr)
+        {
+            ErrorHandler::SignalError(Error::PassedPointerIsNull);
+            return TransferStatus::Error;
+        }
+
+        auto totalSize = (size_t)0;
+        for (auto i = 0; i < segmentCount; ++i)
+            totalSize += segments[i].size;
+
+        //The system rejects such datagrams with EINVAL, which can't be distinguished from other errors.
+        if (segmentSize == (uint16_t)0 || totalSize > maxSegmentedDatagramSize ||
+            (totalSize + segmentSize - (size_t)1) / segmentSize > maxSegmentedDatagramCount)
+        {
+            *sentByteCount_out = (size_t)0;
+            ErrorHandler::SignalError(Error::DatagramIsTooLarge);
+            return TransferStatus::Error;
+        }
+
+        sockaddr_in6 destination; //Used as a buffer for any IP address family.
+        alignas(cmsghdr) std::byte control[CMSG_SPACE(sizeof(uint16_t))]{};
+
+        msghdr message{};
+        message.msg_name = &destination;
+        message.msg_namelen = NativeSocketAddresses::ToNative(*destinationInNetworkBO, destination);
+        message.msg_iov = reinterpret_cast<iovec*>(const_cast<BufferSegment*>(segments));
+        message.msg_iovlen = (size_t)segmentCount;
+        message.msg_control = control;
+        message.msg_controllen = sizeof(control);
+
+        auto* const controlMessage = CMSG_FIRSTHDR(&message);
+        controlMessage->cmsg_level = SOL_UDP;
+        controlMessage->cmsg_type = UDP_SEGMENT;
+        controlMessage->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+        std::memcpy(CMSG_DATA(controlMessage), &segmentSize, sizeof(uint16_t));
+
+        return _SendMessage(udpSocketHandle, message, *sentByteCount_out);
+    }
+
+    TransferStatus ReceiveCoalescedDatagrams(SocketHandle udpSocketHandle, const BufferSegment* segments, int32_t segmentCount,
+        ErrorIPSocketAddress* sourceInNetworkBO_out, size_t* receivedByteCount_out, uint16_t* datagramSize_out) noexcept
+    {
+        const ErrorHandler::SocketScope socketScope(udpSocketHandle);
+        if (!_AreSegmentsValid(segments, segmentCount, receivedByteCount_out))
+            return TransferStatus::Error;
+
+        if (datagramSize_out == nullptr)
+        {
+            ErrorHandler::SignalError(Error::PassedPointerIsNull);
+            return TransferStatus::Error;
+        }
+
+        sockaddr_in6 source; //Used as a buffer for any IP address family.
+        alignas(cmsghdr) std::byte control[CMSG_SPACE(sizeof(int))];
+
+        msghdr message{};
+        if (sourceInNetworkBO_out != nullptr)
+        {
+            message.msg_name = &source;
+            message.msg_namelen = (socklen_t)sizeof(sockaddr_in6);
+        }
+
+        message.msg_iov = reinterpret_cast<iovec*>(const_cast<BufferSegment*>(segments));
+        message.msg_iovlen = (size_t)segmentCount;
+        message.msg_control = control;
+        message.msg_controllen = sizeof(control);
+
+        const auto transferStatus = _ReceiveMessage(udpSocketHandle, message, *receivedByteCount_out);
+        if (transferStatus == TransferStatus::Error || transferStatus == TransferStatus::WouldBlock)
+            return transferStatus;
+
+        if (sourceInNetworkBO_out != nullptr)
+            NativeSocketAddresses::FromNative(source, message.msg_namelen, *sourceInNetworkBO_out);
+
+        //The control message is only attached if more than one datagram was merged.
+        *datagramSize_out = (uint16_t)*receivedByteCount_out;
+        for (auto* controlMessage = CMSG_FIRSTHDR(&message); controlMessage != nullptr; controlMessage = CMSG_NXTHDR(&message, controlMessage))
+        {
+            if (controlMessage->cmsg_level == SOL_UDP && controlMessage->cmsg_type == UDP_GRO)
+            {
+                int datagramSize;
+                std::memcpy(&datagramSize, CMSG_DATA(controlMessage), sizeof(int));
+                *datagramSize_out = (uint16_t)datagramSize;
+            }
+        }
+
+        if ((message.msg_flags & MSG_TRUNC) != 0)
+            return TransferStatus::DatagramIsTruncated;
+
+        return transferStatus;
+    }
+
+    //The returned bool value is set to false if the arguments are invalid. In that case, the error is already signaled.
+    inline bool _AreSegmentsValid(const BufferSegment* segments, int32_t segmentCount, const void* byteCount_out) noexcept
+    {
+        if (segments == nullptr || byteCount_out == nullptr)
+        {
+            ErrorHandler::SignalError(Error::PassedPointerIsNull);
+            return false;
+        }
+
+        if (segmentCount < (int32_t)1 || segmentCount > (int32_t)IOV_MAX)
+        {
+            ErrorHandler::SignalError(Error::TooManyBufferSegments);
+            return false;
+        }
+
+        return true;
+    }
+
+    //The returned bool value is set to false if the arguments are invalid. In that case, the error is already signaled.
+    inline bool _AreDatagramsValid(const Datagram* datagrams, int32_t datagramCount, const int32_t* datagramCount_out) noexcept
+    {
+        if (datagrams == nullptr || datagramCount_out == nullptr)
+        {
+            ErrorHandler::SignalError(Error::PassedPointerIsNull);
+            return false;
+        }
+
+        for (auto i = (int32_t)0; i < datagramCount; ++i)
+        {
+            const auto& datagram = datagrams[i];
+            if (datagram.segments == nullptr)
+            {
+                ErrorHandler::SignalError(Error::PassedPointerIsNull);
+                return false;
+            }
+
+            if (datagram.segmentCount < (int32_t)1 || datagram.segmentCount > (int32_t)IOV_MAX)
+            {
+                ErrorHandler::SignalError(Error::TooManyBufferSegments);
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    //MSG_NOSIGNAL prevents the process from being killed by SIGPIPE if another host has closed the connection.
+    inline TransferStatus _SendMessage(SocketHandle socketHandle, msghdr& message, size_t& sentByteCount_out, int flags) noexcept
+    {
+        sentByteCount_out = (size_t)0;
+
+        Statistics::SocketCounters* counters;
+        const int nativeSocket = _ToNativeHandle(socketHandle, counters);
+
+        const uint64_t sendStartTimestamp = Statistics::GetTimestamp();
+        ssize_t sentByteCount;
+        do
+            sentByteCount = sendmsg(nativeSocket, &message, flags | MSG_NOSIGNAL);
+        while (sentByteCount == -1 && errno == EINTR);
+
+        Statistics::Record(Statistics::Histogram::SendCall, Statistics::GetTimestamp() - sendStartTimestamp);
+        Statistics::Count(counters, Statistics::Counter::SendCallCount);
+        if (sentByteCount == -1)
+        {
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+            {
+                Statistics::Count(counters, Statistics::Counter::WouldBlockCount);
+                return TransferStatus::WouldBlock;
+            }
+
+            ErrorHandler::Handle_sendmsg();
+            return TransferStatus::Error;
+        }
+
+        Statistics::Count(counters, Statistics::Counter::SentByteCount, (uint64_t)sentByteCount);
+        sentByteCount_out = (size_t)sentByteCount;
+        return TransferStatus::Transferred;
+    }
+
+    inline TransferStatus _ReceiveMessage(SocketHandle socketHandle, msghdr& message, size_t& receivedByteCount_out) noexcept
+    {
+        receivedByteCount_out = (size_t)0;
+
+        Statistics::SocketCounters* counters;
+        const int nativeSocket = _ToNativeHandle(socketHandle, counters);
+
+        ssize_t receivedByteCount;
+        do
+            receivedByteCount = recvmsg(nativeSocket, &message, 0);
+        while (receivedByteCount == -1 && errno == EINTR);
+
+        Statistics::Count(counters, Statistics::Counter::ReceiveCallCount);
+        if (receivedByteCount == -1)
+        {
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+            {
+                Statistics::Count(counters, Statistics::Counter::WouldBlockCount);
+                return TransferStatus::WouldBlock;
+            }
+
+            ErrorHandler::Handle_recvmsg();
+            return TransferStatus::Error;
+        }
+
+        Statistics::Count(counters, Statistics::Counter::ReceivedByteCount, (uint64_t)receivedByteCount);
+        receivedByteCount_out = (size_t)receivedByteCount;
+        return TransferStatus::Transferred;
+    }
+
+    inline bool _OpenSplicePipe() noexcept
+    {
+        int pipeEnds[2];
+        if (pipe2(pipeEnds, O_CLOEXEC | O_NONBLOCK) != 0)
+        {
+            ErrorHandler::Handle_pipe2();
+            return false;
+        }
+
+        splicePipe.readingEnd = pipeEnds[0];
+        splicePipe.writingEnd = pipeEnds[1];
+
+        //The capacity may be limited by the system. In that case, the default one is used.
+        const int capacity = fcntl(splicePipe.writingEnd, F_SETPIPE_SZ, preferredPipeCapacity);
+        splicePipe.capacity = (size_t)(capacity != -1 ? capacity : fcntl(splicePipe.writingEnd, F_GETPIPE_SZ));
+        return true;
+    }
+
+    inline int _ToNativeHandle(SocketHandle socketHandle, Statistics::SocketCounters*& counters_out) noexcept
+    {
+        NativeHandles::HandleMetadata* metadata;
+        const int nativeHandle = NativeHandles::ToNativeHandle(socketHandle, metadata);
+        counters_out = metadata != nullptr ? &metadata->counters : nullptr;
+        return nativeHandle;
+    }
+}
@@ -0,0 +1,915 @@
+#include "ErrorHandler.hpp"
+#include <cassert>
+
+#define REPORT_ERROR ReportError(error, (int64_t)errorCode)
+
+using namespace SDS;
+
+void ErrorHandler::Handle_getifaddrs() noexcept
+{
+    const int errorCode = errno;
+    assert(errorCode != 0);
+
+    Error error;
+    switch (errorCode)
+    {
+    case ENOMEM:
+    case ENOBUFS:
+        error = Error::NotEnoughMemory;
+        break;
+
+    case EMFILE:
+    case ENFILE:
+        error = Error::SystemSocketLimitIsReached;
+        break;
+
+    default:
+        error = Error::UnexpectedSystemError;
+    }
+
+    REPORT_ERROR;
+}
+
+void ErrorHandler::Handle_socket(int addressFamily, int socketType, int protocol) noexcept
+{
+    const int errorCode = errno;
+    assert(errorCode != 0);
+
+    assert(errorCode != EINVAL); //Invalid arguments
+
+    socketType &= ~(SOCK_NONBLOCK | SOCK_CLOEXEC);
+    assert((addressFamily == AF_INET && socketType == SOCK_STREAM && protocol == IPPROTO_TCP) ||
+        (addressFamily == AF_INET && socketType == SOCK_DGRAM && protocol == IPPROTO_UDP) ||
+        (addressFamily == AF_INET6 && socketType == SOCK_STREAM && protocol == IPPROTO_TCP) ||
+        (addressFamily == AF_INET6 && socketType == SOCK_DGRAM && protocol == IPPROTO_UDP));
+
+    Error error;
+    switch (errorCode)
+    {
+    case EMFILE:
+    case ENFILE:
+        error = Error::SystemSocketLimitIsReached;
+        break;
+
+    case ENOBUFS:
+    case ENOMEM:
+        error = Error::NotEnoughMemory;
+        break;
+
+    case EAFNOSUPPORT:
+        switch (addressFamily)
+        {
+        case AF_INET6:
+            error = Error::IPv6IsNotSupported;
+            break;
+
+        default:
+            error = Error::IPv4IsNotSupported;
+        }
+        break;
+
+    case ESOCKTNOSUPPORT:
+    case EPROTONOSUPPORT:
+        if (addressFamily == AF_INET && socketType == SOCK_STREAM && protocol == IPPROTO_TCP)
+            error = Error::IPv4TCPIsNotSupported;
+        else if (addressFamily == AF_INET && socketType == SOCK_DGRAM && protocol == IPPROTO_UDP)
+            error = Error::IPv4UDPIsNotSupported;
+        else if (addressFamily == AF_INET6 && socketType == SOCK_STREAM && protocol == IPPROTO_TCP)
+            error = Error::IPv6TCPIsNotSupported;
+        else
+            error = Error::IPv6UDPIsNotSupported;
+        break;
+
+    default:
+        error = Error::UnexpectedSystemError;
+    }
+
+    REPORT_ERROR;
+}
+
+void ErrorHandler::Handle_bind() noexcept
+{
+    const int errorCode = errno;
+    assert(errorCode != 0);
+
+    assert(errorCode != EFAULT); //Invalid arguments.
+    assert(errorCode != EINVAL); //The socket is already bound or the address size is invalid.
+
+    Error error;
+    switch (errorCode)
+    {
+    case EADDRNOTAVAIL:
+        error = Error::UnavailableIPAddress;
+        break;
+
+    //The library doesn't use SO_REUSEADDR option so the address can't be shared.
+    //If the port number was zero, it means that all dynamic ports are taken but there is no way to distinguish these cases.
+    case EADDRINUSE:
+        error = Error::SocketAddressIsTaken;
+        break;
+
+    case ENOMEM:
+    case ENOBUFS:
+        error = Error::NotEnoughMemory;
+        break;
+
+    case EBADF:
+    case ENOTSOCK:
+        error = Error::InvalidSocketHandle;
+        break;
+
+    default: //EACCES means that the port number is privileged.
+        error = Error::UnexpectedSystemError;
+    }
+
+    REPORT_ERROR;
+}
+
+void ErrorHandler::Handle_getsockname() noexcept
+{
+    const int errorCode = errno;
+    assert(errorCode != 0);
+
+    assert(errorCode != EFAULT && errorCode != EINVAL); //Invalid arguments.
+
+    Error error;
+    switch (errorCode)
+    {
+    case ENOBUFS:
+        error = Error::NotEnoughMemory;
+        break;
+
+    case EBADF:
+    case ENOTSOCK:
+        error = Error::InvalidSocketHandle;
+        break;
+
+    default:
+        error = Error::UnexpectedSystemError;
+    }
+
+    REPORT_ERROR;
+}
+
+void ErrorHandler::Handle_close() noexcept
+{
+    const int errorCode = errno;
+    assert(errorCode != 0);
+
+    assert(errorCode != EINPROGRESS); //It's not an error.
+
+    Error error;
+    switch (errorCode)
+    {
+    case EBADF:
+        error = Error::InvalidSocketHandle;
+        break;
+
+    default: //EINTR and EIO. The descriptor is released anyway.
+        error = Error::UnexpectedSystemError;
+    }
+
+    REPORT_ERROR;
+}
+
+void ErrorHandler::Handle_setsockopt() noexcept
+{
+    const int errorCode = errno;
+    assert(errorCode != 0);
+
+    assert(errorCode != EFAULT); //Invalid arguments.
+
+    Error error;
+    switch (errorCode)
+    {
+    case EINVAL: //Invalid option value or level for the socket. It can be either the library's fault or the user's fault.
+    case ENOPROTOOPT:
+    case EOPNOTSUPP:
+        error = Error::UnsupportedSocketOption;
+        break;
+
+    case ENOMEM:
+    case ENOBUFS:
+        error = Error::NotEnoughMemory;
+        break;
+
+    case EBADF:
+    case ENOTSOCK:
+        error = Error::InvalidSocketHandle;
+        break;
+
+    default:
+        error = Error::UnexpectedSystemError;
+    }
+
+    REPORT_ERROR;
+}
+
+void ErrorHandler::Handle_getsockopt() noexcept
+{
+    const int errorCode = errno;
+    assert(errorCode != 0);
+
+    assert(errorCode != EFAULT); //Invalid arguments.
+
+    Error error;
+    switch (errorCode)
+    {
+    case EINVAL: //Invalid level for the socket. It can be either the library's fault or the user's fault.
+    case ENOPROTOOPT:
+    case EOPNOTSUPP:
+        error = Error::UnsupportedSocketOption;
+        break;
+
+    case EBADF:
+    case ENOTSOCK:
+        error = Error::InvalidSocketHandle;
+        break;
+
+    default:
+        error = Error::UnexpectedSystemError;
+    }
+
+    REPORT_ERROR;
+}
+
+void ErrorHandler::Handle_listen() noexcept
+{
+    const int errorCode = errno;
+    assert(errorCode != 0);
+
+    assert(errorCode != EOPNOTSUPP); //The socket doesn't support listening mode.
+
+    Error error;
+    switch (errorCode)
+    {
+    case EADDRINUSE: //Another socket is already listening on the same port.
+        error = Error::SocketAddressIsTaken;
+        break;
+
+    case EBADF:
+    case ENOTSOCK:
+        error = Error::InvalidSocketHandle;
+        break;
+
+    default:
+        error = Error::UnexpectedSystemError;
+    }
+
+    REPORT_ERROR;
+}
+
+void ErrorHandler::Handle_accept() noexcept
+{
+    const int errorCode = errno;
+    assert(errorCode != 0);
+
+    assert(errorCode != EFAULT); //Invalid arguments.
+    assert(errorCode != EAGAIN && errorCode != EWOULDBLOCK); //It's not an error.
+    assert(errorCode != ECONNABORTED); //The other host terminated the connection prior to the accept call.
+    assert(errorCode != EINTR); //The call must be repeated.
+
+    Error error;
+    switch (errorCode)
+    {
+    case ENOBUFS:
+    case ENOMEM:
+        error = Error::NotEnoughMemory;
+        break;
+
+    case EMFILE:
+    case ENFILE:
+        error = Error::SystemSocketLimitIsReached;
+        break;
+
+    case EOPNOTSUPP:
+    case EINVAL:
+        error = Error::SocketMustBeInListeningMode;
+        break;
+
+    case EBADF:
+    case ENOTSOCK:
+        error = Error::InvalidSocketHandle;
+        break;
+
+    default: //EPERM means that firewall rules forbid the connection.
+        error = Error::UnexpectedSystemError;
+    }
+
+    REPORT_ERROR;
+}
+
+void ErrorHandler::Handle_getpeername() noexcept
+{
+    const int errorCode = errno;
+    assert(errorCode != 0);
+
+    assert(errorCode != EFAULT && errorCode != EINVAL); //Invalid arguments.
+
+    Error error;
+    switch (errorCode)
+    {
+    case ENOTCONN:
+        error = Error::SocketMustBeConnected;
+        break;
+
+    case ENOBUFS:
+        error = Error::NotEnoughMemory;
+        break;
+
+    case EBADF:
+    case ENOTSOCK:
+        error = Error::InvalidSocketHandle;
+        break;
+
+    default:
+        error = Error::UnexpectedSystemError;
+    }
+
+    REPORT_ERROR;
+}
+
+void ErrorHandler::Handle_connect() noexcept
+{
+    const int errorCode = errno;
+    assert(errorCode != 0);
+
+    assert(errorCode != EFAULT); //Invalid arguments.
+    assert(errorCode != EALREADY && errorCode != EISCONN); //The socket is already connected or connecting.
+    assert(errorCode != EINPROGRESS); //It's not an error.
+
+    Error error;
+    switch (errorCode)
+    {
+    case ENETDOWN:
+        error = Error::NetworkSubsystemFailed;
+        break;
+
+    case ENOBUFS:
+    case ENOMEM:
+        error = Error::NotEnoughMemory;
+        break;
+
+    case ENETUNREACH:
+        error = Error::CannotReachNetwork;
+        break;
+
+    case EHOSTUNREACH:
+        error = Error::CannotReachAnotherHost;
+        break;
+
+    case ECONNREFUSED:
+        error = Error::AnotherHostRejectedConnection;
+        break;
+
+    case ETIMEDOUT:
+        error = Error::CannotEstablishConnection;
+        break;
+
+    case EADDRINUSE: //The local socket address is already connected to the same socket address.
+        error = Error::SocketAddressIsTaken;
+        break;
+
+    case EADDRNOTAVAIL: //Happens if the socket wasn't bound and there are no free dynamic ports.
+        error = Error::AllDynamicPortsAreTaken;
+        break;
+
+    case EAFNOSUPPORT:
+        error = Error::InvalidIPAddress;
+        break;
+
+    case EBADF:
+    case ENOTSOCK:
+        error = Error::InvalidSocketHandle;
+        break;
+
+    default: //EACCES and EPERM mean that firewall rules forbid the connection.
+        error = Error::UnexpectedSystemError;
+    }
+
+    REPORT_ERROR;
+}
+
+void ErrorHandler::Handle_epoll_create1() noexcept
+{
+    const int errorCode = errno;
+    assert(errorCode != 0);
+
+    assert(errorCode != EINVAL); //Invalid arguments.
+
+    Error error;
+    switch (errorCode)
+    {
+    case EMFILE:
+    case ENFILE:
+        error = Error::SystemSocketLimitIsReached;
+        break;
+
+    case ENOMEM:
+        error = Error::NotEnoughMemory;
+        break;
+
+    default:
+        error = Error::UnexpectedSystemError;
+    }
+
+    REPORT_ERROR;
+}
+
+void ErrorHandler::Handle_epoll_ctl() noexcept
+{
+    const int errorCode = errno;
+    assert(errorCode != 0);
+
+    assert(errorCode != EFAULT); //Invalid arguments.
+    assert(errorCode != ELOOP); //Pollers are never added to each other.
+
+    Error error;
+    switch (errorCode)
+    {
+    case EBADF: //Either the poller handle or the socket handle is invalid.
+    case EINVAL: //The poller handle isn't a poller or the socket handle is the poller handle.
+        error = Error::InvalidPollerHandle;
+        break;
+
+    case EPERM: //The descriptor doesn't support polling so it isn't a socket.
+        error = Error::InvalidSocketHandle;
+        break;
+
+    case EEXIST:
+        error = Error::SocketIsAlreadyInPoller;
+        break;
+
+    case ENOENT:
+        error = Error::SocketIsNotInPoller;
+        break;
+
+    case ENOSPC: //The max_user_watches limit is reached.
+        error = Error::SystemPollerLimitIsReached;
+        break;
+
+    case ENOMEM:
+        error = Error::NotEnoughMemory;
+        break;
+
+    default:
+        error = Error::UnexpectedSystemError;
+    }
+
+    REPORT_ERROR;
+}
+
+void ErrorHandler::Handle_epoll_wait() noexcept
+{
+    const int errorCode = errno;
+    assert(errorCode != 0);
+
+    assert(errorCode != EFAULT); //Invalid arguments.
+    assert(errorCode != EINTR); //It's not an error.
+
+    Error error;
+    switch (errorCode)
+    {
+    case EBADF:
+    case EINVAL:
+        error = Error::InvalidPollerHandle;
+        break;
+
+    default:
+        error = Error::UnexpectedSystemError;
+    }
+
+    REPORT_ERROR;
+}
+
+void ErrorHandler::Handle_sendmsg() noexcept
+{
+    const int errorCode = errno;
+    assert(errorCode != 0);
+
+    assert(errorCode != EFAULT); //Invalid arguments.
+    assert(errorCode != EAGAIN && errorCode != EWOULDBLOCK); //It's not an error.
+    assert(errorCode != EINTR); //The call must be repeated.
+
+    Error error;
+    switch (errorCode)
+    {
+    case ENETDOWN:
+        error = Error::NetworkSubsystemFailed;
+        break;
+
+    case EPIPE:
+    case ECONNRESET:
+        error = Error::ConnectionWasReset;
+        break;
+
+    case ENOTCONN:
+    case EDESTADDRREQ:
+        error = Error::SocketMustBeConnected;
+        break;
+
+    case EMSGSIZE:
+        error = Error::DatagramIsTooLarge;
+        break;
+
+    case ENOBUFS:
+    case ENOMEM:
+        error = Error::NotEnoughMemory;
+        break;
+
+    case ENETUNREACH:
+        error = Error::CannotReachNetwork;
+        break;
+
+    case EHOSTUNREACH:
+    case ETIMEDOUT:
+        error = Error::CannotReachAnotherHost;
+        break;
+
+    case ECONNREFUSED: //A previous datagram was rejected by another host.
+        error = Error::AnotherHostRejectedConnection;
+        break;
+
+    case EAFNOSUPPORT:
+    case EINVAL: //The destination address doesn't match the socket's IP version.
+        error = Error::InvalidIPAddress;
+        break;
+
+    case EBADF:
+    case ENOTSOCK:
+        error = Error::InvalidSocketHandle;
+        break;
+
+    default: //EACCES means that the broadcast option isn't enabled for the UDP socket.
+        error = Error::UnexpectedSystemError;
+    }
+
+    REPORT_ERROR;
+}
+
+void ErrorHandler::Handle_recvmsg() noexcept
+{
+    const int errorCode = errno;
+    assert(errorCode != 0);
+
+    assert(errorCode != EFAULT && errorCode != EINVAL); //Invalid arguments.
+    assert(errorCode != EAGAIN && errorCode != EWOULDBLOCK); //It's not an error.
+    assert(errorCode != EINTR); //The call must be repeated.
+
+    Error error;
+    switch (errorCode)
+    {
+    case ECONNRESET:
+        error = Error::ConnectionWasReset;
+        break;
+
+    case ENOTCONN:
+        error = Error::SocketMustBeConnected;
+        break;
+
+    case ENOMEM:
+        error = Error::NotEnoughMemory;
+        break;
+
+    case ENETUNREACH:
+        error = Error::CannotReachNetwork;
+        break;
+
+    case EHOSTUNREACH:
+    case ETIMEDOUT:
+        error = Error::CannotReachAnotherHost;
+        break;
+
+    case ECONNREFUSED: //A previous datagram was rejected by another host.
+        error = Error::AnotherHostRejectedConnection;
+        break;
+
+    case EBADF:
+    case ENOTSOCK:
+        error = Error::InvalidSocketHandle;
+        break;
+
+    default:
+        error = Error::UnexpectedSystemError;
+    }
+
+    REPORT_ERROR;
+}
+
+void ErrorHandler::Handle_io_uring_setup() noexcept
+{
+    const int errorCode = errno;
+    assert(errorCode != 0);
+
+    assert(errorCode != EFAULT && errorCode != EINVAL); //Invalid arguments.
+
+    Error error;
+    switch (errorCode)
+    {
+    case EMFILE:
+    case ENFILE:
+        error = Error::SystemSocketLimitIsReached;
+        break;
+
+    case ENOMEM: //The locked memory limit may be reached as well.
+        error = Error::NotEnoughMemory;
+        break;
+
+    default: //ENOSYS and EPERM can't occur because the support is checked when the engine is selected.
+        error = Error::UnexpectedSystemError;
+    }
+
+    REPORT_ERROR;
+}
+
+void ErrorHandler::Handle_io_uring_enter() noexcept
+{
+    const int errorCode = errno;
+    assert(errorCode != 0);
+
+    assert(errorCode != EFAULT && errorCode != EINVAL); //Invalid arguments.
+    assert(errorCode != EINTR && errorCode != ETIME && errorCode != EBUSY); //It's not an error.
+
+    Error error;
+    switch (errorCode)
+    {
+    case EAGAIN: //The system can't allocate memory for the submitted operations.
+    case ENOMEM:
+        error = Error::NotEnoughMemory;
+        break;
+
+    case EBADF:
+    case EOPNOTSUPP:
+        error = Error::InvalidCompletionQueueHandle;
+        break;
+
+    default:
+        error = Error::UnexpectedSystemError;
+    }
+
+    REPORT_ERROR;
+}
+
+void ErrorHandler::Handle_mmap() noexcept
+{
+    const int errorCode = errno;
+    assert(errorCode != 0);
+
+    assert(errorCode != EINVAL && errorCode != EBADF); //Invalid arguments.
+
+    Error error;
+    switch (errorCode)
+    {
+    case EAGAIN: //The locked memory limit is reached.
+    case ENOMEM:
+        error = Error::NotEnoughMemory;
+        break;
+
+    default:
+        error = Error::UnexpectedSystemError;
+    }
+
+    REPORT_ERROR;
+}
+
+void ErrorHandler::Handle_open() noexcept
+{
+    const int errorCode = errno;
+    assert(errorCode != 0);
+
+    assert(errorCode != EFAULT && errorCode != EINVAL); //Invalid arguments.
+
+    Error error;
+    switch (errorCode)
+    {
+    case ENOENT:
+    case ENOTDIR:
+    case ENAMETOOLONG:
+        error = Error::FileDoesNotExist;
+        break;
+
+    case EACCES:
+    case EPERM:
+        error = Error::FileAccessIsDenied;
+        break;
+
+    case EISDIR:
+    case ENXIO:
+        error = Error::FileIsNotSupported;
+        break;
+
+    case EMFILE:
+    case ENFILE:
+        error = Error::SystemSocketLimitIsReached; //Files and sockets share the descriptor limit.
+        break;
+
+    case ENOMEM:
+        error = Error::NotEnoughMemory;
+        break;
+
+    default:
+        error = Error::UnexpectedSystemError;
+    }
+
+    REPORT_ERROR;
+}
+
+void ErrorHandler::Handle_sendfile() noexcept
+{
+    const int errorCode = errno;
+    assert(errorCode != 0);
+
+    assert(errorCode != EFAULT); //Invalid arguments.
+    assert(errorCode != EAGAIN && errorCode != EWOULDBLOCK); //It's not an error.
+    assert(errorCode != EINTR); //The call must be repeated.
+
+    Error error;
+    switch (errorCode)
+    {
+    case EBADF: //The file isn't opened for reading or the socket handle is invalid. The former is far more likely.
+        error = Error::InvalidFileDescriptor;
+        break;
+
+    case EINVAL: //The file doesn't support memory mapping, e.g. it's a socket.
+    case ESPIPE:
+    case EOVERFLOW:
+        error = Error::FileIsNotSupported;
+        break;
+
+    case EPIPE:
+    case ECONNRESET:
+        error = Error::ConnectionWasReset;
+        break;
+
+    case ENOTCONN:
+        error = Error::SocketMustBeConnected;
+        break;
+
+    case ENOMEM:
+    case ENOBUFS:
+        error = Error::NotEnoughMemory;
+        break;
+
+    default: //EIO means that reading the file failed.
+        error = Error::UnexpectedSystemError;
+    }
+
+    REPORT_ERROR;
+}
+
+void ErrorHandler::Handle_splice() noexcept
+{
+    const int errorCode = errno;
+    assert(errorCode != 0);
+
+    assert(errorCode != EAGAIN && errorCode != EWOULDBLOCK); //It's not an error.
+    assert(errorCode != EINTR); //The call must be repeated.
+    assert(errorCode != ESPIPE); //Offsets are only passed for files.
+
+    Error error;
+    switch (errorCode)
+    {
+    case EBADF: //The file isn't opened for writing or the socket handle is invalid. The former is far more likely.
+        error = Error::InvalidFileDescriptor;
+        break;
+
+    case EINVAL: //The file is opened with O_APPEND or doesn't support splicing.
+        error = Error::FileIsNotSupported;
+        break;
+
+    case ENOSPC:
+    case EDQUOT:
+    case EFBIG:
+        error = Error::NotEnoughDiskSpace;
+        break;
+
+    case ECONNRESET:
+        error = Error::ConnectionWasReset;
+        break;
+
+    case ENOTCONN:
+        error = Error::SocketMustBeConnected;
+        break;
+
+    case ENOMEM:
+        error = Error::NotEnoughMemory;
+        break;
+
+    default: //EIO means that writing to the file failed.
+        error = Error::UnexpectedSystemError;
+    }
+
+    REPORT_ERROR;
+}
+
+void ErrorHandler::Handle_pipe2() noexcept
+{
+    const int errorCode = errno;
+    assert(errorCode != 0);
+
+    assert(errorCode != EFAULT && errorCode != EINVAL); //Invalid arguments.
+
+    Error error;
+    switch (errorCode)
+    {
+    case EMFILE:
+    case ENFILE:
+        error = Error::SystemSocketLimitIsReached; //Pipes and sockets share the descriptor limit.
+        break;
+
+    default:
+        error = Error::UnexpectedSystemError;
+    }
+
+    REPORT_ERROR;
+}
+
+void ErrorHandler::Handle_memfd_create() noexcept
+{
+    const int errorCode = errno;
+    assert(errorCode != 0);
+
+    assert(errorCode != EFAULT && errorCode != EINVAL && errorCode != EBADF); //Invalid arguments.
+
+    Error error;
+    switch (errorCode)
+    {
+    case EMFILE:
+    case ENFILE:
+        error = Error::SystemSocketLimitIsReached; //Memory files and sockets share the descriptor limit.
+        break;
+
+    case ENOMEM:
+        error = Error::NotEnoughMemory;
+        break;
+
+    default:
+        error = Error::UnexpectedSystemError;
+    }
+
+    REPORT_ERROR;
+}
+
+void ErrorHandler::Handle_ftruncate() noexcept
+{
+    const int errorCode = errno;
+    assert(errorCode != 0);
+
+    assert(errorCode != EBADF && errorCode != EINVAL); //Invalid arguments.
+
+    Error error;
+    switch (errorCode)
+    {
+    case EFBIG: //The size is greater than the system allows for one file.
+    case ENOMEM:
+    case ENOSPC:
+        error = Error::NotEnoughMemory;
+        break;
+
+    default:
+        error = Error::UnexpectedSystemError;
+    }
+
+    REPORT_ERROR;
+}
+
+void ErrorHandler::Handle_sock_extended_err(int errorCode) noexcept
+{
+    assert(errorCode != 0);
+
+    Error error;
+    switch (errorCode)
+    {
+    case ECONNREFUSED: //ICMP port unreachable.
+        error = Error::AnotherHostRejectedConnection;
+        break;
+
+    case EHOSTUNREACH:
+    case ETIMEDOUT:
+        error = Error::CannotReachAnotherHost;
+        break;
+
+    case ENETUNREACH:
+        error = Error::CannotReachNetwork;
+        break;
+
+    case EMSGSIZE: //The path MTU is smaller than the sent datagram.
+        error = Error::DatagramIsTooLarge;
+        break;
+
+    case EPIPE:
+    case ECONNRESET:
+        error = Error::ConnectionWasReset;
+        break;
+
+    case ENOBUFS:
+    case ENOMEM:
+        error = Error::NotEnoughMemory;
+        break;
+
+    default:
+        error = Error::UnexpectedSystemError;
+    }
+
+    REPORT_ERROR;
+}
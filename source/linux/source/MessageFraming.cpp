@@ -0,0 +1,322 @@
+#include "MessageFraming.hpp"
+#include "DataTransfer.hpp"
+#include "RingBuffer.hpp"
+#include "LinuxAPI.hpp"
+#include "ErrorHandler.hpp"
+#include "Utilities/Buffer.hpp"
+#include "Utilities/RingBuffer.hpp"
+#include <cstring>
+#include <new>
+
+namespace SDS
+{
+    static constexpr auto maxMaxMessageSize = (size_t)67108864;
+    static constexpr auto maxHeaderSize = (size_t)10; //A varint of 64 bits.
+    static constexpr auto minReceiveBufferCapacity = (size_t)65536; //Small messages are received in batches of at least this size.
+    static constexpr auto maxSendChunkMessageCount = (int32_t)IOV_MAX / (int32_t)2; //Every message takes a header and a payload segment.
+
+    struct MessageFramer final
+    {
+        SocketHandle socketHandle;
+        size_t maxMessageSize;
+
+        RingBuffer receivedBytes;
+        size_t returnedByteCount = (size_t)0; //The messages returned by the last call are consumed by the next one.
+
+        //The rest of a message which the system took only partly.
+        Buffer unsentBytes;
+        size_t unsentByteOffset = (size_t)0;
+        size_t unsentByteCount = (size_t)0;
+
+        uint8_t headers[maxSendChunkMessageCount][maxHeaderSize];
+        BufferSegment segments[maxSendChunkMessageCount * (int32_t)2];
+    };
+
+    inline static MessageFramer* _ToMessageFramer(MessageFramerHandle messageFramerHandle) noexcept;
+    inline static size_t _EncodeHeader(uint64_t messageSize, uint8_t* header_out) noexcept;
+    inline static bool _ParseMessages(MessageFramer& framer, BufferSegment* messages_out, int32_t messageCapacity, int32_t& messageCount_out) noexcept;
+    inline static bool _KeepUnsentBytes(MessageFramer& framer, const BufferSegment* segments, int32_t segmentCount, size_t sentByteCount) noexcept;
+
+    MessageFramerHandle CreateMessageFramer(SocketHandle connectedSocketHandle, size_t maxMessageSize) noexcept
+    {
+        const ErrorHandler::SocketScope socketScope(connectedSocketHandle);
+        if (maxMessageSize == (size_t)0 || maxMessageSize > maxMaxMessageSize)
+        {
+            ErrorHandler::SignalError(Error::InvalidMaxMessageSize);
+            return nullptr;
+        }
+
+        auto* const framer = new (std::nothrow) MessageFramer();
+        if (framer == nullptr)
+        {
+            ErrorHandler::SignalError(Error::NotEnoughMemory);
+            return nullptr;
+        }
+
+        //The receive buffer always fits one complete message, so a message never waits for space which can't be freed.
+        const size_t minCapacity = maxMessageSize + maxHeaderSize;
+        if (!framer->receivedBytes.Allocate(minCapacity > minReceiveBufferCapacity ? minCapacity : minReceiveBufferCapacity))
+        {
+            delete framer;
+            return nullptr;
+        }
+
+        framer->socketHandle = connectedSocketHandle;
+        framer->maxMessageSize = maxMessageSize;
+        return framer;
+    }
+
+    ErrorIndicator DestroyMessageFramer(MessageFramerHandle messageFramerHandle) noexcept
+    {
+        auto* const framer = _ToMessageFramer(messageFramerHandle);
+        if (framer == nullptr)
+            return ErrorIndicator::Error;
+
+        delete framer;
+        return (ErrorIndicator)1;
+    }
+
+    TransferStatus SendFramedMessages(MessageFramerHandle messageFramerHandle,
+        const BufferSegment* messages, int32_t messageCount, int32_t* sentMessageCount_out) noexcept
+    {
+        auto* const framer = _ToMessageFramer(messageFramerHandle);
+        if (framer == nullptr)
+            return TransferStatus::Error;
+
+        const ErrorHandler::SocketScope socketScope(framer->socketHandle);
+        if (messages == nullptr || sentMessageCount_out == nullptr)
+        {
+            ErrorHandler::SignalError(Error::PassedPointerIsNull);
+            return TransferStatus::Error;
+        }
+
+        *sentMessageCount_out = (int32_t)0;
+        for (auto i = (int32_t)0; i < messageCount; ++i)
+        {
+            if (messages[i].size > framer->maxMessageSize)
+            {
+                ErrorHandler::SignalError(Error::MessageIsTooLarge);
+                return TransferStatus::Error;
+            }
+        }
+
+        if (framer->unsentByteCount != (size_t)0)
+        {
+            const auto transferStatus = FlushMessageFramer(framer);
+            if (transferStatus != TransferStatus::Transferred)
+                return transferStatus;
+        }
+
+        while (*sentMessageCount_out < messageCount)
+        {
+            const int32_t chunkMessageCount = messageCount - *sentMessageCount_out < maxSendChunkMessageCount ?
+                messageCount - *sentMessageCount_out : maxSendChunkMessageCount;
+            const auto* const chunkMessages = messages + *sentMessageCount_out;
+            for (auto i = (int32_t)0; i < chunkMessageCount; ++i)
+            {
+                framer->segments[i * 2] = { framer->headers[i], _EncodeHeader((uint64_t)chunkMessages[i].size, framer->headers[i]) };
+                framer->segments[i * 2 + 1] = chunkMessages[i];
+            }
+
+            size_t sentByteCount;
+            const auto transferStatus = Send(framer->socketHandle, framer->segments, chunkMessageCount * (int32_t)2, &sentByteCount);
+            if (transferStatus != TransferStatus::Transferred)
+                return *sentMessageCount_out != (int32_t)0 ? TransferStatus::Transferred : transferStatus;
+
+            auto sentChunkMessageCount = (int32_t)0;
+            while (sentChunkMessageCount < chunkMessageCount)
+            {
+                const size_t messageSize = framer->segments[sentChunkMessageCount * 2].size + framer->segments[sentChunkMessageCount * 2 + 1].size;
+                if (sentByteCount < messageSize)
+                    break;
+
+                sentByteCount -= messageSize;
+                ++sentChunkMessageCount;
+            }
+
+            *sentMessageCount_out += sentChunkMessageCount;
+            if (sentChunkMessageCount == chunkMessageCount)
+                continue;
+
+            //The system took a part of the message, so the rest must be sent before any other message.
+            if (sentByteCount != (size_t)0)
+            {
+                if (!_KeepUnsentBytes(*framer, framer->segments + sentChunkMessageCount * 2, (int32_t)2, sentByteCount))
+                    return TransferStatus::Error;
+
+                ++*sentMessageCount_out;
+            }
+
+            break;
+        }
+
+        return TransferStatus::Transferred;
+    }
+
+    TransferStatus FlushMessageFramer(MessageFramerHandle messageFramerHandle) noexcept
+    {
+        auto* const framer = _ToMessageFramer(messageFramerHandle);
+        if (framer == nullptr)
+            return TransferStatus::Error;
+
+        const ErrorHandler::SocketScope socketScope(framer->socketHandle);
+        if (framer->unsentByteCount == (size_t)0)
+            return TransferStatus::Transferred;
+
+        const BufferSegment segment{ static_cast<std::byte*>(framer->unsentBytes.GetData()) + framer->unsentByteOffset, framer->unsentByteCount };
+        size_t sentByteCount;
+        const auto transferStatus = Send(framer->socketHandle, &segment, (int32_t)1, &sentByteCount);
+        if (transferStatus != TransferStatus::Transferred)
+            return transferStatus;
+
+        framer->unsentByteOffset += sentByteCount;
+        framer->unsentByteCount -= sentByteCount;
+        return framer->unsentByteCount == (size_t)0 ? TransferStatus::Transferred : TransferStatus::WouldBlock;
+    }
+
+    TransferStatus ReceiveFramedMessages(MessageFramerHandle messageFramerHandle,
+        BufferSegment* messages_out, int32_t messageCapacity, int32_t* messageCount_out) noexcept
+    {
+        auto* const framer = _ToMessageFramer(messageFramerHandle);
+        if (framer == nullptr)
+            return TransferStatus::Error;
+
+        const ErrorHandler::SocketScope socketScope(framer->socketHandle);
+        if (messages_out == nullptr || messageCount_out == nullptr)
+        {
+            ErrorHandler::SignalError(Error::PassedPointerIsNull);
+            return TransferStatus::Error;
+        }
+
+        *messageCount_out = (int32_t)0;
+        if (messageCapacity < (int32_t)1)
+        {
+            ErrorHandler::SignalError(Error::InvalidOutputCapacity);
+            return TransferStatus::Error;
+        }
+
+        framer->receivedBytes.Consume(framer->returnedByteCount);
+        framer->returnedByteCount = (size_t)0;
+
+        //Messages which are already received are returned without a system call.
+        while (true)
+        {
+            if (!_ParseMessages(*framer, messages_out, messageCapacity, *messageCount_out))
+                return TransferStatus::Error;
+
+            if (*messageCount_out != (int32_t)0)
+                return TransferStatus::Transferred;
+
+            size_t receivedByteCount;
+            const auto transferStatus = ReceiveIntoRingBuffer(framer->socketHandle, &framer->receivedBytes, &receivedByteCount);
+            if (transferStatus != TransferStatus::Transferred)
+                return transferStatus;
+        }
+    }
+
+    inline MessageFramer* _ToMessageFramer(MessageFramerHandle messageFramerHandle) noexcept
+    {
+        if (messageFramerHandle == nullptr)
+            ErrorHandler::SignalError(Error::InvalidMessageFramerHandle);
+
+        return static_cast<MessageFramer*>(messageFramerHandle);
+    }
+
+    inline size_t _EncodeHeader(uint64_t messageSize, uint8_t* header_out) noexcept
+    {
+        auto headerSize = (size_t)0;
+        while (messageSize >= (uint64_t)0x80)
+        {
+            header_out[headerSize++] = (uint8_t)(messageSize | (uint64_t)0x80);
+            messageSize >>= 7;
+        }
+
+        header_out[headerSize++] = (uint8_t)messageSize;
+        return headerSize;
+    }
+
+    //The returned bool value is set to false if the other host announced a message which is too large. In that case, the error is already signaled.
+    inline bool _ParseMessages(MessageFramer& framer, BufferSegment* messages_out, int32_t messageCapacity, int32_t& messageCount_out) noexcept
+    {
+        //The ring buffer is mirrored, so all readable bytes are contiguous.
+        auto* const data = reinterpret_cast<const uint8_t*>(framer.receivedBytes.GetReadableData());
+        const size_t readableSize = framer.receivedBytes.GetReadableSize();
+
+        size_t offset = framer.returnedByteCount;
+        while (messageCount_out < messageCapacity)
+        {
+            auto messageSize = (uint64_t)0;
+            auto headerSize = (size_t)0;
+            auto isHeaderComplete = false;
+            while (offset + headerSize < readableSize && headerSize < maxHeaderSize)
+            {
+                const uint8_t headerByte = data[offset + headerSize];
+                messageSize |= (uint64_t)(headerByte & (uint8_t)0x7F) << (headerSize * (size_t)7);
+                ++headerSize;
+                if ((headerByte & (uint8_t)0x80) == (uint8_t)0)
+                {
+                    isHeaderComplete = true;
+                    break;
+                }
+            }
+
+            if (!isHeaderComplete)
+            {
+                if (headerSize < maxHeaderSize)
+                    break;
+
+                ErrorHandler::SignalError(Error::MessageIsTooLarge);
+                return false;
+            }
+
+            if (messageSize > (uint64_t)framer.maxMessageSize)
+            {
+                ErrorHandler::SignalError(Error::MessageIsTooLarge);
+                return false;
+            }
+
+            if (offset + headerSize + (size_t)messageSize > readableSize)
+                break;
+
+            messages_out[messageCount_out++] = { const_cast<uint8_t*>(data) + offset + headerSize, (size_t)messageSize };
+            offset += headerSize + (size_t)messageSize;
+        }
+
+        framer.returnedByteCount = offset;
+        return true;
+    }
+
+    //The returned bool value is set to false if the memory can't be allocated. In that case, the error is already signaled.
+    inline bool _KeepUnsentBytes(MessageFramer& framer, const BufferSegment* segments, int32_t segmentCount, size_t sentByteCount) noexcept
+    {
+        auto unsentByteCount = (size_t)0;
+        for (auto i = (int32_t)0; i < segmentCount; ++i)
+            unsentByteCount += segments[i].size;
+        unsentByteCount -= sentByteCount;
+
+        try
+        {
+            if (framer.unsentBytes.GetCapacity() < unsentByteCount)
+                framer.unsentBytes.Resize(unsentByteCount);
+        }
+        catch (...)
+        {
+            ErrorHandler::SignalError(Error::NotEnoughMemory);
+            return false;
+        }
+
+        auto* destination = static_cast<std::byte*>(framer.unsentBytes.GetData());
+        for (auto i = (int32_t)0; i < segmentCount; ++i)
+        {
+            const size_t skippedByteCount = sentByteCount < segments[i].size ? sentByteCount : segments[i].size;
+            sentByteCount -= skippedByteCount;
+
+            std::memcpy(destination, static_cast<const std::byte*>(segments[i].data) + skippedByteCount, segments[i].size - skippedByteCount);
+            destination += segments[i].size - skippedByteCount;
+        }
+
+        framer.unsentByteOffset = (size_t)0;
+        framer.unsentByteCount = unsentByteCount;
+        return true;
+    }
+}
@@ -0,0 +1,281 @@
+#include "NativeHandles.hpp"
+#include "LinuxAPI.hpp"
+#include "ErrorHandler.hpp"
+#include "Contexts.hpp"
+#include "CompletionQueues.hpp"
+#include <vector>
+#include <cstddef>
+#include <mutex>
+#include <new>
+
+namespace NativeHandles
+{
+	//The low half of a handle keeps the context index in the high byte and the slot index incremented by one in the rest,
+	//so it's never null. The high half keeps the slot generation.
+	static_assert(sizeof(void*) == sizeof(uint64_t), "Handles must be 64 bits wide.");
+	static_assert(Contexts::maxContextCount <= (uint32_t)256, "The context index must fit into one byte.");
+
+	static constexpr auto slotsPerSlab = (uint32_t)1024;
+	static constexpr auto maxSlabCount = (uint32_t)1024;
+	static constexpr auto noNativeHandle = (uint32_t)UINT32_MAX;
+	static constexpr auto slotNumberBitCount = 24;
+	static constexpr auto slotNumberMask = ((uint32_t)1 << slotNumberBitCount) - (uint32_t)1;
+
+	struct Slot final
+	{
+		//The generation in the high half and the descriptor in the low half, so they are always read together.
+		std::atomic<uint64_t> generationAndNativeHandle{ (uint64_t)noNativeHandle };
+		HandleMetadata metadata;
+	};
+
+	struct Table final
+	{
+		//Slabs are never freed, so a lookup with a stale handle always reads valid memory.
+		std::atomic<Slot*> slabs[maxSlabCount];
+
+		//Registering and unregistering are rare compared to lookups, so they are allowed to lock.
+		std::mutex slotsMutex;
+		std::vector<uint32_t> freeSlotIndices;
+		uint32_t usedSlotCount = 0; //Slots with greater indices have never been used.
+	};
+
+	//A table is created when its context registers the first descriptor. Tables are never freed, the same way as slabs.
+	static std::atomic<Table*> tables[Contexts::maxContextCount];
+	static std::mutex tablesMutex;
+
+	inline static Table* _GetOrCreateTable(uint32_t contextIndex);
+	inline static Slot* _FindSlot(const void* handle) noexcept;
+	inline static Slot& _GetSlot(Table& table, uint32_t slotIndex) noexcept;
+
+	void* Register(int nativeHandle, HandleRole role, int addressFamily) noexcept
+	{
+		try
+		{
+			const uint32_t contextIndex = Contexts::GetCurrentIndex();
+			auto& table = *_GetOrCreateTable(contextIndex);
+			const std::lock_guard lock(table.slotsMutex);
+
+			uint32_t slotIndex;
+			if (!table.freeSlotIndices.empty())
+			{
+				slotIndex = table.freeSlotIndices.back();
+				table.freeSlotIndices.pop_back();
+			}
+			else if (table.usedSlotCount < slotsPerSlab * maxSlabCount)
+			{
+				//Unregistering must never fail to give the slot back, so there is a place for every used slot.
+				table.freeSlotIndices.reserve((size_t)table.usedSlotCount + (size_t)1);
+				if (table.usedSlotCount % slotsPerSlab == (uint32_t)0)
+					table.slabs[table.usedSlotCount / slotsPerSlab].store(new Slot[slotsPerSlab], std::memory_order_release);
+
+				slotIndex = table.usedSlotCount++;
+			}
+			else
+			{
+				throw std::bad_alloc();
+			}
+
+			auto& slot = _GetSlot(table, slotIndex);
+			auto& metadata = slot.metadata;
+			metadata.role.store(role, std::memory_order_relaxed);
+			metadata.addressFamily = addressFamily;
+			for (auto& cachedOptionValue : metadata.cachedOptionValues)
+				cachedOptionValue.store((uint32_t)0, std::memory_order_relaxed);
+			metadata.anotherHostSocketAddressState.store((uint8_t)0, std::memory_order_relaxed);
+			metadata.counters.Reset();
+			metadata.connectionStartTimestamp.store((uint64_t)0, std::memory_order_relaxed);
+
+			//The metadata is published together with the descriptor.
+			const uint64_t generation = slot.generationAndNativeHandle.load(std::memory_order_relaxed) >> 32;
+			slot.generationAndNativeHandle.store((generation << 32) | (uint64_t)(uint32_t)nativeHandle, std::memory_order_release);
+
+			return reinterpret_cast<void*>((generation << 32) | ((uint64_t)contextIndex << slotNumberBitCount) | ((uint64_t)slotIndex + (uint64_t)1));
+		}
+		catch (...)
+		{
+			ErrorHandler::SignalError(SDS::Error::NotEnoughMemory);
+		}
+
+		close(nativeHandle); //In this context, it doesn't matter if it fails.
+		return nullptr;
+	}
+
+	uint32_t GetContextIndex(const void* handle) noexcept
+	{
+		return (uint32_t)(reinterpret_cast<uint64_t>(handle) & (uint64_t)UINT32_MAX) >> slotNumberBitCount;
+	}
+
+	int ToNativeHandle(const void* handle) noexcept
+	{
+		const Slot* const slot = _FindSlot(handle);
+		if (slot == nullptr)
+			return -1;
+
+		const uint64_t generationAndNativeHandle = slot->generationAndNativeHandle.load(std::memory_order_acquire);
+		if ((generationAndNativeHandle >> 32) != (reinterpret_cast<uint64_t>(handle) >> 32))
+			return -1;
+
+		return (int)(uint32_t)generationAndNativeHandle;
+	}
+
+	int ToNativeHandle(const void* handle, HandleMetadata*& metadata_out) noexcept
+	{
+		metadata_out = nullptr;
+
+		Slot* const slot = _FindSlot(handle);
+		if (slot == nullptr)
+			return -1;
+
+		const uint64_t generationAndNativeHandle = slot->generationAndNativeHandle.load(std::memory_order_acquire);
+		if ((generationAndNativeHandle >> 32) != (reinterpret_cast<uint64_t>(handle) >> 32) || (uint32_t)generationAndNativeHandle == noNativeHandle)
+			return -1;
+
+		metadata_out = &slot->metadata;
+		return (int)(uint32_t)generationAndNativeHandle;
+	}
+
+	HandleMetadata* GetMetadata(const void* handle) noexcept
+	{
+		HandleMetadata* metadata;
+		ToNativeHandle(handle, metadata);
+		return metadata;
+	}
+
+	int Unregister(const void* handle, bool isPoller) noexcept
+	{
+		Slot* const slot = _FindSlot(handle);
+		if (slot == nullptr)
+			return -1;
+
+		//A socket never becomes a poller or the other way around, so the role checked for the generation can't change before the exchange.
+		const uint64_t generation = reinterpret_cast<uint64_t>(handle) >> 32;
+		uint64_t generationAndNativeHandle = slot->generationAndNativeHandle.load(std::memory_order_acquire);
+		do
+		{
+			if ((generationAndNativeHandle >> 32) != generation || (uint32_t)generationAndNativeHandle == noNativeHandle ||
+				(slot->metadata.role.load(std::memory_order_relaxed) == HandleRole::Poller) != isPoller)
+			{
+				return -1;
+			}
+		} while (!slot->generationAndNativeHandle.compare_exchange_weak(generationAndNativeHandle,
+			(((generation + (uint64_t)1) & (uint64_t)UINT32_MAX) << 32) | (uint64_t)noNativeHandle, std::memory_order_acq_rel));
+
+		auto& table = *tables[GetContextIndex(handle)].load(std::memory_order_relaxed); //The slot was found, so the table exists.
+		const std::lock_guard lock(table.slotsMutex);
+		table.freeSlotIndices.push_back(((uint32_t)reinterpret_cast<uint64_t>(handle) & slotNumberMask) - (uint32_t)1); //The capacity is reserved.
+
+		return (int)(uint32_t)generationAndNativeHandle;
+	}
+
+	//A new connection remembers when the last ACK arrived, which is the end of the handshake unless data arrived after it.
+	//Failures are ignored, because the measurement must never fail the accepting.
+	void RecordAcceptQueueDwell(int nativeSocket) noexcept
+	{
+		if (!Statistics::ShouldSampleAcceptQueueDwell())
+			return;
+
+		tcp_info info;
+		auto infoSize = (socklen_t)sizeof(tcp_info);
+		if (getsockopt(nativeSocket, IPPROTO_TCP, TCP_INFO, &info, &infoSize) == 0 &&
+			infoSize >= (socklen_t)(offsetof(tcp_info, tcpi_last_ack_recv) + sizeof(info.tcpi_last_ack_recv)))
+		{
+			Statistics::Record(Statistics::Histogram::AcceptQueueDwell, (uint64_t)info.tcpi_last_ack_recv * (uint64_t)1000000);
+		}
+	}
+
+	SDS::ErrorIndicator SetOption(const void* socketHandle, CachedOption option, int level, int name,
+		const void* optionValue, uint32_t optionValueSize, uint32_t cachedValue) noexcept
+	{
+		HandleMetadata* metadata;
+		const int nativeSocket = ToNativeHandle(socketHandle, metadata);
+		if (metadata != nullptr && metadata->HasOptionValue(option, cachedValue))
+			return (SDS::ErrorIndicator)1;
+
+		if (setsockopt(nativeSocket, level, name, optionValue, (socklen_t)optionValueSize) != 0)
+		{
+			ErrorHandler::Handle_setsockopt();
+			return SDS::ErrorIndicator::Error;
+		}
+
+		metadata->CacheOptionValue(option, cachedValue);
+		return (SDS::ErrorIndicator)1;
+	}
+
+	void CloseAll(uint32_t contextIndex) noexcept
+	{
+		auto* const table = tables[contextIndex].load(std::memory_order_acquire);
+		if (table == nullptr)
+			return;
+
+		const std::lock_guard lock(table->slotsMutex);
+		table->freeSlotIndices.clear();
+
+		for (auto slotIndex = table->usedSlotCount; slotIndex > (uint32_t)0; --slotIndex)
+		{
+			auto& slot = _GetSlot(*table, slotIndex - (uint32_t)1);
+			const uint64_t generationAndNativeHandle = slot.generationAndNativeHandle.load(std::memory_order_relaxed);
+			if ((uint32_t)generationAndNativeHandle != noNativeHandle)
+			{
+				//Completion queues outlive contexts, so they must forget the descriptor before it's closed.
+				CompletionQueues::Forget((int)(uint32_t)generationAndNativeHandle);
+				close((int)(uint32_t)generationAndNativeHandle); //In this context, it doesn't matter if it fails.
+				slot.generationAndNativeHandle.store(((((generationAndNativeHandle >> 32) + (uint64_t)1) & (uint64_t)UINT32_MAX) << 32) |
+					(uint64_t)noNativeHandle, std::memory_order_release);
+			}
+
+			table->freeSlotIndices.push_back(slotIndex - (uint32_t)1); //The capacity was reserved when the slot was used for the first time.
+		}
+	}
+
+	void CloseAll() noexcept
+	{
+		for (auto contextIndex = (uint32_t)0; contextIndex < Contexts::maxContextCount; ++contextIndex)
+			CloseAll(contextIndex);
+	}
+
+	//Throws std::bad_alloc if the table can't be created.
+	inline Table* _GetOrCreateTable(uint32_t contextIndex)
+	{
+		auto* table = tables[contextIndex].load(std::memory_order_acquire);
+		if (table != nullptr)
+			return table;
+
+		const std::lock_guard lock(tablesMutex);
+		table = tables[contextIndex].load(std::memory_order_relaxed);
+		if (table == nullptr)
+		{
+			table = new Table();
+			tables[contextIndex].store(table, std::memory_order_release);
+		}
+
+		return table;
+	}
+
+	inline Slot* _FindSlot(const void* handle) noexcept
+	{
+		const auto slotNumber = (uint32_t)reinterpret_cast<uint64_t>(handle) & slotNumberMask;
+		if (slotNumber == (uint32_t)0 || slotNumber > slotsPerSlab * maxSlabCount)
+			return nullptr;
+
+		const Table* const table = tables[GetContextIndex(handle)].load(std::memory_order_acquire);
+		if (table == nullptr)
+			return nullptr;
+
+		Slot* const slab = table->slabs[(slotNumber - (uint32_t)1) / slotsPerSlab].load(std::memory_order_acquire);
+		if (slab == nullptr)
+			return nullptr;
+
+		return &slab[(slotNumber - (uint32_t)1) % slotsPerSlab];
+	}
+
+	inline Slot& _GetSlot(Table& table, uint32_t slotIndex) noexcept
+	{
+		return table.slabs[slotIndex / slotsPerSlab].load(std::memory_order_relaxed)[slotIndex % slotsPerSlab];
+	}
+}
+
+Statistics::SocketCounters* Statistics::FindSocketCounters(const void* socketHandle) noexcept
+{
+	auto* const metadata = NativeHandles::GetMetadata(socketHandle);
+	return metadata != nullptr ? &metadata->counters : nullptr;
+}
\ No newline at end of file
@@ -0,0 +1,166 @@
+#include "Poller.hpp"
+#include "LinuxAPI.hpp"
+#include "State.hpp"
+#include "ErrorHandler.hpp"
+#include "NativeHandles.hpp"
+
+namespace SDS
+{
+    inline static uint32_t _ToEpollEvents(uint32_t eventFlags) noexcept;
+    inline static uint32_t _ToPollerEventFlags(uint32_t epollEvents) noexcept;
+    inline static ErrorIndicator _ControlPoller(int operation, PollerHandle pollerHandle,
+        SocketHandle socketHandle, uint32_t eventFlags, uint64_t tag) noexcept;
+
+    PollerHandle CreatePoller() noexcept
+    {
+        if (!State::isInitialized.load(std::memory_order_acquire))
+        {
+            ErrorHandler::SignalError(Error::IsNotInitialized);
+            return nullptr;
+        }
+
+        const int poller = epoll_create1(EPOLL_CLOEXEC);
+        if (poller == -1)
+        {
+            ErrorHandler::Handle_epoll_create1();
+            return nullptr;
+        }
+
+        return NativeHandles::Register(poller, NativeHandles::HandleRole::Poller, AF_UNSPEC);
+    }
+
+    ErrorIndicator DestroyPoller(PollerHandle pollerHandle) noexcept
+    {
+        const int poller = NativeHandles::Unregister(pollerHandle, true);
+        if (poller == -1)
+        {
+            ErrorHandler::SignalError(Error::InvalidPollerHandle);
+            return ErrorIndicator::Error;
+        }
+
+        if (close(poller) != 0)
+        {
+            ErrorHandler::Handle_close();
+            return ErrorIndicator::Error;
+        }
+
+        return (ErrorIndicator)1;
+    }
+
+    ErrorIndicator AddSocketToPoller(PollerHandle pollerHandle, SocketHandle socketHandle, uint32_t eventFlags, uint64_t tag) noexcept
+    {
+        const ErrorHandler::SocketScope socketScope(socketHandle);
+        return _ControlPoller(EPOLL_CTL_ADD, pollerHandle, socketHandle, eventFlags, tag);
+    }
+
+    ErrorIndicator ModifySocketInPoller(PollerHandle pollerHandle, SocketHandle socketHandle, uint32_t eventFlags, uint64_t tag) noexcept
+    {
+        const ErrorHandler::SocketScope socketScope(socketHandle);
+        return _ControlPoller(EPOLL_CTL_MOD, pollerHandle, socketHandle, eventFlags, tag);
+    }
+
+    ErrorIndicator RemoveSocketFromPoller(PollerHandle pollerHandle, SocketHandle socketHandle) noexcept
+    {
+        const ErrorHandler::SocketScope socketScope(socketHandle);
+        return _ControlPoller(EPOLL_CTL_DEL, pollerHandle, socketHandle, (uint32_t)0, (uint64_t)0);
+    }
+
+    ErrorIndicator WaitForPollerEvents(PollerHandle pollerHandle, PollerEvent* events_out,
+        int32_t eventCapacity, int32_t timeoutInMilliseconds, int32_t* eventCount_out) noexcept
+    {
+        if (events_out == nullptr || eventCount_out == nullptr)
+        {
+            ErrorHandler::SignalError(Error::PassedPointerIsNull);
+            return ErrorIndicator::Error;
+        }
+
+        //Nothing could be reported, so waiting would return immediately and an infinite wait would spin.
+        if (eventCapacity < (int32_t)1)
+        {
+            ErrorHandler::SignalError(Error::InvalidOutputCapacity);
+            return ErrorIndicator::Error;
+        }
+
+        //epoll_event is packed on some architectures, so the events are received in chunks and converted.
+        static constexpr auto maxChunkSize = (int32_t)256;
+        epoll_event epollEvents[maxChunkSize];
+
+        auto eventCount = (int32_t)0;
+        while (eventCount < eventCapacity)
+        {
+            const auto chunkSize = eventCapacity - eventCount < maxChunkSize ? eventCapacity - eventCount : maxChunkSize;
+
+            //Only the first chunk is waited for. The rest are collected only if they are already available.
+            const int readyEventCount = epoll_wait(NativeHandles::ToNativeHandle(pollerHandle), epollEvents, (int)chunkSize,
+                eventCount == (int32_t)0 ? (int)timeoutInMilliseconds : 0);
+            if (readyEventCount == -1)
+            {
+                if (errno == EINTR)
+                    break;
+
+                ErrorHandler::Handle_epoll_wait();
+                *eventCount_out = eventCount;
+                return ErrorIndicator::Error;
+            }
+
+            for (auto i = 0; i < readyEventCount; ++i)
+            {
+                events_out[eventCount].tag = epollEvents[i].data.u64;
+                events_out[eventCount].eventFlags = _ToPollerEventFlags(epollEvents[i].events);
+                ++eventCount;
+            }
+
+            if (readyEventCount < chunkSize)
+                break;
+        }
+
+        *eventCount_out = eventCount;
+        return (ErrorIndicator)1;
+    }
+
+    inline uint32_t _ToEpollEvents(uint32_t eventFlags) noexcept
+    {
+        auto epollEvents = (uint32_t)EPOLLRDHUP;
+        if ((eventFlags & (uint32_t)PollerEventFlag::Readable) != (uint32_t)0)
+            epollEvents |= (uint32_t)EPOLLIN;
+        if ((eventFlags & (uint32_t)PollerEventFlag::Writable) != (uint32_t)0)
+            epollEvents |= (uint32_t)EPOLLOUT;
+        if ((eventFlags & (uint32_t)PollerEventFlag::EdgeTriggered) != (uint32_t)0)
+            epollEvents |= (uint32_t)EPOLLET;
+        if ((eventFlags & (uint32_t)PollerEventFlag::OneShot) != (uint32_t)0)
+            epollEvents |= (uint32_t)EPOLLONESHOT;
+
+        return epollEvents;
+    }
+
+    inline uint32_t _ToPollerEventFlags(uint32_t epollEvents) noexcept
+    {
+        auto eventFlags = (uint32_t)0;
+        if ((epollEvents & (uint32_t)EPOLLIN) != (uint32_t)0)
+            eventFlags |= (uint32_t)PollerEventFlag::Readable;
+        if ((epollEvents & (uint32_t)EPOLLOUT) != (uint32_t)0)
+            eventFlags |= (uint32_t)PollerEventFlag::Writable;
+        if ((epollEvents & (uint32_t)(EPOLLHUP | EPOLLRDHUP)) != (uint32_t)0)
+            eventFlags |= (uint32_t)PollerEventFlag::Hangup;
+        if ((epollEvents & (uint32_t)EPOLLERR) != (uint32_t)0)
+            eventFlags |= (uint32_t)PollerEventFlag::Failed;
+
+        return eventFlags;
+    }
+
+    inline ErrorIndicator _ControlPoller(int operation, PollerHandle pollerHandle,
+        SocketHandle socketHandle, uint32_t eventFlags, uint64_t tag) noexcept
+    {
+        epoll_event epollEvent{};
+        epollEvent.events = _ToEpollEvents(eventFlags);
+        epollEvent.data.u64 = tag;
+
+        if (epoll_ctl(NativeHandles::ToNativeHandle(pollerHandle), operation, NativeHandles::ToNativeHandle(socketHandle), &epollEvent) != 0)
+        {
+            ErrorHandler::Handle_epoll_ctl();
+            return ErrorIndicator::Error;
+        }
+
+        return (ErrorIndicator)1;
+    }
+}
@@ -0,0 +1,82 @@
+#include "Utilities/RingBuffer.hpp"
+#include "RingBuffer.hpp"
+#include "DataTransfer.hpp"
+#include "LinuxAPI.hpp"
+#include "ErrorHandler.hpp"
+
+size_t RingBuffer::GetMappingGranularity() noexcept
+{
+    return (size_t)sysconf(_SC_PAGESIZE);
+}
+
+//The memory is a memory file, so it can be mapped twice. The address range is reserved first, so both mappings fit into it.
+std::byte* RingBuffer::MapMirrored(size_t capacity) noexcept
+{
+    const int memoryFile = memfd_create("SocketDataSharingRingBuffer", MFD_CLOEXEC);
+    if (memoryFile == -1)
+    {
+        ErrorHandler::Handle_memfd_create();
+        return nullptr;
+    }
+
+    if (ftruncate(memoryFile, (off_t)capacity) == -1)
+    {
+        ErrorHandler::Handle_ftruncate();
+        close(memoryFile); //In this context, it doesn't matter if it fails.
+        return nullptr;
+    }
+
+    auto* const data = static_cast<std::byte*>(mmap(nullptr, capacity * (size_t)2, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+    if (data == MAP_FAILED)
+    {
+        ErrorHandler::Handle_mmap();
+        close(memoryFile);
+        return nullptr;
+    }
+
+    for (auto i = (size_t)0; i < (size_t)2; ++i)
+    {
+        if (mmap(data + i * capacity, capacity, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, memoryFile, 0) == MAP_FAILED)
+        {
+            ErrorHandler::Handle_mmap();
+            munmap(data, capacity * (size_t)2);
+            close(memoryFile);
+            return nullptr;
+        }
+    }
+
+    close(memoryFile); //The mappings keep the memory alive.
+    return data;
+}
+
+void RingBuffer::Unmap(std::byte* data, size_t capacity) noexcept
+{
+    munmap(data, capacity * (size_t)2); //In this context, it can't fail.
+}
+
+namespace SDS
+{
+    TransferStatus ReceiveIntoRingBuffer(SocketHandle connectedSocketHandle, RingBufferHandle ringBufferHandle, size_t* receivedByteCount_out) noexcept
+    {
+        const ErrorHandler::SocketScope socketScope(connectedSocketHandle);
+        if (ringBufferHandle == nullptr)
+        {
+            ErrorHandler::SignalError(Error::InvalidRingBufferHandle);
+            return TransferStatus::Error;
+        }
+
+        auto* const ringBuffer = static_cast<RingBuffer*>(ringBufferHandle);
+        if (ringBuffer->GetWritableSize() == (size_t)0)
+        {
+            ErrorHandler::SignalError(Error::RingBufferIsFull);
+            return TransferStatus::Error;
+        }
+
+        const BufferSegment segment{ ringBuffer->GetWritableData(), ringBuffer->GetWritableSize() };
+        const auto transferStatus = Receive(connectedSocketHandle, &segment, (int32_t)1, receivedByteCount_out);
+        if (transferStatus == TransferStatus::Transferred)
+            ringBuffer->Commit(*receivedByteCount_out);
+
+        return transferStatus;
+    }
+}
@@ -0,0 +1,330 @@
+#include "SendQueue.hpp"
+#include "DataTransfer.hpp"
+#include "LinuxAPI.hpp"
+#include "ErrorHandler.hpp"
+#include "NativeHandles.hpp"
+#include "Utilities/BufferPool.hpp"
+#include <cstring>
+#include <vector>
+#include <new>
+
+namespace SDS
+{
+    static constexpr auto maxWriteSegmentCount = (int32_t)IOV_MAX;
+    static constexpr auto blockSize = (size_t)16384; //Small messages are copied into blocks of this size.
+
+    //Every entry holds a reference to its pool buffer, so a block is only reused when all its entries are sent.
+    struct SendQueueEntry final
+    {
+        std::byte* buffer;
+        size_t offset;
+        size_t size;
+    };
+
+    struct SendQueue final
+    {
+        SocketHandle socketHandle;
+        size_t highWaterMark;
+        size_t queuedByteCount = (size_t)0;
+
+        std::vector<SendQueueEntry> entries;
+        size_t firstEntryIndex = (size_t)0;
+
+        //The block copied messages are appended to. The queue holds a reference to it too.
+        std::byte* block = nullptr;
+        size_t blockCapacity = (size_t)0;
+        size_t blockUsedSize = (size_t)0;
+
+        BufferSegment segments[maxWriteSegmentCount];
+
+        ~SendQueue() noexcept
+        {
+            for (auto i = firstEntryIndex; i < entries.size(); ++i)
+                BufferPool::Release(entries[i].buffer);
+
+            if (block != nullptr)
+                BufferPool::Release(block);
+        }
+    };
+
+    inline static SendQueue* _ToSendQueue(SendQueueHandle sendQueueHandle) noexcept;
+    inline static bool _Append(SendQueue& queue, const std::byte* data, size_t size) noexcept;
+    inline static void _SetAboveHighWaterMark(const SendQueue& queue, Bool* isAboveHighWaterMark_out) noexcept;
+    inline static void _ReleaseSentBytes(SendQueue& queue, size_t sentByteCount) noexcept;
+    inline static ErrorIndicator _SetCork(SocketHandle socketHandle, bool isEnabled) noexcept;
+
+    SendQueueHandle CreateSendQueue(SocketHandle connectedSocketHandle, size_t highWaterMark) noexcept
+    {
+        const ErrorHandler::SocketScope socketScope(connectedSocketHandle);
+        if (highWaterMark == (size_t)0)
+        {
+            ErrorHandler::SignalError(Error::InvalidHighWaterMark);
+            return nullptr;
+        }
+
+        //The queue does the grouping, so Nagle's algorithm would only add delays.
+        if (SetTCPSocketNaglesAlgorithm(connectedSocketHandle, Bool::False) == ErrorIndicator::Error)
+            return nullptr;
+
+        auto* const queue = new (std::nothrow) SendQueue();
+        if (queue == nullptr)
+        {
+            ErrorHandler::SignalError(Error::NotEnoughMemory);
+            return nullptr;
+        }
+
+        queue->socketHandle = connectedSocketHandle;
+        queue->highWaterMark = highWaterMark;
+        return queue;
+    }
+
+    ErrorIndicator DestroySendQueue(SendQueueHandle sendQueueHandle) noexcept
+    {
+        auto* const queue = _ToSendQueue(sendQueueHandle);
+        if (queue == nullptr)
+            return ErrorIndicator::Error;
+
+        delete queue;
+        return (ErrorIndicator)1;
+    }
+
+    ErrorIndicator EnqueueMessage(SendQueueHandle sendQueueHandle, const BufferSegment* segments,
+        int32_t segmentCount, Bool* isAboveHighWaterMark_out) noexcept
+    {
+        auto* const queue = _ToSendQueue(sendQueueHandle);
+        if (queue == nullptr)
+            return ErrorIndicator::Error;
+
+        const ErrorHandler::SocketScope socketScope(queue->socketHandle);
+        if (segments == nullptr)
+        {
+            ErrorHandler::SignalError(Error::PassedPointerIsNull);
+            return ErrorIndicator::Error;
+        }
+
+        if (segmentCount < (int32_t)1 || segmentCount > maxWriteSegmentCount)
+        {
+            ErrorHandler::SignalError(Error::TooManyBufferSegments);
+            return ErrorIndicator::Error;
+        }
+
+        //If appending fails, the segments appended before stay queued, so the message is sent partly.
+        //It's only possible if the system is out of memory.
+        for (auto i = (int32_t)0; i < segmentCount; ++i)
+            if (!_Append(*queue, static_cast<const std::byte*>(segments[i].data), segments[i].size))
+                return ErrorIndicator::Error;
+
+        _SetAboveHighWaterMark(*queue, isAboveHighWaterMark_out);
+        return (ErrorIndicator)1;
+    }
+
+    ErrorIndicator EnqueuePooledBuffer(SendQueueHandle sendQueueHandle, void* buffer, size_t size, Bool* isAboveHighWaterMark_out) noexcept
+    {
+        auto* const queue = _ToSendQueue(sendQueueHandle);
+        if (queue == nullptr)
+            return ErrorIndicator::Error;
+
+        const ErrorHandler::SocketScope socketScope(queue->socketHandle);
+        if (buffer == nullptr)
+        {
+            ErrorHandler::SignalError(Error::PassedPointerIsNull);
+            return ErrorIndicator::Error;
+        }
+
+        if (!BufferPool::IsBuffer(buffer) || size > BufferPool::GetCapacity(buffer))
+        {
+            ErrorHandler::SignalError(Error::InvalidBuffer);
+            return ErrorIndicator::Error;
+        }
+
+        if (size != (size_t)0)
+        {
+            try
+            {
+                queue->entries.push_back({ static_cast<std::byte*>(buffer), (size_t)0, size });
+            }
+            catch (...)
+            {
+                ErrorHandler::SignalError(Error::NotEnoughMemory);
+                return ErrorIndicator::Error;
+            }
+
+            BufferPool::Retain(buffer);
+            queue->queuedByteCount += size;
+        }
+
+        _SetAboveHighWaterMark(*queue, isAboveHighWaterMark_out);
+        return (ErrorIndicator)1;
+    }
+
+    TransferStatus FlushSendQueue(SendQueueHandle sendQueueHandle, size_t* sentByteCount_out) noexcept
+    {
+        auto* const queue = _ToSendQueue(sendQueueHandle);
+        if (queue == nullptr)
+            return TransferStatus::Error;
+
+        const ErrorHandler::SocketScope socketScope(queue->socketHandle);
+        if (sentByteCount_out == nullptr)
+        {
+            ErrorHandler::SignalError(Error::PassedPointerIsNull);
+            return TransferStatus::Error;
+        }
+
+        *sentByteCount_out = (size_t)0;
+        if (queue->queuedByteCount == (size_t)0)
+            return TransferStatus::Transferred;
+
+        //The cork holds back partial packets until the last write, which is followed by uncorking.
+        const bool isCorked = queue->entries.size() - queue->firstEntryIndex > (size_t)maxWriteSegmentCount;
+        if (isCorked && _SetCork(queue->socketHandle, true) == ErrorIndicator::Error)
+            return TransferStatus::Error;
+
+        auto transferStatus = TransferStatus::Transferred;
+        while (queue->queuedByteCount != (size_t)0)
+        {
+            auto segmentCount = (int32_t)0;
+            auto chunkByteCount = (size_t)0;
+            for (auto i = queue->firstEntryIndex; i < queue->entries.size() && segmentCount < maxWriteSegmentCount; ++i)
+            {
+                const auto& entry = queue->entries[i];
+                queue->segments[segmentCount++] = { entry.buffer + entry.offset, entry.size };
+                chunkByteCount += entry.size;
+            }
+
+            size_t sentByteCount;
+            transferStatus = Send(queue->socketHandle, queue->segments, segmentCount, &sentByteCount);
+            if (transferStatus != TransferStatus::Transferred)
+                break;
+
+            _ReleaseSentBytes(*queue, sentByteCount);
+            *sentByteCount_out += sentByteCount;
+            if (sentByteCount != chunkByteCount)
+            {
+                transferStatus = TransferStatus::WouldBlock;
+                break;
+            }
+        }
+
+        if (isCorked && _SetCork(queue->socketHandle, false) == ErrorIndicator::Error)
+            return TransferStatus::Error;
+
+        return transferStatus;
+    }
+
+    size_t GetSendQueueSize(SendQueueHandle sendQueueHandle) noexcept
+    {
+        const auto* const queue = _ToSendQueue(sendQueueHandle);
+        return queue != nullptr ? queue->queuedByteCount : (size_t)0;
+    }
+
+    inline SendQueue* _ToSendQueue(SendQueueHandle sendQueueHandle) noexcept
+    {
+        if (sendQueueHandle == nullptr)
+            ErrorHandler::SignalError(Error::InvalidSendQueueHandle);
+
+        return static_cast<SendQueue*>(sendQueueHandle);
+    }
+
+    //The returned bool value is set to false if the memory can't be allocated. In that case, the error is already signaled.
+    inline bool _Append(SendQueue& queue, const std::byte* data, size_t size) noexcept
+    {
+        while (size != (size_t)0)
+        {
+            if (queue.blockUsedSize == queue.blockCapacity)
+            {
+                //Large messages get a block of their own size, so they are copied only once.
+                size_t capacity;
+                auto* const block = static_cast<std::byte*>(BufferPool::Acquire(size > blockSize ? size : blockSize, capacity));
+                if (block == nullptr)
+                {
+                    ErrorHandler::SignalError(Error::NotEnoughMemory);
+                    return false;
+                }
+
+                if (queue.block != nullptr)
+                    BufferPool::Release(queue.block);
+
+                queue.block = block;
+                queue.blockCapacity = capacity;
+                queue.blockUsedSize = (size_t)0;
+            }
+
+            const size_t copiedSize = size < queue.blockCapacity - queue.blockUsedSize ? size : queue.blockCapacity - queue.blockUsedSize;
+
+            //Bytes which directly follow the last entry extend it, so many messages are sent as one segment.
+            auto* const lastEntry = queue.entries.size() != queue.firstEntryIndex ? &queue.entries.back() : nullptr;
+            if (lastEntry != nullptr && lastEntry->buffer == queue.block && lastEntry->offset + lastEntry->size == queue.blockUsedSize)
+            {
+                lastEntry->size += copiedSize;
+            }
+            else
+            {
+                try
+                {
+                    queue.entries.push_back({ queue.block, queue.blockUsedSize, copiedSize });
+                }
+                catch (...)
+                {
+                    ErrorHandler::SignalError(Error::NotEnoughMemory);
+                    return false;
+                }
+
+                BufferPool::Retain(queue.block);
+            }
+
+            std::memcpy(queue.block + queue.blockUsedSize, data, copiedSize);
+            queue.blockUsedSize += copiedSize;
+            queue.queuedByteCount += copiedSize;
+            data += copiedSize;
+            size -= copiedSize;
+        }
+
+        return true;
+    }
+
+    inline void _SetAboveHighWaterMark(const SendQueue& queue, Bool* isAboveHighWaterMark_out) noexcept
+    {
+        if (isAboveHighWaterMark_out != nullptr)
+            *isAboveHighWaterMark_out = queue.queuedByteCount > queue.highWaterMark ? Bool::True : Bool::False;
+    }
+
+    inline void _ReleaseSentBytes(SendQueue& queue, size_t sentByteCount) noexcept
+    {
+        queue.queuedByteCount -= sentByteCount;
+        while (sentByteCount != (size_t)0)
+        {
+            auto& entry = queue.entries[queue.firstEntryIndex];
+            if (sentByteCount < entry.size)
+            {
+                entry.offset += sentByteCount;
+                entry.size -= sentByteCount;
+                return;
+            }
+
+            sentByteCount -= entry.size;
+            BufferPool::Release(entry.buffer);
+            ++queue.firstEntryIndex;
+        }
+
+        //An empty queue starts over, so the entries and the current block are reused without allocating.
+        if (queue.firstEntryIndex == queue.entries.size())
+        {
+            queue.entries.clear();
+            queue.firstEntryIndex = (size_t)0;
+            queue.blockUsedSize = (size_t)0;
+        }
+        else if (queue.firstEntryIndex > (size_t)maxWriteSegmentCount && queue.firstEntryIndex > queue.entries.size() / (size_t)2)
+        {
+            //A queue which never drains would keep growing, so the sent entries are dropped once they are the majority.
+            queue.entries.erase(queue.entries.begin(), queue.entries.begin() + (ptrdiff_t)queue.firstEntryIndex);
+            queue.firstEntryIndex = (size_t)0;
+        }
+    }
+
+    inline ErrorIndicator _SetCork(SocketHandle socketHandle, bool isEnabled) noexcept
+    {
+        const int optionValue = isEnabled ? 1 : 0;
+        return NativeHandles::SetOption(socketHandle, NativeHandles::CachedOption::Cork, IPPROTO_TCP, TCP_CORK,
+            &optionValue, (socklen_t)sizeof(int), (uint32_t)optionValue);
+    }
+}
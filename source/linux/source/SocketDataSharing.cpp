@@ -0,0 +1,1115 @@
+#include "SocketDataSharing.hpp"
+#include "LinuxAPI.hpp"
+#include "State.hpp"
+#include "ErrorHandler.hpp"
+#include "InternalTypeUtils.hpp"
+#include "InternalEndiannessConversions.hpp"
+#include "NativeHandles.hpp"
+#include "NativeSocketAddresses.hpp"
+#include "SocketProfiles.hpp"
+#include "CompletionQueues.hpp"
+#include "Contexts.hpp"
+#include <vector>
+#include <cstring>
+#include <cassert>
+
+namespace SDS
+{
+    inline static void _SetNetworkIPAddressesFromInterfaceAddress(
+        const ifaddrs& interfaceAddress, NetworkIPAddresses& networkIPAddresses_inout) noexcept;
+    inline static uint8_t _CountNetworkPrefixLength(const sockaddr& networkMask) noexcept;
+    inline static const void* _ChooseBestIPAddressInNetworkBO(const IPv4Address& ipv4Address, const IPv6Address& ipv6Address) noexcept;
+    inline static SocketHandle _CreateAndBindIPv4Socket(int type, int protocol, IPv4Address ipv4Address,
+        uint16_t& portNumberInHostBO_inout, const SocketProfile* profile, bool shouldSharePortNumber = false) noexcept;
+    inline static SocketHandle _CreateAndBindIPv6Socket(int type, int protocol, const IPv6Address& ipv6AddressInNetworkBO,
+        uint16_t& portNumberInHostBO_inout, const SocketProfile* profile, bool shouldSharePortNumber = false) noexcept;
+    inline static SocketHandle _CreateAndBindIPSocket(int type, int protocol, sockaddr& socketAddressInNetworkBO_inout, socklen_t socketAddressSize,
+        const SocketProfile* profile, bool shouldUpdatePortNumber = false, bool shouldSharePortNumber = false) noexcept;
+    inline static int _CreateIPSocket(int addressFamily, int type, int protocol,
+        const SocketProfile* profile, SocketProfiles::Options& profileOptions_out) noexcept;
+    inline static bool _BindIPSocket(int socketToBind, sockaddr& socketAddressInNetworkBO_inout,
+        socklen_t socketAddressSize, bool shouldUpdatePortNumber = false) noexcept;
+    inline static SocketHandle _CreateListeningIPTCPSocket(SocketHandle boundSocketHandle, uint32_t pendingConnectionQueueSize) noexcept;
+    template<typename CreateBoundSocketFunction>
+    inline static ErrorIndicator _CreateListeningIPTCPSocketGroup(CreateBoundSocketFunction createBoundSocket, uint16_t& portNumberInHostBO_inout,
+        uint32_t pendingConnectionQueueSize, int32_t listeningSocketCount, Bool shouldSteerByCPU, SocketHandle* listeningSocketHandles_out) noexcept;
+    inline static bool _SteerIPTCPSocketGroupByCPU(int listeningSocket, int32_t listeningSocketCount) noexcept;
+    inline static SocketHandle _CreateAndConnectIPTCPSocket(uint16_t portNumberToConnectFromInHostBO,
+        const sockaddr& socketAddressInNetworkBO, socklen_t socketAddressSize, const SocketProfile* profile) noexcept;
+    inline static int _AcceptNewConnection(int listeningSocket, sockaddr_in6* socketAddress_out,
+        socklen_t* socketAddressSize_inout, bool& hasFailed_out) noexcept;
+    inline static SocketHandle _RegisterNewConnection(int newConnection, const sockaddr_in6& socketAddress,
+        socklen_t socketAddressSize, ErrorIPSocketAddress* anotherHostIPSocketAddress_out) noexcept;
+
+    inline static bool _GetTCPConnectionInfo(SocketHandle tcpSocketHandle, TCPConnectionInfo& info_out, bool& isTCPSocket_out) noexcept;
+
+    inline static int ToNativeSocketHandle(SocketHandle socketHandle) noexcept
+    {
+        return NativeHandles::ToNativeHandle(socketHandle);
+    }
+
+    ErrorIndicator Initialize() noexcept
+    {
+        const std::lock_guard lock(State::initializationMutex);
+        if (State::isInitialized.load(std::memory_order_relaxed))
+        {
+            ErrorHandler::SignalError(Error::IsAlreadyInitialized);
+            return ErrorIndicator::Error;
+        }
+
+        CompletionQueues::SelectIOEngine();
+
+        State::isInitialized.store(true, std::memory_order_release);
+        return (ErrorIndicator)1;
+    }
+
+    ErrorIndicator Shutdown() noexcept
+    {
+        const std::lock_guard lock(State::initializationMutex);
+        if (!State::isInitialized.load(std::memory_order_relaxed))
+        {
+            ErrorHandler::SignalError(Error::IsNotInitialized);
+            return ErrorIndicator::Error;
+        }
+
+        CompletionQueues::DestroyAll();
+        Contexts::DestroyAll();
+        NativeHandles::CloseAll();
+
+        State::isInitialized.store(false, std::memory_order_release);
+        return (ErrorIndicator)1;
+    }
+
+    ErrorSupportedProtocols EnumerateSupportedProtocols() noexcept
+    {
+        static constexpr struct { int addressFamily; int type; int protocol; Bool ErrorSupportedProtocols::* isSupported; } protocols[]
+        {
+            { AF_INET, SOCK_STREAM, IPPROTO_TCP, &ErrorSupportedProtocols::isIPv4TCPSupported },
+            { AF_INET, SOCK_DGRAM, IPPROTO_UDP, &ErrorSupportedProtocols::isIPv4UDPSupported },
+            { AF_INET6, SOCK_STREAM, IPPROTO_TCP, &ErrorSupportedProtocols::isIPv6TCPSupported },
+            { AF_INET6, SOCK_DGRAM, IPPROTO_UDP, &ErrorSupportedProtocols::isIPv6UDPSupported },
+        };
+
+        ErrorSupportedProtocols supportedProtocols{};
+
+        //There is no protocol catalog on Linux, so every protocol is probed by creating a socket.
+        for (const auto& protocol : protocols)
+        {
+            const int probeSocket = socket(protocol.addressFamily, protocol.type | SOCK_CLOEXEC, protocol.protocol);
+            if (probeSocket != -1)
+            {
+                close(probeSocket);
+                supportedProtocols.*protocol.isSupported = Bool::True;
+            }
+            else if (errno != EAFNOSUPPORT && errno != EPROTONOSUPPORT && errno != ESOCKTNOSUPPORT)
+            {
+                ErrorHandler::Handle_socket(protocol.addressFamily, protocol.type, protocol.protocol);
+                return {};
+            }
+        }
+
+        supportedProtocols.errorIndicator = (ErrorIndicator)1;
+        return supportedProtocols;
+    }
+
+    NetworkIPAddresses* GetNetworkIPAddressesArray(int32_t* size_out) noexcept
+    {
+        if (!State::isInitialized.load(std::memory_order_acquire)) //It's not necessary to do this check.
+        {
+            ErrorHandler::SignalError(Error::IsNotInitialized);
+            return nullptr;
+        }
+
+        if (size_out == nullptr)
+        {
+            ErrorHandler::SignalError(Error::PassedPointerIsNull);
+            return nullptr;
+        }
+
+        ifaddrs* interfaceAddresses;
+        if (getifaddrs(&interfaceAddresses) == 0)
+        {
+            try
+            {
+                //Every thread gets its own array, so concurrent calls don't overwrite each other's results.
+                static thread_local std::vector<NetworkIPAddresses> networkIPAddresses(2);
+                static thread_local std::vector<const char*> networkInterfaceNames(2);
+                networkIPAddresses.clear();
+                networkInterfaceNames.clear();
+
+                for (const ifaddrs* nextInterfaceAddress = interfaceAddresses; nextInterfaceAddress != nullptr;
+                    nextInterfaceAddress = nextInterfaceAddress->ifa_next)
+                {
+                    if (nextInterfaceAddress->ifa_addr == nullptr || nextInterfaceAddress->ifa_netmask == nullptr ||
+                        (nextInterfaceAddress->ifa_flags & IFF_UP) == 0 || (nextInterfaceAddress->ifa_flags & IFF_LOOPBACK) != 0) //Ignore loopback interfaces.
+                        continue;
+
+                    const auto addressFamily = nextInterfaceAddress->ifa_addr->sa_family;
+                    if (addressFamily != AF_INET && addressFamily != AF_INET6)
+                        continue;
+
+                    //getifaddrs returns one entry per address, so the entries are grouped by their network interface.
+                    //The names stay valid until freeifaddrs is called.
+                    auto i = (size_t)0;
+                    while (i < networkInterfaceNames.size() && std::strcmp(networkInterfaceNames[i], nextInterfaceAddress->ifa_name) != 0)
+                        ++i;
+
+                    if (i == networkInterfaceNames.size())
+                    {
+                        networkIPAddresses.emplace_back();
+                        networkInterfaceNames.emplace_back(nextInterfaceAddress->ifa_name);
+                    }
+
+                    _SetNetworkIPAddressesFromInterfaceAddress(*nextInterfaceAddress, networkIPAddresses[i]);
+                }
+
+                freeifaddrs(interfaceAddresses);
+
+                *size_out = (int32_t)networkIPAddresses.size();
+                return networkIPAddresses.data();
+            }
+            catch (...)
+            {
+                freeifaddrs(interfaceAddresses);
+                ErrorHandler::SignalError(Error::NotEnoughMemory);
+            }
+        }
+        else
+        {
+            ErrorHandler::Handle_getifaddrs();
+        }
+
+        *size_out = (int32_t)0;
+        return nullptr;
+    }
+
+    ErrorBool IsIPv4AddressPreferred(const NetworkIPAddresses* networkIPAddressesInNetworkBO) noexcept
+    {
+        if (!State::isInitialized.load(std::memory_order_acquire)) //It's not necessary to do this check.
+        {
+            ErrorHandler::SignalError(Error::IsNotInitialized);
+            return ErrorBool::Error;
+        }
+
+        if (networkIPAddressesInNetworkBO == nullptr)
+        {
+            ErrorHandler::SignalError(Error::PassedPointerIsNull);
+            return ErrorBool::Error;
+        }
+
+        const auto* const bestIPAddressPointer = _ChooseBestIPAddressInNetworkBO(
+            networkIPAddressesInNetworkBO->v4, networkIPAddressesInNetworkBO->v6);
+        if (bestIPAddressPointer == &networkIPAddressesInNetworkBO->v4)
+            return ErrorBool::True;
+
+        return ErrorBool::False;
+    }
+
+    SocketHandle CreateIPv4UDPSocket(IPv4Address ipv4Address, uint16_t* portNumberInHostBO_inout) noexcept
+    {
+        return CreateIPv4UDPSocketWithProfile(ipv4Address, portNumberInHostBO_inout, nullptr);
+    }
+
+    SocketHandle CreateIPv4UDPSocketWithProfile(IPv4Address ipv4Address, uint16_t* portNumberInHostBO_inout, const SocketProfile* profile) noexcept
+    {
+        if (InternalIPv4AddressUtils::IsZero(ipv4Address))
+        {
+            ErrorHandler::SignalError(Error::InvalidIPAddress);
+            return nullptr;
+        }
+
+        if (portNumberInHostBO_inout == nullptr)
+        {
+            ErrorHandler::SignalError(Error::PassedPointerIsNull);
+            return nullptr;
+        }
+
+        return _CreateAndBindIPv4Socket(SOCK_DGRAM, IPPROTO_UDP, ipv4Address, *portNumberInHostBO_inout, profile);
+    }
+
+    SocketHandle CreateIPv6UDPSocket(IPv6Address ipv6AddressInNetworkBO, uint16_t* portNumberInHostBO_inout) noexcept
+    {
+        return CreateIPv6UDPSocketWithProfile(ipv6AddressInNetworkBO, portNumberInHostBO_inout, nullptr);
+    }
+
+    SocketHandle CreateIPv6UDPSocketWithProfile(IPv6Address ipv6AddressInNetworkBO, uint16_t* portNumberInHostBO_inout, const SocketProfile* profile) noexcept
+    {
+        if (InternalIPv6AddressUtils::IsZero(ipv6AddressInNetworkBO))
+        {
+            ErrorHandler::SignalError(Error::InvalidIPAddress);
+            return nullptr;
+        }
+
+        if (portNumberInHostBO_inout == nullptr)
+        {
+            ErrorHandler::SignalError(Error::PassedPointerIsNull);
+            return nullptr;
+        }
+
+        return _CreateAndBindIPv6Socket(SOCK_DGRAM, IPPROTO_UDP, ipv6AddressInNetworkBO, *portNumberInHostBO_inout, profile);
+    }
+
+    SocketHandle CreateListeningIPv4TCPSocket(IPv4Address ipv4Address,
+        uint16_t* portNumberInHostBO_inout, uint32_t pendingConnectionQueueSize) noexcept
+    {
+        return CreateListeningIPv4TCPSocketWithProfile(ipv4Address, portNumberInHostBO_inout, pendingConnectionQueueSize, nullptr);
+    }
+
+    SocketHandle CreateListeningIPv4TCPSocketWithProfile(IPv4Address ipv4Address,
+        uint16_t* portNumberInHostBO_inout, uint32_t pendingConnectionQueueSize, const SocketProfile* profile) noexcept
+    {
+        if (InternalIPv4AddressUtils::IsZero(ipv4Address))
+        {
+            ErrorHandler::SignalError(Error::InvalidIPAddress);
+            return nullptr;
+        }
+
+        if (portNumberInHostBO_inout == nullptr)
+        {
+            ErrorHandler::SignalError(Error::PassedPointerIsNull);
+            return nullptr;
+        }
+
+        return _CreateListeningIPTCPSocket(_CreateAndBindIPv4Socket(SOCK_STREAM, IPPROTO_TCP,
+            ipv4Address, *portNumberInHostBO_inout, profile), pendingConnectionQueueSize);
+    }
+
+    SocketHandle CreateListeningIPv6TCPSocket(IPv6Address ipv6AddressInNetworkBO,
+        uint16_t* portNumberInHostBO_inout, uint32_t pendingConnectionQueueSize) noexcept
+    {
+        return CreateListeningIPv6TCPSocketWithProfile(ipv6AddressInNetworkBO, portNumberInHostBO_inout, pendingConnectionQueueSize, nullptr);
+    }
+
+    SocketHandle CreateListeningIPv6TCPSocketWithProfile(IPv6Address ipv6AddressInNetworkBO,
+        uint16_t* portNumberInHostBO_inout, uint32_t pendingConnectionQueueSize, const SocketProfile* profile) noexcept
+    {
+        if (InternalIPv6AddressUtils::IsZero(ipv6AddressInNetworkBO))
+        {
+            ErrorHandler::SignalError(Error::InvalidIPAddress);
+            return nullptr;
+        }
+
+        if (portNumberInHostBO_inout == nullptr)
+        {
+            ErrorHandler::SignalError(Error::PassedPointerIsNull);
+            return nullptr;
+        }
+
+        return _CreateListeningIPTCPSocket(_CreateAndBindIPv6Socket(SOCK_STREAM, IPPROTO_TCP,
+            ipv6AddressInNetworkBO, *portNumberInHostBO_inout, profile), pendingConnectionQueueSize);
+    }
+
+    ErrorIndicator CreateListeningIPv4TCPSocketGroup(IPv4Address ipv4Address, uint16_t* portNumberInHostBO_inout,
+        uint32_t pendingConnectionQueueSize, int32_t listeningSocketCount, Bool shouldSteerByCPU, SocketHandle* listeningSocketHandles_out) noexcept
+    {
+        return CreateListeningIPv4TCPSocketGroupWithProfile(ipv4Address, portNumberInHostBO_inout, pendingConnectionQueueSize,
+            listeningSocketCount, shouldSteerByCPU, listeningSocketHandles_out, nullptr);
+    }
+
+    ErrorIndicator CreateListeningIPv4TCPSocketGroupWithProfile(IPv4Address ipv4Address, uint16_t* portNumberInHostBO_inout,
+        uint32_t pendingConnectionQueueSize, int32_t listeningSocketCount, Bool shouldSteerByCPU, SocketHandle* listeningSocketHandles_out,
+        const SocketProfile* profile) noexcept
+    {
+        if (InternalIPv4AddressUtils::IsZero(ipv4Address))
+        {
+            ErrorHandler::SignalError(Error::InvalidIPAddress);
+            return ErrorIndicator::Error;
+        }
+
+        if (portNumberInHostBO_inout == nullptr || listeningSocketHandles_out == nullptr)
+        {
+            ErrorHandler::SignalError(Error::PassedPointerIsNull);
+            return ErrorIndicator::Error;
+        }
+
+        return _CreateListeningIPTCPSocketGroup([&ipv4Address, profile](uint16_t& portNumberInHostBO_inout)
+            {
+                return _CreateAndBindIPv4Socket(SOCK_STREAM, IPPROTO_TCP, ipv4Address, portNumberInHostBO_inout, profile, true);
+            },
+            *portNumberInHostBO_inout, pendingConnectionQueueSize, listeningSocketCount, shouldSteerByCPU, listeningSocketHandles_out);
+    }
+
+    ErrorIndicator CreateListeningIPv6TCPSocketGroup(IPv6Address ipv6AddressInNetworkBO, uint16_t* portNumberInHostBO_inout,
+        uint32_t pendingConnectionQueueSize, int32_t listeningSocketCount, Bool shouldSteerByCPU, SocketHandle* listeningSocketHandles_out) noexcept
+    {
+        return CreateListeningIPv6TCPSocketGroupWithProfile(ipv6AddressInNetworkBO, portNumberInHostBO_inout, pendingConnectionQueueSize,
+            listeningSocketCount, shouldSteerByCPU, listeningSocketHandles_out, nullptr);
+    }
+
+    ErrorIndicator CreateListeningIPv6TCPSocketGroupWithProfile(IPv6Address ipv6AddressInNetworkBO, uint16_t* portNumberInHostBO_inout,
+        uint32_t pendingConnectionQueueSize, int32_t listeningSocketCount, Bool shouldSteerByCPU, SocketHandle* listeningSocketHandles_out,
+        const SocketProfile* profile) noexcept
+    {
+        if (InternalIPv6AddressUtils::IsZero(ipv6AddressInNetworkBO))
+        {
+            ErrorHandler::SignalError(Error::InvalidIPAddress);
+            return ErrorIndicator::Error;
+        }
+
+        if (portNumberInHostBO_inout == nullptr || listeningSocketHandles_out == nullptr)
+        {
+            ErrorHandler::SignalError(Error::PassedPointerIsNull);
+            return ErrorIndicator::Error;
+        }
+
+        return _CreateListeningIPTCPSocketGroup([&ipv6AddressInNetworkBO, profile](uint16_t& portNumberInHostBO_inout)
+            {
+                return _CreateAndBindIPv6Socket(SOCK_STREAM, IPPROTO_TCP, ipv6AddressInNetworkBO, portNumberInHostBO_inout, profile, true);
+            },
+            *portNumberInHostBO_inout, pendingConnectionQueueSize, listeningSocketCount, shouldSteerByCPU, listeningSocketHandles_out);
+    }
+
+    SocketHandle CreateConnectedIPv4TCPSocket(uint16_t portNumberToConnectFromInHostBO,
+        IPv4Address ipv4AddressToConnectTo, uint16_t portNumberToConnectToInHostBO) noexcept
+    {
+        return CreateConnectedIPv4TCPSocketWithProfile(portNumberToConnectFromInHostBO, ipv4AddressToConnectTo, portNumberToConnectToInHostBO, nullptr);
+    }
+
+    SocketHandle CreateConnectedIPv4TCPSocketWithProfile(uint16_t portNumberToConnectFromInHostBO,
+        IPv4Address ipv4AddressToConnectTo, uint16_t portNumberToConnectToInHostBO, const SocketProfile* profile) noexcept
+    {
+        if (portNumberToConnectToInHostBO == (uint16_t)0)
+        {
+            ErrorHandler::SignalError(Error::PortNumberIsInvalid);
+            return nullptr;
+        }
+
+        sockaddr_in socketAddressToConnectTo{};
+        socketAddressToConnectTo.sin_family = AF_INET;
+        socketAddressToConnectTo.sin_port = HostToNetworkBO(portNumberToConnectToInHostBO);
+        InternalIPv4AddressUtils::CopyTo(&socketAddressToConnectTo.sin_addr, ipv4AddressToConnectTo);
+
+        return _CreateAndConnectIPTCPSocket(portNumberToConnectFromInHostBO,
+            reinterpret_cast<sockaddr&>(socketAddressToConnectTo), (socklen_t)sizeof(sockaddr_in), profile);
+    }
+
+    SocketHandle CreateConnectedIPv6TCPSocket(uint16_t portNumberToConnectFromInHostBO,
+        IPv6Address ipv6AddressToConnectToInHostBO, uint16_t portNumberToConnectToInHostBO) noexcept
+    {
+        return CreateConnectedIPv6TCPSocketWithProfile(portNumberToConnectFromInHostBO, ipv6AddressToConnectToInHostBO, portNumberToConnectToInHostBO, nullptr);
+    }
+
+    SocketHandle CreateConnectedIPv6TCPSocketWithProfile(uint16_t portNumberToConnectFromInHostBO,
+        IPv6Address ipv6AddressToConnectToInHostBO, uint16_t portNumberToConnectToInHostBO, const SocketProfile* profile) noexcept
+    {
+        if (portNumberToConnectToInHostBO == (uint16_t)0)
+        {
+            ErrorHandler::SignalError(Error::PortNumberIsInvalid);
+            return nullptr;
+        }
+
+        InternalIPv6AddressUtils::ToNetworkBO(ipv6AddressToConnectToInHostBO, ipv6AddressToConnectToInHostBO);
+
+        sockaddr_in6 socketAddressToConnectTo{};
+        socketAddressToConnectTo.sin6_family = AF_INET6;
+        socketAddressToConnectTo.sin6_port = HostToNetworkBO(portNumberToConnectToInHostBO);
+        socketAddressToConnectTo.sin6_flowinfo = ipv6AddressToConnectToInHostBO.flowInfo;
+        InternalIPv6AddressUtils::CopyTo(&socketAddressToConnectTo.sin6_addr, ipv6AddressToConnectToInHostBO);
+        socketAddressToConnectTo.sin6_scope_id = ipv6AddressToConnectToInHostBO.scopeID;
+
+        return _CreateAndConnectIPTCPSocket(portNumberToConnectFromInHostBO,
+            reinterpret_cast<sockaddr&>(socketAddressToConnectTo), (socklen_t)sizeof(sockaddr_in6), profile);
+    }
+
+    ErrorIndicator AcceptNewConnection(SocketHandle listeningSocketHandle, SocketHandle* connectedSocketHandle_out) noexcept
+    {
+        const ErrorHandler::SocketScope socketScope(listeningSocketHandle);
+        if (connectedSocketHandle_out == nullptr)
+        {
+            ErrorHandler::SignalError(Error::PassedPointerIsNull);
+            return ErrorIndicator::Error;
+        }
+
+        //The new connection belongs to the context of the listening socket.
+        const Contexts::Scope scope(NativeHandles::GetContextIndex(listeningSocketHandle));
+
+        //The address is returned by accept anyway, so it's remembered to answer GetAnotherHostIPSocketAddress without a system call.
+        sockaddr_in6 socketAddress; //Used as a buffer for any IP address family.
+        auto socketAddressSize = (socklen_t)sizeof(sockaddr_in6);
+
+        bool hasFailed;
+        const int newConnection = _AcceptNewConnection(ToNativeSocketHandle(listeningSocketHandle), &socketAddress, &socketAddressSize, hasFailed);
+        if (hasFailed)
+            return ErrorIndicator::Error;
+
+        *connectedSocketHandle_out = nullptr;
+        if (newConnection != -1)
+        {
+            *connectedSocketHandle_out = _RegisterNewConnection(newConnection, socketAddress, socketAddressSize, nullptr);
+            if (*connectedSocketHandle_out == nullptr)
+                return ErrorIndicator::Error;
+
+            Statistics::Count(Statistics::FindSocketCounters(listeningSocketHandle), Statistics::Counter::AcceptCount);
+        }
+
+        return (ErrorIndicator)1;
+    }
+
+    ErrorIndicator AcceptNewConnections(SocketHandle listeningSocketHandle, SocketHandle* connectedSocketHandles_out,
+        ErrorIPSocketAddress* anotherHostIPSocketAddresses_out, int32_t capacity, int32_t* connectionCount_out) noexcept
+    {
+        const ErrorHandler::SocketScope socketScope(listeningSocketHandle);
+        if (connectedSocketHandles_out == nullptr || connectionCount_out == nullptr)
+        {
+            ErrorHandler::SignalError(Error::PassedPointerIsNull);
+            return ErrorIndicator::Error;
+        }
+
+        //The new connections belong to the context of the listening socket.
+        const Contexts::Scope scope(NativeHandles::GetContextIndex(listeningSocketHandle));
+
+        const int listeningSocket = ToNativeSocketHandle(listeningSocketHandle);
+        auto connectionCount = (int32_t)0;
+        bool hasFailed = false;
+
+        while (connectionCount < capacity)
+        {
+            sockaddr_in6 socketAddress; //Used as a buffer for any IP address family.
+            auto socketAddressSize = (socklen_t)sizeof(sockaddr_in6);
+
+            const int newConnection = _AcceptNewConnection(listeningSocket, &socketAddress, &socketAddressSize, hasFailed);
+            if (newConnection == -1)
+                break;
+
+            connectedSocketHandles_out[connectionCount] = _RegisterNewConnection(newConnection, socketAddress, socketAddressSize,
+                anotherHostIPSocketAddresses_out != nullptr ? &anotherHostIPSocketAddresses_out[connectionCount] : nullptr);
+            if (connectedSocketHandles_out[connectionCount] == nullptr)
+            {
+                hasFailed = true;
+                break;
+            }
+
+            ++connectionCount;
+        }
+
+        if (connectionCount != (int32_t)0)
+            Statistics::Count(Statistics::FindSocketCounters(listeningSocketHandle), Statistics::Counter::AcceptCount, (uint64_t)connectionCount);
+
+        *connectionCount_out = connectionCount;
+        return hasFailed && connectionCount == (int32_t)0 ? ErrorIndicator::Error : (ErrorIndicator)1;
+    }
+
+    ErrorBool IsTCPSocketConnected(SocketHandle connectingSocketHandle) noexcept
+    {
+        const ErrorHandler::SocketScope socketScope(connectingSocketHandle);
+        NativeHandles::HandleMetadata* metadata;
+        const int connectingSocket = NativeHandles::ToNativeHandle(connectingSocketHandle, metadata);
+        if (metadata != nullptr && metadata->role.load(std::memory_order_relaxed) == NativeHandles::HandleRole::ConnectedTCPSocket)
+            return ErrorBool::True;
+
+        int connectionError;
+        auto connectionErrorSize = (socklen_t)sizeof(int);
+        if (getsockopt(connectingSocket, SOL_SOCKET, SO_ERROR, &connectionError, &connectionErrorSize) != 0)
+        {
+            ErrorHandler::Handle_getsockopt();
+            return ErrorBool::Error;
+        }
+
+        //The pending error is the result of the non-blocking connect call.
+        if (connectionError != 0)
+        {
+            errno = connectionError;
+            ErrorHandler::Handle_connect();
+            return ErrorBool::Error;
+        }
+
+        sockaddr_in6 socketAddress; //Used as a buffer for any IP address family.
+        auto socketAddressSize = (socklen_t)sizeof(sockaddr_in6);
+        if (getpeername(connectingSocket, reinterpret_cast<sockaddr*>(&socketAddress), &socketAddressSize) == 0)
+        {
+            //Both answers are remembered, so the following calls cost no system calls.
+            ErrorIPSocketAddress anotherHostIPSocketAddress;
+            if (NativeSocketAddresses::FromNative(socketAddress, socketAddressSize, anotherHostIPSocketAddress))
+                metadata->CacheAnotherHostSocketAddress(anotherHostIPSocketAddress);
+
+            metadata->role.store(NativeHandles::HandleRole::ConnectedTCPSocket, std::memory_order_relaxed);
+            metadata->RecordConnectionEstablishment();
+            return ErrorBool::True;
+        }
+
+        if (errno == ENOTCONN)
+            return ErrorBool::False;
+
+        ErrorHandler::Handle_getpeername();
+        return ErrorBool::Error;
+    }
+
+    ErrorIPSocketAddress GetAnotherHostIPSocketAddress(SocketHandle connectedSocketHandle) noexcept
+    {
+        const ErrorHandler::SocketScope socketScope(connectedSocketHandle);
+        ErrorIPSocketAddress errorIPSocketAddress{};
+
+        NativeHandles::HandleMetadata* metadata;
+        const int connectedSocket = NativeHandles::ToNativeHandle(connectedSocketHandle, metadata);
+        if (metadata != nullptr && metadata->GetAnotherHostSocketAddress(errorIPSocketAddress))
+            return errorIPSocketAddress;
+
+        sockaddr_in6 socketAddress; //Used as a buffer for any IP address family.
+        auto socketAddressSize = (socklen_t)sizeof(sockaddr_in6);
+        if (getpeername(connectedSocket, reinterpret_cast<sockaddr*>(&socketAddress), &socketAddressSize) != 0)
+        {
+            ErrorHandler::Handle_getpeername();
+            return errorIPSocketAddress;
+        }
+
+        if (!NativeSocketAddresses::FromNative(socketAddress, socketAddressSize, errorIPSocketAddress))
+            ErrorHandler::SignalError(Error::AnotherHostUsesIncompatibleSocketAddress);
+        else
+            metadata->CacheAnotherHostSocketAddress(errorIPSocketAddress);
+
+        return errorIPSocketAddress;
+    }
+
+    ErrorIndicator DestroySocket(SocketHandle socketHandle) noexcept
+    {
+        const ErrorHandler::SocketScope socketScope(socketHandle);
+        //Only one of the concurrent calls with the same handle can succeed, so the descriptor is never closed twice.
+        const int nativeSocketHandle = NativeHandles::Unregister(socketHandle, false);
+        if (nativeSocketHandle == -1)
+        {
+            ErrorHandler::SignalError(Error::InvalidSocketHandle);
+            return ErrorIndicator::Error;
+        }
+
+        CompletionQueues::Forget(nativeSocketHandle);
+
+        //The descriptor is released even if close fails, so it must never be closed twice.
+        if (close(nativeSocketHandle) != 0 && errno != EINPROGRESS)
+        {
+            ErrorHandler::Handle_close();
+            return ErrorIndicator::Error;
+        }
+
+        return (ErrorIndicator)1;
+    }
+
+    ErrorIndicator SetTCPSocketNaglesAlgorithm(SocketHandle socketHandle, Bool isEnabled) noexcept
+    {
+        const ErrorHandler::SocketScope socketScope(socketHandle);
+        const int optionValue = isEnabled == Bool::False ? 1 : 0;
+        return NativeHandles::SetOption(socketHandle, NativeHandles::CachedOption::NaglesAlgorithm, IPPROTO_TCP, TCP_NODELAY,
+            &optionValue, (socklen_t)sizeof(int), (uint32_t)optionValue);
+    }
+
+    ErrorIndicator SetSocketDestructionTimeout(SocketHandle socketHandle, Bool isEnabled, uint16_t timeInSeconds) noexcept
+    {
+        const ErrorHandler::SocketScope socketScope(socketHandle);
+        const linger optionValue{ isEnabled != Bool::False ? 1 : 0, (int)timeInSeconds };
+        return NativeHandles::SetOption(socketHandle, NativeHandles::CachedOption::DestructionTimeout, SOL_SOCKET, SO_LINGER,
+            &optionValue, (socklen_t)sizeof(linger), ((uint32_t)optionValue.l_onoff << 16) | (uint32_t)timeInSeconds);
+    }
+
+    ErrorIndicator SetSocketBroadcast(SocketHandle socketHandle, Bool isEnabled) noexcept
+    {
+        const ErrorHandler::SocketScope socketScope(socketHandle);
+        const int optionValue = isEnabled != Bool::False ? 1 : 0;
+        return NativeHandles::SetOption(socketHandle, NativeHandles::CachedOption::Broadcast, SOL_SOCKET, SO_BROADCAST,
+            &optionValue, (socklen_t)sizeof(int), (uint32_t)optionValue);
+    }
+
+    ErrorIndicator ApplySocketProfile(SocketHandle socketHandle, const SocketProfile* profile) noexcept
+    {
+        const ErrorHandler::SocketScope socketScope(socketHandle);
+        if (profile == nullptr)
+        {
+            ErrorHandler::SignalError(Error::PassedPointerIsNull);
+            return ErrorIndicator::Error;
+        }
+
+        const auto* const metadata = NativeHandles::GetMetadata(socketHandle);
+        if (metadata == nullptr)
+        {
+            ErrorHandler::SignalError(Error::InvalidSocketHandle);
+            return ErrorIndicator::Error;
+        }
+
+        SocketProfiles::Options profileOptions;
+        SocketProfiles::GetOptions(*profile, metadata->addressFamily, profileOptions);
+        return SocketProfiles::Set(socketHandle, profileOptions);
+    }
+
+    ErrorIndicator GetTCPConnectionInfo(SocketHandle tcpSocketHandle, TCPConnectionInfo* info_out) noexcept
+    {
+        const ErrorHandler::SocketScope socketScope(tcpSocketHandle);
+        if (info_out == nullptr)
+        {
+            ErrorHandler::SignalError(Error::PassedPointerIsNull);
+            return ErrorIndicator::Error;
+        }
+
+        TCPConnectionInfo info;
+        bool isTCPSocket;
+        if (!_GetTCPConnectionInfo(tcpSocketHandle, info, isTCPSocket))
+        {
+            if (isTCPSocket)
+                ErrorHandler::Handle_getsockopt();
+            else
+                ErrorHandler::SignalError(NativeHandles::GetMetadata(tcpSocketHandle) == nullptr ? Error::InvalidSocketHandle : Error::SocketMustBeConnected);
+
+            return ErrorIndicator::Error;
+        }
+
+        *info_out = info;
+        return (ErrorIndicator)1;
+    }
+
+    int32_t GetTCPConnectionInfos(const SocketHandle* tcpSocketHandles, int32_t socketCount, TCPConnectionInfo* infos_out) noexcept
+    {
+        if (socketCount > (int32_t)0 && (tcpSocketHandles == nullptr || infos_out == nullptr))
+        {
+            ErrorHandler::SignalError(Error::PassedPointerIsNull);
+            return (int32_t)-1;
+        }
+
+        auto validInfoCount = (int32_t)0;
+        for (auto i = (int32_t)0; i < socketCount; ++i)
+        {
+            bool isTCPSocket;
+            if (_GetTCPConnectionInfo(tcpSocketHandles[i], infos_out[i], isTCPSocket))
+            {
+                infos_out[i].isValid = Bool::True;
+                ++validInfoCount;
+            }
+            else
+            {
+                infos_out[i] = {};
+                infos_out[i].isValid = Bool::False;
+            }
+        }
+
+        return validInfoCount;
+    }
+
+    //The last address of each IP version wins, the same way as it works with Windows network adapters.
+    inline void _SetNetworkIPAddressesFromInterfaceAddress(const ifaddrs& interfaceAddress, NetworkIPAddresses& networkIPAddresses_inout) noexcept
+    {
+        if (interfaceAddress.ifa_addr->sa_family == AF_INET)
+        {
+            networkIPAddresses_inout.v4NetworkPrefixLength = _CountNetworkPrefixLength(*interfaceAddress.ifa_netmask);
+            InternalIPv4AddressUtils::CopyFrom(
+                &reinterpret_cast<const sockaddr_in*>(interfaceAddress.ifa_addr)->sin_addr, networkIPAddresses_inout.v4);
+        }
+        else
+        {
+            const auto& socketAddress = *reinterpret_cast<const sockaddr_in6*>(interfaceAddress.ifa_addr);
+
+            networkIPAddresses_inout.v6NetworkPrefixLength = _CountNetworkPrefixLength(*interfaceAddress.ifa_netmask);
+            InternalIPv6AddressUtils::CopyFrom(&socketAddress.sin6_addr, networkIPAddresses_inout.v6);
+            networkIPAddresses_inout.v6.scopeID = socketAddress.sin6_scope_id;
+            networkIPAddresses_inout.v6.flowInfo = socketAddress.sin6_flowinfo;
+        }
+    }
+
+    //getifaddrs returns network masks instead of prefix lengths.
+    inline uint8_t _CountNetworkPrefixLength(const sockaddr& networkMask) noexcept
+    {
+        const uint8_t* maskBytes;
+        size_t maskSize;
+        if (networkMask.sa_family == AF_INET)
+        {
+            maskBytes = reinterpret_cast<const uint8_t*>(&reinterpret_cast<const sockaddr_in&>(networkMask).sin_addr);
+            maskSize = sizeof(in_addr);
+        }
+        else
+        {
+            maskBytes = reinterpret_cast<const uint8_t*>(&reinterpret_cast<const sockaddr_in6&>(networkMask).sin6_addr);
+            maskSize = sizeof(in6_addr);
+        }
+
+        auto prefixLength = (uint8_t)0;
+        for (auto i = (size_t)0; i < maskSize; ++i)
+            prefixLength += (uint8_t)__builtin_popcount(maskBytes[i]);
+
+        return prefixLength;
+    }
+
+    //This function returns a pointer to the best IPAddress.
+    inline const void* _ChooseBestIPAddressInNetworkBO(const IPv4Address& ipv4Address, const IPv6Address& ipv6AddressInNetworkBO) noexcept
+    {
+        auto ipv4PriorityLevel = (uint8_t)1;
+        if (InternalIPv4AddressUtils::IsPrivate(ipv4Address))
+            return &ipv4Address;
+        else if (InternalIPv4AddressUtils::IsLinkLocal(ipv4Address))
+            ipv4PriorityLevel = 2;
+        else if (InternalIPv4AddressUtils::IsZero(ipv4Address))
+            ipv4PriorityLevel = 0;
+
+        auto ipv6PriorityLevel = (uint8_t)1;
+        if (InternalIPv6AddressUtils::IsLinkLocalInNetworkBO(ipv6AddressInNetworkBO))
+            ipv6PriorityLevel = 2;
+        else if (InternalIPv6AddressUtils::IsPrivateInNetworkBO(ipv6AddressInNetworkBO))
+            ipv6PriorityLevel = 3;
+        else if (InternalIPv6AddressUtils::IsZero(ipv6AddressInNetworkBO))
+            ipv6PriorityLevel = 0;
+
+        if (ipv4PriorityLevel >= ipv6PriorityLevel)
+            return &ipv4Address;
+
+        return &ipv6AddressInNetworkBO;
+    }
+
+    //The returned socket handle can only be nullptr if an error occured.
+    //The port number will be updated only if the address isn't zero.
+    inline SocketHandle _CreateAndBindIPv4Socket(int type, int protocol, IPv4Address ipv4Address,
+        uint16_t& portNumberInHostBO_inout, const SocketProfile* profile, bool shouldSharePortNumber) noexcept
+    {
+        sockaddr_in socketAddress{};
+        socketAddress.sin_family = AF_INET;
+        socketAddress.sin_port = HostToNetworkBO(portNumberInHostBO_inout);
+        InternalIPv4AddressUtils::CopyTo(&socketAddress.sin_addr, ipv4Address);
+
+        auto* const socketHandle = _CreateAndBindIPSocket(type, protocol, reinterpret_cast<sockaddr&>(socketAddress),
+            (socklen_t)sizeof(sockaddr_in), profile, !InternalIPv4AddressUtils::IsZero(ipv4Address), shouldSharePortNumber);
+        if (socketHandle != nullptr)
+            portNumberInHostBO_inout = NetworkToHostBO(socketAddress.sin_port);
+
+        return socketHandle;
+    }
+
+    //The returned socket handle can only be nullptr if an error occured.
+    //The port number will be updated only if the address isn't zero.
+    inline SocketHandle _CreateAndBindIPv6Socket(int type, int protocol, const IPv6Address& ipv6AddressInNetworkBO,
+        uint16_t& portNumberInHostBO_inout, const SocketProfile* profile, bool shouldSharePortNumber) noexcept
+    {
+        sockaddr_in6 socketAddress{};
+        socketAddress.sin6_family = AF_INET6;
+        socketAddress.sin6_port = HostToNetworkBO(portNumberInHostBO_inout);
+        socketAddress.sin6_flowinfo = ipv6AddressInNetworkBO.flowInfo;
+        InternalIPv6AddressUtils::CopyTo(&socketAddress.sin6_addr, ipv6AddressInNetworkBO);
+        socketAddress.sin6_scope_id = ipv6AddressInNetworkBO.scopeID;
+
+        auto* const socketHandle = _CreateAndBindIPSocket(type, protocol, reinterpret_cast<sockaddr&>(socketAddress),
+            (socklen_t)sizeof(sockaddr_in6), profile, !InternalIPv6AddressUtils::IsZero(ipv6AddressInNetworkBO), shouldSharePortNumber);
+        if (socketHandle != nullptr)
+            portNumberInHostBO_inout = NetworkToHostBO(socketAddress.sin6_port);
+
+        return socketHandle;
+    }
+
+    //The returned socket handle can only be nullptr if an error occured.
+    //If the passed port number is zero and shouldUpdatePortNumber is true, it will updated the port number.
+    //Don't set the shouldUpdatePortNumber parameter to true if the address may be zero.
+    //If shouldSharePortNumber is true, SO_REUSEPORT is enabled before binding, so the socket address can be shared with other such sockets.
+    inline SocketHandle _CreateAndBindIPSocket(int type, int protocol, sockaddr& socketAddressInNetworkBO_inout, socklen_t socketAddressSize,
+        const SocketProfile* profile, bool shouldUpdatePortNumber, bool shouldSharePortNumber) noexcept
+    {
+        SocketProfiles::Options profileOptions;
+        const int socketHandle = _CreateIPSocket(socketAddressInNetworkBO_inout.sa_family, type, protocol, profile, profileOptions);
+        if (socketHandle == -1)
+            return nullptr;
+
+        static constexpr int isPortNumberShared = 1;
+        if (shouldSharePortNumber &&
+            setsockopt(socketHandle, SOL_SOCKET, SO_REUSEPORT, &isPortNumberShared, (socklen_t)sizeof(int)) != 0)
+        {
+            ErrorHandler::Handle_setsockopt();
+        }
+        else if (_BindIPSocket(socketHandle, socketAddressInNetworkBO_inout, socketAddressSize, shouldUpdatePortNumber))
+        {
+            auto* const boundSocketHandle = NativeHandles::Register(socketHandle, type == SOCK_DGRAM ? NativeHandles::HandleRole::UDPSocket :
+                NativeHandles::HandleRole::BoundTCPSocket, socketAddressInNetworkBO_inout.sa_family);
+            if (boundSocketHandle != nullptr)
+                SocketProfiles::Cache(*NativeHandles::GetMetadata(boundSocketHandle), profileOptions);
+
+            return boundSocketHandle;
+        }
+
+        close(socketHandle); //In this context, it doesn't matter if it fails.
+        return nullptr;
+    }
+
+    //The returned native socket handle is -1 only if an error occured.
+    //The socket is created in non-blocking mode right away, so no additional system call is needed.
+    //The options of the profile are set before the socket is returned, so it's never bound or connected half configured.
+    //Cache the set options after the socket is registered. Passing a null profile is legal.
+    inline int _CreateIPSocket(int addressFamily, int type, int protocol,
+        const SocketProfile* profile, SocketProfiles::Options& profileOptions_out) noexcept
+    {
+        assert(addressFamily == AF_INET || addressFamily == AF_INET6);
+        assert((type == SOCK_STREAM && protocol == IPPROTO_TCP) ||
+            (type == SOCK_DGRAM && protocol == IPPROTO_UDP));
+
+        profileOptions_out.count = (size_t)0;
+        const int socketHandle = socket(addressFamily, type | SOCK_NONBLOCK | SOCK_CLOEXEC, protocol);
+        if (socketHandle == -1)
+        {
+            ErrorHandler::Handle_socket(addressFamily, type, protocol);
+            return -1;
+        }
+
+        if (profile != nullptr)
+        {
+            SocketProfiles::GetOptions(*profile, addressFamily, profileOptions_out);
+            if (!SocketProfiles::Set(socketHandle, profileOptions_out))
+            {
+                close(socketHandle); //In this context, it doesn't matter if it fails.
+                return -1;
+            }
+        }
+
+        return socketHandle;
+    }
+
+    //The returned bool value is set to false if the function failed.
+    //If the passed port number is zero and shouldUpdatePortNumber is true, it will updated the port number.
+    //Don't set the shouldUpdatePortNumber parameter to true if the address may be zero.
+    inline bool _BindIPSocket(int ipSocketToBind, sockaddr& ipSocketAddressInNetworkBO_inout,
+        socklen_t ipSocketAddressSize, bool shouldUpdatePortNumber) noexcept
+    {
+        if (bind(ipSocketToBind, &ipSocketAddressInNetworkBO_inout, ipSocketAddressSize) == 0)
+        {
+            if (shouldUpdatePortNumber &&
+                reinterpret_cast<uint16_t*>(&ipSocketAddressInNetworkBO_inout)[1] == (uint16_t)0) //Checks for the port number being zero.
+            {
+                if (getsockname(ipSocketToBind, &ipSocketAddressInNetworkBO_inout, &ipSocketAddressSize) != 0)
+                {
+                    ErrorHandler::Handle_getsockname();
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        ErrorHandler::Handle_bind();
+        return false;
+    }
+
+    //The bound socket is destroyed if the function failed. Passing a null handle is legal and returns null.
+    inline SocketHandle _CreateListeningIPTCPSocket(SocketHandle boundSocketHandle, uint32_t pendingConnectionQueueSize) noexcept
+    {
+        if (boundSocketHandle != nullptr)
+        {
+            pendingConnectionQueueSize &= 0x7FFFFFFF;
+
+            NativeHandles::HandleMetadata* metadata;
+            const int boundSocket = NativeHandles::ToNativeHandle(boundSocketHandle, metadata);
+            if (listen(boundSocket, (int)pendingConnectionQueueSize) != 0)
+            {
+                ErrorHandler::Handle_listen();
+                NativeHandles::Unregister(boundSocketHandle, false);
+                close(boundSocket); //In this context, it doesn't matter if it fails.
+                boundSocketHandle = nullptr;
+            }
+            else
+            {
+                metadata->role.store(NativeHandles::HandleRole::ListeningTCPSocket, std::memory_order_relaxed);
+            }
+        }
+
+        return boundSocketHandle;
+    }
+
+    //If an error occured, the already created sockets are destroyed.
+    //The first socket binds the port number if it's zero, then the rest of the sockets share it.
+    template<typename CreateBoundSocketFunction>
+    inline ErrorIndicator _CreateListeningIPTCPSocketGroup(CreateBoundSocketFunction createBoundSocket, uint16_t& portNumberInHostBO_inout,
+        uint32_t pendingConnectionQueueSize, int32_t listeningSocketCount, Bool shouldSteerByCPU, SocketHandle* listeningSocketHandles_out) noexcept
+    {
+        if (listeningSocketCount < (int32_t)1)
+        {
+            ErrorHandler::SignalError(Error::InvalidSocketGroupSize);
+            return ErrorIndicator::Error;
+        }
+
+        auto portNumberInHostBO = portNumberInHostBO_inout;
+        auto createdSocketCount = (int32_t)0;
+        for (; createdSocketCount < listeningSocketCount; ++createdSocketCount)
+        {
+            //Sockets join the group in the order they start listening, which is the order used by the steering program.
+            listeningSocketHandles_out[createdSocketCount] = _CreateListeningIPTCPSocket(
+                createBoundSocket(portNumberInHostBO), pendingConnectionQueueSize);
+            if (listeningSocketHandles_out[createdSocketCount] == nullptr)
+                break;
+        }
+
+        if (createdSocketCount == listeningSocketCount && (shouldSteerByCPU == Bool::False ||
+            _SteerIPTCPSocketGroupByCPU(ToNativeSocketHandle(listeningSocketHandles_out[0]), listeningSocketCount)))
+        {
+            portNumberInHostBO_inout = portNumberInHostBO;
+            return (ErrorIndicator)1;
+        }
+
+        for (auto i = (int32_t)0; i < createdSocketCount; ++i)
+        {
+            close(NativeHandles::Unregister(listeningSocketHandles_out[i], false)); //In this context, it doesn't matter if it fails.
+            listeningSocketHandles_out[i] = nullptr;
+        }
+
+        return ErrorIndicator::Error;
+    }
+
+    //Attaches a program to the group which picks the socket with the index equal to the current CPU number modulo the socket count.
+    //The current CPU is the one which processes the incoming connection request.
+    inline bool _SteerIPTCPSocketGroupByCPU(int listeningSocket, int32_t listeningSocketCount) noexcept
+    {
+        sock_filter instructions[]
+        {
+            { BPF_LD | BPF_W | BPF_ABS, 0, 0, (uint32_t)(SKF_AD_OFF + SKF_AD_CPU) },
+            { BPF_ALU | BPF_MOD | BPF_K, 0, 0, (uint32_t)listeningSocketCount },
+            { BPF_RET | BPF_A, 0, 0, 0 },
+        };
+
+        const sock_fprog program{ (unsigned short)(sizeof(instructions) / sizeof(sock_filter)), instructions };
+        if (setsockopt(listeningSocket, SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, &program, (socklen_t)sizeof(sock_fprog)) != 0)
+        {
+            ErrorHandler::Handle_setsockopt();
+            return false;
+        }
+
+        return true;
+    }
+
+    //If the port number to connect from is zero, the socket isn't bound before connect.
+    //In that case, the system picks the local port together with the destination, so the same port can be reused for different peers.
+    inline SocketHandle _CreateAndConnectIPTCPSocket(uint16_t portNumberToConnectFromInHostBO,
+        const sockaddr& socketAddressToConnectToInNetworkBO, socklen_t socketAddressToConnectToSize, const SocketProfile* profile) noexcept
+    {
+        const uint64_t connectionStartTimestamp = Statistics::GetTimestamp();
+        SocketProfiles::Options profileOptions;
+        const int connectingSocketHandle = _CreateIPSocket(socketAddressToConnectToInNetworkBO.sa_family,
+            SOCK_STREAM, IPPROTO_TCP, profile, profileOptions);
+        if (connectingSocketHandle == -1)
+            return nullptr;
+
+        if (portNumberToConnectFromInHostBO != (uint16_t)0)
+        {
+            sockaddr_in6 socketAddress{}; //Used as a buffer for any IP address family.
+            socketAddress.sin6_family = socketAddressToConnectToInNetworkBO.sa_family;
+            socketAddress.sin6_port = HostToNetworkBO(portNumberToConnectFromInHostBO);
+
+            const auto socketAddressSize = socketAddress.sin6_family == AF_INET ? (socklen_t)sizeof(sockaddr_in) : (socklen_t)sizeof(sockaddr_in6);
+            if (!_BindIPSocket(connectingSocketHandle, reinterpret_cast<sockaddr&>(socketAddress), socketAddressSize))
+            {
+                close(connectingSocketHandle); //In this context, it doesn't matter if it fails.
+                return nullptr;
+            }
+        }
+
+        if (connect(connectingSocketHandle, &socketAddressToConnectToInNetworkBO, socketAddressToConnectToSize) != 0 && errno != EINPROGRESS)
+        {
+            ErrorHandler::Handle_connect();
+            close(connectingSocketHandle); //In this context, it doesn't matter if it fails.
+            return nullptr;
+        }
+
+        auto* const connectingSocket = NativeHandles::Register(connectingSocketHandle,
+            NativeHandles::HandleRole::ConnectingTCPSocket, socketAddressToConnectToInNetworkBO.sa_family);
+        if (connectingSocket != nullptr)
+        {
+            auto* const metadata = NativeHandles::GetMetadata(connectingSocket);
+            metadata->connectionStartTimestamp.store(connectionStartTimestamp, std::memory_order_relaxed);
+            Statistics::Count(&metadata->counters, Statistics::Counter::ConnectCount);
+            SocketProfiles::Cache(*metadata, profileOptions);
+        }
+
+        return connectingSocket;
+    }
+
+    //The returned native socket handle is -1 if the queue is empty or an error occured. In the latter case, hasFailed_out is set to true.
+    //The new connection is created in non-blocking mode right away, so no additional system call is needed.
+    inline int _AcceptNewConnection(int listeningSocket, sockaddr_in6* socketAddress_out,
+        socklen_t* socketAddressSize_inout, bool& hasFailed_out) noexcept
+    {
+        hasFailed_out = false;
+        while (true)
+        {
+            const int newConnection = accept4(listeningSocket, reinterpret_cast<sockaddr*>(socketAddress_out),
+                socketAddressSize_inout, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (newConnection != -1)
+                return newConnection;
+
+            const int errorCode = errno;
+
+            //Linux passes the already pending network errors of the new connection to accept. They must be treated like EAGAIN.
+            //The connection is dropped in that case, so the next one can be accepted.
+            if (errorCode == EINTR || errorCode == ECONNABORTED || errorCode == ENETDOWN || errorCode == EPROTO || errorCode == ENOPROTOOPT ||
+                errorCode == EHOSTDOWN || errorCode == ENONET || errorCode == EHOSTUNREACH || errorCode == ENETUNREACH)
+                continue;
+
+            if (errorCode != EAGAIN && errorCode != EWOULDBLOCK)
+            {
+                ErrorHandler::Handle_accept();
+                hasFailed_out = true;
+            }
+
+            return -1;
+        }
+    }
+
+    //The address of another host is remembered, so GetAnotherHostIPSocketAddress costs no system call.
+    inline SocketHandle _RegisterNewConnection(int newConnection, const sockaddr_in6& socketAddress,
+        socklen_t socketAddressSize, ErrorIPSocketAddress* anotherHostIPSocketAddress_out) noexcept
+    {
+        NativeHandles::RecordAcceptQueueDwell(newConnection);
+        auto* const connectedSocketHandle = NativeHandles::Register(newConnection,
+            NativeHandles::HandleRole::ConnectedTCPSocket, socketAddress.sin6_family);
+        if (connectedSocketHandle == nullptr)
+            return nullptr;
+
+        //The connection is accepted even if the address is incompatible, so the caller must check the error indicator of the address.
+        ErrorIPSocketAddress anotherHostIPSocketAddress{};
+        if (NativeSocketAddresses::FromNative(socketAddress, socketAddressSize, anotherHostIPSocketAddress))
+        {
+            NativeHandles::GetMetadata(connectedSocketHandle)->CacheAnotherHostSocketAddress(anotherHostIPSocketAddress);
+        }
+        else
+        {
+            ErrorHandler::SignalError(Error::AnotherHostUsesIncompatibleSocketAddress);
+            anotherHostIPSocketAddress.errorIndicator = ErrorIndicator::Error;
+        }
+
+        if (anotherHostIPSocketAddress_out != nullptr)
+            *anotherHostIPSocketAddress_out = anotherHostIPSocketAddress;
+
+        return connectedSocketHandle;
+    }
+
+    //The libc declaration of tcp_info is older than the kernel one, so the newer fields are declared here. The layout is stable.
+    //Older kernels return a shorter structure, so the fields they don't know stay zero.
+    struct KernelTCPInfo final
+    {
+        tcp_info info;
+        uint64_t pacingRate;
+        uint64_t maxPacingRate;
+        uint64_t ackedByteCount;
+        uint64_t receivedByteCount;
+        uint32_t sentSegmentCount;
+        uint32_t receivedSegmentCount;
+        uint32_t notSentByteCount;
+        uint32_t minRoundTripTime;
+        uint32_t receivedDataSegmentCount;
+        uint32_t sentDataSegmentCount;
+        uint64_t deliveryRate;
+    };
+
+    //The returned value is false if the call failed. isTCPSocket_out is set to false if the handle isn't a valid TCP socket,
+    //which is found without a system call.
+    inline bool _GetTCPConnectionInfo(SocketHandle tcpSocketHandle, TCPConnectionInfo& info_out, bool& isTCPSocket_out) noexcept
+    {
+        NativeHandles::HandleMetadata* metadata;
+        const int tcpSocket = NativeHandles::ToNativeHandle(tcpSocketHandle, metadata);
+        const auto role = metadata != nullptr ? metadata->role.load(std::memory_order_relaxed) : NativeHandles::HandleRole::Poller;
+        isTCPSocket_out = role == NativeHandles::HandleRole::ConnectingTCPSocket || role == NativeHandles::HandleRole::ConnectedTCPSocket;
+        if (!isTCPSocket_out)
+            return false;
+
+        KernelTCPInfo kernelInfo{};
+        auto kernelInfoSize = (socklen_t)sizeof(KernelTCPInfo);
+        if (getsockopt(tcpSocket, IPPROTO_TCP, TCP_INFO, &kernelInfo, &kernelInfoSize) != 0)
+            return false;
+
+        const auto& info = kernelInfo.info;
+        info_out = {};
+        info_out.deliveryRateInBytesPerSecond = kernelInfo.deliveryRate;
+        info_out.pacingRateInBytesPerSecond = kernelInfo.pacingRate;
+        info_out.smoothedRoundTripTimeInMicroseconds = info.tcpi_rtt;
+        info_out.roundTripTimeVarianceInMicroseconds = info.tcpi_rttvar;
+        info_out.congestionWindowInSegments = info.tcpi_snd_cwnd;
+        info_out.unacknowledgedSegmentCount = info.tcpi_unacked;
+        info_out.maxSegmentSize = info.tcpi_snd_mss;
+        info_out.retransmittedSegmentCount = info.tcpi_total_retrans;
+        info_out.notSentByteCount = kernelInfo.notSentByteCount;
+        return true;
+    }
+}
@@ -1,17 +1,16 @@
 #include "ErrorHandler.hpp"
 #include <cassert>
 
-#define CALL_CALLBACK m_callback(error, (int64_t)errorCode, m_callbackContext)
+#define REPORT_ERROR ReportError(error, (int64_t)errorCode)
 
 using namespace SDS;
 
-static Error error = Error::Success;
-
 void ErrorHandler::Handle_WSAStartup(int errorCode) noexcept
 {
     assert(errorCode != 0);
     assert(errorCode != WSAEFAULT); //Invalid arguments
 
+    Error error;
     switch (errorCode)
     {
     case WSASYSNOTREADY:
@@ -30,7 +29,7 @@ void ErrorHandler::Handle_WSAStartup(int errorCode) noexcept
         error = Error::UnexpectedSystemError;
     }
 
-    CALL_CALLBACK;
+    REPORT_ERROR;
 }
 
 void ErrorHandler::Handle_WSACleanup() noexcept
@@ -38,6 +37,7 @@ void ErrorHandler::Handle_WSACleanup() noexcept
     const int errorCode = WSAGetLastError();
     assert(errorCode != 0);
 
+    Error error;
     switch (errorCode)
     {
     case WSAENETDOWN:
@@ -53,7 +53,7 @@ void ErrorHandler::Handle_WSACleanup() noexcept
     }
 
     WSASetLastError(0);
-    CALL_CALLBACK;
+    REPORT_ERROR;
 }
 
 void ErrorHandler::Handle_WSAEnumProtocols() noexcept
@@ -64,6 +64,7 @@ void ErrorHandler::Handle_WSAEnumProtocols() noexcept
     assert(errorCode != WSAEFAULT && errorCode != WSAEINVAL); //Invalid arguments.
     assert(errorCode != WSAENOBUFS); //The buffer is too small.
 
+    Error error;
     switch (errorCode)
     {
     case WSAENETDOWN:
@@ -79,7 +80,7 @@ void ErrorHandler::Handle_WSAEnumProtocols() noexcept
     }
 
     WSASetLastError(0);
-    CALL_CALLBACK;
+    REPORT_ERROR;
 }
 
 void ErrorHandler::Handle_GetAdaptersAddresses(ULONG errorCode) noexcept
@@ -90,6 +91,7 @@ void ErrorHandler::Handle_GetAdaptersAddresses(ULONG errorCode) noexcept
     assert(errorCode != ERROR_NO_DATA);
     assert(errorCode != ERROR_ADDRESS_NOT_ASSOCIATED); //Treat the same as ERROR_NO_DATA.
 
+    Error error;
     switch (errorCode)
     {
     case ERROR_NOT_ENOUGH_MEMORY:
@@ -100,7 +102,7 @@ void ErrorHandler::Handle_GetAdaptersAddresses(ULONG errorCode) noexcept
         error = Error::UnexpectedSystemError;
     }
 
-    CALL_CALLBACK;
+    REPORT_ERROR;
 }
 
 void ErrorHandler::Handle_socket(int addressFamily, int socketType, int protocol) noexcept
@@ -116,6 +118,7 @@ void ErrorHandler::Handle_socket(int addressFamily, int socketType, int protocol
         addressFamily == AF_INET6 && socketType == SOCK_STREAM && protocol == IPPROTO_TCP ||
         addressFamily == AF_INET6 && socketType == SOCK_DGRAM && protocol == IPPROTO_UDP);
 
+    Error error;
     switch (errorCode)
     {
     case WSAENETDOWN: 
@@ -169,7 +172,7 @@ void ErrorHandler::Handle_socket(int addressFamily, int socketType, int protocol
     }
 
     WSASetLastError(0);
-    CALL_CALLBACK;
+    REPORT_ERROR;
 }
 
 void ErrorHandler::Handle_ioctlsocket() noexcept
@@ -179,6 +182,7 @@ void ErrorHandler::Handle_ioctlsocket() noexcept
 
     assert(errorCode != WSAEFAULT); //Invalid arguments
 
+    Error error;
     switch (errorCode)
     {
     case WSAENETDOWN:
@@ -198,7 +202,7 @@ void ErrorHandler::Handle_ioctlsocket() noexcept
     }
 
     WSASetLastError(0);
-    CALL_CALLBACK;
+    REPORT_ERROR;
 }
 
 void ErrorHandler::Handle_bind() noexcept
@@ -209,6 +213,7 @@ void ErrorHandler::Handle_bind() noexcept
     assert(errorCode != WSAEFAULT); //Invalid arguments or the passed address family doesn't match the address family of the socket.
     assert(errorCode != WSAEINVAL); //The socket is already bound.
 
+    Error error;
     switch (errorCode)
     {
     case WSAENETDOWN:
@@ -243,7 +248,7 @@ void ErrorHandler::Handle_bind() noexcept
     }
 
     WSASetLastError(0);
-    CALL_CALLBACK;
+    REPORT_ERROR;
 }
 
 void ErrorHandler::Handle_getsockname() noexcept
@@ -254,6 +259,7 @@ void ErrorHandler::Handle_getsockname() noexcept
     assert(errorCode != WSAEFAULT); //Invalid arguments.
     assert(errorCode != WSAEINVAL); //Socket isn't bound or bound with a zero address.
 
+    Error error;
     switch (errorCode)
     {
     case WSAENETDOWN:
@@ -273,7 +279,7 @@ void ErrorHandler::Handle_getsockname() noexcept
     }
 
     WSASetLastError(0);
-    CALL_CALLBACK;
+    REPORT_ERROR;
 }
 
 void ErrorHandler::Handle_closesocket() noexcept
@@ -283,6 +289,7 @@ void ErrorHandler::Handle_closesocket() noexcept
 
     assert(errorCode != WSAEWOULDBLOCK); //It's not an error.
     
+    Error error;
     switch (errorCode)
     {
     case WSAENETDOWN:
@@ -302,7 +309,7 @@ void ErrorHandler::Handle_closesocket() noexcept
     }
 
     WSASetLastError(0);
-    CALL_CALLBACK;
+    REPORT_ERROR;
 }
 
 void ErrorHandler::Handle_setsockopt() noexcept
@@ -313,6 +320,7 @@ void ErrorHandler::Handle_setsockopt() noexcept
     assert(errorCode != WSAEFAULT); //Invalid arguments.
     assert(errorCode != WSAENETRESET && errorCode != WSAENOTCONN); //SO_KEEPALIVE is set and something happened.
  
+    Error error;
     switch (errorCode)
     {
     case WSAENETDOWN:
@@ -337,7 +345,7 @@ void ErrorHandler::Handle_setsockopt() noexcept
     }
 
     WSASetLastError(0);
-    CALL_CALLBACK;
+    REPORT_ERROR;
 }
 
 void ErrorHandler::Handle_getsockopt() noexcept
@@ -347,6 +355,7 @@ void ErrorHandler::Handle_getsockopt() noexcept
 
     assert(errorCode != WSAEFAULT); //Invalid arguments.
 
+    Error error;
     switch (errorCode)
     {
     case WSAENETDOWN:
@@ -371,7 +380,7 @@ void ErrorHandler::Handle_getsockopt() noexcept
     }
 
     WSASetLastError(0);
-    CALL_CALLBACK;
+    REPORT_ERROR;
 }
 
 void ErrorHandler::Handle_listen() noexcept
@@ -384,6 +393,7 @@ void ErrorHandler::Handle_listen() noexcept
     assert(errorCode != WSAEOPNOTSUPP); //The socket doesn't support listening mode.
     assert(errorCode != WSAEISCONN); //The socket is connected or connecting.
 
+    Error error;
     switch (errorCode)
     {
     case WSAENETDOWN:
@@ -411,7 +421,7 @@ void ErrorHandler::Handle_listen() noexcept
     }
 
     WSASetLastError(0);
-    CALL_CALLBACK;
+    REPORT_ERROR;
 }
 
 void ErrorHandler::Handle_accept() noexcept
@@ -423,6 +433,7 @@ void ErrorHandler::Handle_accept() noexcept
     assert(errorCode != WSAEWOULDBLOCK); //It's not an error.
     assert(errorCode != WSAECONNRESET); //The other host terminated the connection prior to the accept call.
 
+    Error error;
     switch (errorCode)
     {
     case WSAENETDOWN:
@@ -455,7 +466,7 @@ void ErrorHandler::Handle_accept() noexcept
     }
 
     WSASetLastError(0);
-    CALL_CALLBACK;
+    REPORT_ERROR;
 }
 
 void ErrorHandler::Handle_getpeername() noexcept
@@ -465,6 +476,7 @@ void ErrorHandler::Handle_getpeername() noexcept
 
     assert(errorCode != WSAEFAULT); //Invalid arguments.
 
+    Error error;
     switch (errorCode)
     {
     case WSAENETDOWN:
@@ -488,7 +500,7 @@ void ErrorHandler::Handle_getpeername() noexcept
     }
 
     WSASetLastError(0);
-    CALL_CALLBACK;
+    REPORT_ERROR;
 }
 
 void ErrorHandler::Handle_connect() noexcept
@@ -502,6 +514,7 @@ void ErrorHandler::Handle_connect() noexcept
     assert(errorCode != WSAEALREADY && errorCode != WSAEISCONN); //The socket is already connected or connecting.
     assert(errorCode != WSAEWOULDBLOCK); //It's not an error.
 
+    Error error;
     switch (errorCode)
     {
     case WSAENETDOWN:
@@ -550,5 +563,5 @@ void ErrorHandler::Handle_connect() noexcept
     }
 
     WSASetLastError(0);
-    CALL_CALLBACK;
+    REPORT_ERROR;
 }
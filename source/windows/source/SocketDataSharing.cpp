@@ -5,6 +5,9 @@
 #include "InternalTypeUtils.hpp"
 #include "InternalEndiannessConversions.hpp"
 #include "Utilities/Buffer.hpp"
+#include "Utilities/BufferPool.hpp"
+#include "Utilities/RingBuffer.hpp"
+#include "Statistics.hpp"
 #include <utility>
 #include <vector>
 #include <cassert>
@@ -17,15 +20,17 @@ namespace SDS
         const IP_ADAPTER_ADDRESSES& ipAdapter, NetworkIPAddresses& networkIPAddresses_out) noexcept;
     inline static const void* _ChooseBestIPAddressInNetworkBO(const IPv4Address& ipv4Address, const IPv6Address& ipv6Address) noexcept;
     inline static SocketHandle _CreateAndBindIPv4Socket(int type, int protocol, 
-        IPv4Address ipv4Address, uint16_t& portNumberInHostBO_inout) noexcept;
+        IPv4Address ipv4Address, uint16_t& portNumberInHostBO_inout, const SocketProfile* profile) noexcept;
     inline static SocketHandle _CreateAndBindIPv6Socket(int type, int protocol,
-        const IPv6Address& ipv6AddressInNetworkBO, uint16_t& portNumberInHostBO_inout) noexcept;
-    inline static SocketHandle _CreateAndBindIPSocket(int type, int protocol, 
-        sockaddr& socketAddressInNetworkBO_inout, int socketAddressSize, bool shouldUpdatePortNumber = false) noexcept;
+        const IPv6Address& ipv6AddressInNetworkBO, uint16_t& portNumberInHostBO_inout, const SocketProfile* profile) noexcept;
+    inline static SocketHandle _CreateAndBindIPSocket(int type, int protocol, sockaddr& socketAddressInNetworkBO_inout,
+        int socketAddressSize, const SocketProfile* profile, bool shouldUpdatePortNumber = false) noexcept;
+    inline static bool _SetSocketProfileOptions(SOCKET socketHandle, const SocketProfile& profile) noexcept;
     inline static bool _BindIPSocket(SOCKET socketToBind, sockaddr& socketAddressInNetworkBO_inout, 
         int socketAddressSize, bool shouldUpdatePortNumber = false) noexcept;
     inline static SocketHandle _CreateAndConnectIPTCPSocket(uint16_t portNumberToConnectFromInHostBO,
-        const sockaddr& socketAddressInNetworkBO, int socketAddressSize) noexcept;
+        const sockaddr& socketAddressInNetworkBO, int socketAddressSize, const SocketProfile* profile) noexcept;
+    inline static ErrorIPSocketAddress _ToErrorIPSocketAddress(const sockaddr_in6& socketAddressInNetworkBO) noexcept;
 
     inline static SocketHandle ToSocketHandle(SOCKET nativeSocketHandle) noexcept
     {
@@ -40,7 +45,8 @@ namespace SDS
 
     ErrorIndicator Initialize() noexcept
     {
-        if (State::isInitialized)
+        const std::lock_guard lock(State::initializationMutex);
+        if (State::isInitialized.load(std::memory_order_relaxed))
         {
             ErrorHandler::SignalError(Error::IsAlreadyInitialized);
             return ErrorIndicator::Error;
@@ -63,13 +69,14 @@ namespace SDS
             return ErrorIndicator::Error;
         }
 
-        State::isInitialized = true;
+        State::isInitialized.store(true, std::memory_order_release);
         return (ErrorIndicator)1;
     }
 
     ErrorIndicator Shutdown() noexcept
     {
-        if (!State::isInitialized)
+        const std::lock_guard lock(State::initializationMutex);
+        if (!State::isInitialized.load(std::memory_order_relaxed))
         {
             ErrorHandler::SignalError(Error::IsNotInitialized);
             ErrorIndicator::Error;
@@ -82,7 +89,7 @@ namespace SDS
             ErrorIndicator::Error;
         }
 
-        State::isInitialized = false;
+        State::isInitialized.store(false, std::memory_order_release);
         return (ErrorIndicator)1;
     }
 
@@ -125,7 +132,7 @@ namespace SDS
 
     NetworkIPAddresses* GetNetworkIPAddressesArray(int32_t* size_out) noexcept
     {
-        if (!State::isInitialized) //It's not necessary to do this check.
+        if (!State::isInitialized.load(std::memory_order_acquire)) //It's not necessary to do this check.
         {
             ErrorHandler::SignalError(Error::IsNotInitialized);
             return nullptr;
@@ -142,7 +149,7 @@ namespace SDS
         {
             try
             {
-                static std::vector<NetworkIPAddresses> networkIPAddresses(2);
+                static thread_local std::vector<NetworkIPAddresses> networkIPAddresses(2);
                 networkIPAddresses.clear();
 
                 NetworkIPAddresses networkIPAddress;
@@ -172,7 +179,7 @@ namespace SDS
 
     ErrorBool IsIPv4AddressPreferred(const NetworkIPAddresses* networkIPAddressesInNetworkBO) noexcept
     {
-        if (!State::isInitialized) //It's not necessary to do this check.
+        if (!State::isInitialized.load(std::memory_order_acquire)) //It's not necessary to do this check.
         {
             ErrorHandler::SignalError(Error::IsNotInitialized);
             return ErrorBool::Error;
@@ -193,6 +200,11 @@ namespace SDS
     }
 
     SocketHandle CreateIPv4UDPSocket(IPv4Address ipv4Address, uint16_t* portNumberInHostBO_inout) noexcept
+    {
+        return CreateIPv4UDPSocketWithProfile(ipv4Address, portNumberInHostBO_inout, nullptr);
+    }
+
+    SocketHandle CreateIPv4UDPSocketWithProfile(IPv4Address ipv4Address, uint16_t* portNumberInHostBO_inout, const SocketProfile* profile) noexcept
     {
         if (InternalIPv4AddressUtils::IsZero(ipv4Address))
         {
@@ -206,10 +218,15 @@ namespace SDS
             return nullptr;
         }
 
-        return _CreateAndBindIPv4Socket(SOCK_DGRAM, IPPROTO_UDP, ipv4Address, *portNumberInHostBO_inout);
+        return _CreateAndBindIPv4Socket(SOCK_DGRAM, IPPROTO_UDP, ipv4Address, *portNumberInHostBO_inout, profile);
     }
    
     SocketHandle CreateIPv6UDPSocket(IPv6Address ipv6AddressInNetworkBO, uint16_t* portNumberInHostBO_inout) noexcept
+    {
+        return CreateIPv6UDPSocketWithProfile(ipv6AddressInNetworkBO, portNumberInHostBO_inout, nullptr);
+    }
+
+    SocketHandle CreateIPv6UDPSocketWithProfile(IPv6Address ipv6AddressInNetworkBO, uint16_t* portNumberInHostBO_inout, const SocketProfile* profile) noexcept
     {
         if (InternalIPv6AddressUtils::IsZero(ipv6AddressInNetworkBO))
         {
@@ -223,11 +240,17 @@ namespace SDS
             return nullptr;
         }
 
-        return _CreateAndBindIPv6Socket(SOCK_DGRAM, IPPROTO_UDP, ipv6AddressInNetworkBO, *portNumberInHostBO_inout);
+        return _CreateAndBindIPv6Socket(SOCK_DGRAM, IPPROTO_UDP, ipv6AddressInNetworkBO, *portNumberInHostBO_inout, profile);
     }
 
     SocketHandle CreateListeningIPv4TCPSocket(IPv4Address ipv4Address, 
         uint16_t* portNumberInHostBO_inout, uint32_t pendingConnectionQueueSize) noexcept
+    {
+        return CreateListeningIPv4TCPSocketWithProfile(ipv4Address, portNumberInHostBO_inout, pendingConnectionQueueSize, nullptr);
+    }
+
+    SocketHandle CreateListeningIPv4TCPSocketWithProfile(IPv4Address ipv4Address, 
+        uint16_t* portNumberInHostBO_inout, uint32_t pendingConnectionQueueSize, const SocketProfile* profile) noexcept
     {
         if (InternalIPv4AddressUtils::IsZero(ipv4Address))
         {
@@ -241,7 +264,7 @@ namespace SDS
             return nullptr;
         }
 
-        auto listeningSocketHandle = _CreateAndBindIPv4Socket(SOCK_STREAM, IPPROTO_TCP, ipv4Address, *portNumberInHostBO_inout);
+        auto listeningSocketHandle = _CreateAndBindIPv4Socket(SOCK_STREAM, IPPROTO_TCP, ipv4Address, *portNumberInHostBO_inout, profile);
         if (listeningSocketHandle != nullptr)
         {
             pendingConnectionQueueSize &= 0x7FFFFFFF;
@@ -259,6 +282,12 @@ namespace SDS
 
     SocketHandle CreateListeningIPv6TCPSocket(IPv6Address ipv6AddressInNetworkBO, 
         uint16_t* portNumberInHostBO_inout, uint32_t pendingConnectionQueueSize) noexcept
+    {
+        return CreateListeningIPv6TCPSocketWithProfile(ipv6AddressInNetworkBO, portNumberInHostBO_inout, pendingConnectionQueueSize, nullptr);
+    }
+
+    SocketHandle CreateListeningIPv6TCPSocketWithProfile(IPv6Address ipv6AddressInNetworkBO, 
+        uint16_t* portNumberInHostBO_inout, uint32_t pendingConnectionQueueSize, const SocketProfile* profile) noexcept
     {
         if (InternalIPv6AddressUtils::IsZero(ipv6AddressInNetworkBO))
         {
@@ -272,7 +301,7 @@ namespace SDS
             return nullptr;
         }
 
-        auto listeningSocketHandle = _CreateAndBindIPv6Socket(SOCK_STREAM, IPPROTO_TCP, ipv6AddressInNetworkBO, *portNumberInHostBO_inout);
+        auto listeningSocketHandle = _CreateAndBindIPv6Socket(SOCK_STREAM, IPPROTO_TCP, ipv6AddressInNetworkBO, *portNumberInHostBO_inout, profile);
         if (listeningSocketHandle != nullptr)
         {
             pendingConnectionQueueSize &= 0x7FFFFFFF;
@@ -290,6 +319,12 @@ namespace SDS
 
     SocketHandle CreateConnectedIPv4TCPSocket(uint16_t portNumberToConnectFromInHostBO, 
         IPv4Address ipv4AddressToConnectTo, uint16_t portNumberToConnectToInHostBO) noexcept
+    {
+        return CreateConnectedIPv4TCPSocketWithProfile(portNumberToConnectFromInHostBO, ipv4AddressToConnectTo, portNumberToConnectToInHostBO, nullptr);
+    }
+
+    SocketHandle CreateConnectedIPv4TCPSocketWithProfile(uint16_t portNumberToConnectFromInHostBO, 
+        IPv4Address ipv4AddressToConnectTo, uint16_t portNumberToConnectToInHostBO, const SocketProfile* profile) noexcept
     {
         if (portNumberToConnectToInHostBO == (uint16_t)0)
         {
@@ -303,11 +338,17 @@ namespace SDS
         InternalIPv4AddressUtils::CopyTo(&socketAddressToConnectTo.sin_addr, ipv4AddressToConnectTo);
 
         return _CreateAndConnectIPTCPSocket(portNumberToConnectFromInHostBO, 
-            reinterpret_cast<sockaddr&>(socketAddressToConnectTo), sizeof(sockaddr_in));
+            reinterpret_cast<sockaddr&>(socketAddressToConnectTo), sizeof(sockaddr_in), profile);
     }
 
     SocketHandle CreateConnectedIPv6TCPSocket(uint16_t portNumberToConnectFromInHostBO,
         IPv6Address ipv6AddressToConnectToInHostBO, uint16_t portNumberToConnectToInHostBO) noexcept
+    {
+        return CreateConnectedIPv6TCPSocketWithProfile(portNumberToConnectFromInHostBO, ipv6AddressToConnectToInHostBO, portNumberToConnectToInHostBO, nullptr);
+    }
+
+    SocketHandle CreateConnectedIPv6TCPSocketWithProfile(uint16_t portNumberToConnectFromInHostBO,
+        IPv6Address ipv6AddressToConnectToInHostBO, uint16_t portNumberToConnectToInHostBO, const SocketProfile* profile) noexcept
     {
         if (portNumberToConnectToInHostBO == (uint16_t)0)
         {
@@ -325,7 +366,7 @@ namespace SDS
         socketAddressToConnectTo.sin6_scope_id = (ULONG)0;
 
         return _CreateAndConnectIPTCPSocket(portNumberToConnectFromInHostBO, 
-            reinterpret_cast<sockaddr&>(socketAddressToConnectTo), sizeof(sockaddr_in6));
+            reinterpret_cast<sockaddr&>(socketAddressToConnectTo), sizeof(sockaddr_in6), profile);
     }
 
     ErrorIndicator AcceptNewConnection(SocketHandle listeningSocketHandle, SocketHandle* connectedSocketHandle_out) noexcept
@@ -351,6 +392,84 @@ namespace SDS
         return (ErrorIndicator)1;
     }
 
+    ErrorIndicator AcceptNewConnections(SocketHandle listeningSocketHandle, SocketHandle* connectedSocketHandles_out,
+        ErrorIPSocketAddress* anotherHostIPSocketAddresses_out, int32_t capacity, int32_t* connectionCount_out) noexcept
+    {
+        if (connectedSocketHandles_out == nullptr || connectionCount_out == nullptr)
+        {
+            ErrorHandler::SignalError(Error::PassedPointerIsNull);
+            return ErrorIndicator::Error;
+        }
+
+        auto connectionCount = (int32_t)0;
+        bool hasFailed = false;
+
+        while (connectionCount < capacity)
+        {
+            sockaddr_in6 socketAddress; //Used as a buffer for any IP address family.
+            auto socketAddressSize = (int)sizeof(sockaddr_in6);
+
+            const auto newConnection = accept(ToNativeSocketHandle(listeningSocketHandle),
+                reinterpret_cast<sockaddr*>(&socketAddress), &socketAddressSize);
+            if (newConnection == INVALID_SOCKET)
+            {
+                //A connection reset before it was accepted is dropped, so the next one is accepted.
+                const int errorCode = WSAGetLastError();
+                if (errorCode == WSAECONNRESET)
+                    continue;
+
+                if (errorCode != WSAEWOULDBLOCK)
+                {
+                    ErrorHandler::Handle_accept();
+                    hasFailed = true;
+                }
+
+                break;
+            }
+
+            connectedSocketHandles_out[connectionCount] = ToSocketHandle(newConnection);
+            if (anotherHostIPSocketAddresses_out != nullptr)
+                anotherHostIPSocketAddresses_out[connectionCount] = _ToErrorIPSocketAddress(socketAddress);
+
+            ++connectionCount;
+        }
+
+        *connectionCount_out = connectionCount;
+        return hasFailed && connectionCount == (int32_t)0 ? ErrorIndicator::Error : (ErrorIndicator)1;
+    }
+
+    ErrorBool IsTCPSocketConnected(SocketHandle connectingSocketHandle) noexcept
+    {
+        const auto connectingSocket = ToNativeSocketHandle(connectingSocketHandle);
+
+        int connectionError;
+        auto connectionErrorSize = (int)sizeof(int);
+        if (getsockopt(connectingSocket, SOL_SOCKET, SO_ERROR, reinterpret_cast<char*>(&connectionError), &connectionErrorSize) != 0)
+        {
+            ErrorHandler::Handle_getsockopt();
+            return ErrorBool::Error;
+        }
+
+        //The pending error is the result of the non-blocking connect call.
+        if (connectionError != 0)
+        {
+            WSASetLastError(connectionError);
+            ErrorHandler::Handle_connect();
+            return ErrorBool::Error;
+        }
+
+        sockaddr_in6 socketAddress; //Used as a buffer for any IP address family.
+        auto socketAddressSize = (int)sizeof(sockaddr_in6);
+        if (getpeername(connectingSocket, reinterpret_cast<sockaddr*>(&socketAddress), &socketAddressSize) == 0)
+            return ErrorBool::True;
+
+        if (WSAGetLastError() == WSAENOTCONN)
+            return ErrorBool::False;
+
+        ErrorHandler::Handle_getpeername();
+        return ErrorBool::Error;
+    }
+
     ErrorIPSocketAddress GetAnotherHostIPSocketAddress(SocketHandle connectedSocketHandle) noexcept
     {
         ErrorIPSocketAddress errorIPSocketAddress{};
@@ -367,26 +486,7 @@ namespace SDS
             return errorIPSocketAddress;
         }
 
-        errorIPSocketAddress.errorIndicator = (ErrorIndicator)1;
-        errorIPSocketAddress.port = socketAddress.sin6_port;
-        
-        if (socketAddress.sin6_family == AF_INET)
-        {
-            InternalIPv4AddressUtils::CopyFrom(&socketAddress.sin6_flowinfo, errorIPSocketAddress.v4);
-        }
-        else if (socketAddress.sin6_family == AF_INET6)
-        {
-            InternalIPv6AddressUtils::CopyFrom(&socketAddress.sin6_addr, errorIPSocketAddress.v6);
-            errorIPSocketAddress.v6.flowInfo = socketAddress.sin6_flowinfo;
-            errorIPSocketAddress.v6.scopeID = socketAddress.sin6_scope_id;
-        }
-        else
-        {
-            ErrorHandler::SignalError(Error::AnotherHostUsesIncompatibleSocketAddress);
-            errorIPSocketAddress.errorIndicator = ErrorIndicator::Error;
-        }
-
-        return errorIPSocketAddress;
+        return _ToErrorIPSocketAddress(socketAddress);
     }
 
     ErrorIndicator DestroySocket(SocketHandle socketHandle) noexcept
@@ -444,6 +544,17 @@ namespace SDS
         return (ErrorIndicator)1;
     }
 
+    ErrorIndicator ApplySocketProfile(SocketHandle socketHandle, const SocketProfile* profile) noexcept
+    {
+        if (profile == nullptr)
+        {
+            ErrorHandler::SignalError(Error::PassedPointerIsNull);
+            return ErrorIndicator::Error;
+        }
+
+        return _SetSocketProfileOptions(ToNativeSocketHandle(socketHandle), *profile) ? (ErrorIndicator)1 : ErrorIndicator::Error;
+    }
+
     //The returned pointer is null only if an error occured.
     //The returned int value is used to store the protocol info array's size.
     inline std::pair<WSAPROTOCOL_INFOW*, int> _GetAvailableProtocols() noexcept
@@ -592,7 +703,7 @@ namespace SDS
     //The returned socket handle can only be nullptr if an error occured.
     //The port number will be updated only if the address isn't zero.
     inline SocketHandle _CreateAndBindIPv4Socket(int type, int protocol, 
-        IPv4Address ipv4Address, uint16_t& portNumberInHostBO_inout) noexcept
+        IPv4Address ipv4Address, uint16_t& portNumberInHostBO_inout, const SocketProfile* profile) noexcept
     {
         sockaddr_in socketAddress;
         socketAddress.sin_family = AF_INET;
@@ -600,7 +711,7 @@ namespace SDS
         InternalIPv4AddressUtils::CopyTo(&socketAddress.sin_addr, ipv4Address);
 
         auto* const socketHandle = _CreateAndBindIPSocket(type, protocol, reinterpret_cast<sockaddr&>(socketAddress), 
-            (int)sizeof(sockaddr_in), !InternalIPv4AddressUtils::IsZero(ipv4Address));
+            (int)sizeof(sockaddr_in), profile, !InternalIPv4AddressUtils::IsZero(ipv4Address));
         if (socketHandle != nullptr)
             portNumberInHostBO_inout = NetworkToHostBO(socketAddress.sin_port);
 
@@ -610,7 +721,7 @@ namespace SDS
     //The returned socket handle can only be nullptr if an error occured.
     //The port number will be updated only if the address isn't zero.
     inline SocketHandle _CreateAndBindIPv6Socket(int type, int protocol, 
-        const IPv6Address& ipv6AddressInNetworkBO, uint16_t& portNumberInHostBO_inout) noexcept
+        const IPv6Address& ipv6AddressInNetworkBO, uint16_t& portNumberInHostBO_inout, const SocketProfile* profile) noexcept
     {
         sockaddr_in6 socketAddress;
         socketAddress.sin6_family = AF_INET6;
@@ -620,7 +731,7 @@ namespace SDS
         socketAddress.sin6_scope_id = ipv6AddressInNetworkBO.scopeID;
 
         auto* const socketHandle = _CreateAndBindIPSocket(type, protocol, reinterpret_cast<sockaddr&>(socketAddress), 
-            (int)sizeof(sockaddr_in6), !InternalIPv6AddressUtils::IsZero(ipv6AddressInNetworkBO));
+            (int)sizeof(sockaddr_in6), profile, !InternalIPv6AddressUtils::IsZero(ipv6AddressInNetworkBO));
         if (socketHandle != nullptr)
             portNumberInHostBO_inout = NetworkToHostBO(socketAddress.sin6_port);
 
@@ -630,8 +741,9 @@ namespace SDS
     //The returned socket handle can only be nullptr if an error occured.
     //If the passed port number is zero and shouldUpdatePortNumber is true, it will updated the port number.
     //Don't set the shouldUpdatePortNumber parameter to true if the address may be zero.
-    inline SocketHandle _CreateAndBindIPSocket(int type, int protocol, 
-        sockaddr& socketAddressInNetworkBO_inout, int socketAddressSize, bool shouldUpdatePortNumber) noexcept
+    //The options of the profile are set before binding. Passing a null profile is legal.
+    inline SocketHandle _CreateAndBindIPSocket(int type, int protocol, sockaddr& socketAddressInNetworkBO_inout,
+        int socketAddressSize, const SocketProfile* profile, bool shouldUpdatePortNumber) noexcept
     {
         assert(socketAddressInNetworkBO_inout.sa_family == AF_INET || socketAddressInNetworkBO_inout.sa_family == AF_INET6);
         assert(type == SOCK_STREAM && protocol == IPPROTO_TCP ||
@@ -642,8 +754,11 @@ namespace SDS
             auto isNonBlockingModeEnabled = (u_long)1;
             if (ioctlsocket(socketHandle, FIONBIO, &isNonBlockingModeEnabled) == 0)
             {
-                if (_BindIPSocket(socketHandle, socketAddressInNetworkBO_inout, socketAddressSize, shouldUpdatePortNumber))
+                if ((profile == nullptr || _SetSocketProfileOptions(socketHandle, *profile)) &&
+                    _BindIPSocket(socketHandle, socketAddressInNetworkBO_inout, socketAddressSize, shouldUpdatePortNumber))
+                {
                     return ToSocketHandle(socketHandle);
+                }
             }
             else
             {
@@ -684,8 +799,42 @@ namespace SDS
         return false;
     }
     
+    //The returned bool value is set to false if an option couldn't be set. In that case, the error is already signaled.
+    //Options Windows doesn't have, e.g. busy polling, are ignored.
+    inline bool _SetSocketProfileOptions(SOCKET socketHandle, const SocketProfile& profile) noexcept
+    {
+        const auto setOption = [socketHandle](int level, int name, const void* optionValue, int optionValueSize)
+            {
+                if (setsockopt(socketHandle, level, name, reinterpret_cast<const char*>(optionValue), optionValueSize) != 0)
+                {
+                    ErrorHandler::Handle_setsockopt();
+                    return false;
+                }
+
+                return true;
+            };
+
+        static constexpr DWORD isEnabled = 1;
+        const auto sendBufferSize = (int)(profile.sendBufferSize > (uint32_t)INT_MAX ? (uint32_t)INT_MAX : profile.sendBufferSize);
+        const auto receiveBufferSize = (int)(profile.receiveBufferSize > (uint32_t)INT_MAX ? (uint32_t)INT_MAX : profile.receiveBufferSize);
+        const linger destructionTimeout{ (u_short)1, (u_short)profile.destructionTimeoutInSeconds };
+        const auto keepAliveIdleTime = (DWORD)profile.keepAliveIdleTimeInSeconds;
+        const auto keepAliveInterval = (DWORD)profile.keepAliveIntervalInSeconds;
+        const auto keepAliveProbeCount = (DWORD)profile.keepAliveProbeCount;
+
+        return (sendBufferSize == 0 || setOption(SOL_SOCKET, SO_SNDBUF, &sendBufferSize, (int)sizeof(int))) &&
+            (receiveBufferSize == 0 || setOption(SOL_SOCKET, SO_RCVBUF, &receiveBufferSize, (int)sizeof(int))) &&
+            (keepAliveIdleTime == (DWORD)0 || (setOption(SOL_SOCKET, SO_KEEPALIVE, &isEnabled, (int)sizeof(DWORD)) &&
+                setOption(IPPROTO_TCP, TCP_KEEPIDLE, &keepAliveIdleTime, (int)sizeof(DWORD)) &&
+                (keepAliveInterval == (DWORD)0 || setOption(IPPROTO_TCP, TCP_KEEPINTVL, &keepAliveInterval, (int)sizeof(DWORD))) &&
+                (keepAliveProbeCount == (DWORD)0 || setOption(IPPROTO_TCP, TCP_KEEPCNT, &keepAliveProbeCount, (int)sizeof(DWORD))))) &&
+            (profile.isDestructionTimeoutEnabled == Bool::False || setOption(SOL_SOCKET, SO_LINGER, &destructionTimeout, (int)sizeof(linger))) &&
+            (profile.isNaglesAlgorithmDisabled == Bool::False || setOption(IPPROTO_TCP, TCP_NODELAY, &isEnabled, (int)sizeof(DWORD))) &&
+            (profile.isBroadcastEnabled == Bool::False || setOption(SOL_SOCKET, SO_BROADCAST, &isEnabled, (int)sizeof(DWORD)));
+    }
+
     inline SocketHandle _CreateAndConnectIPTCPSocket(uint16_t portNumberToConnectFromInHostBO,
-        const sockaddr& socketAddressToConnectToInNetworkBO, int socketAddressToConnectToSize) noexcept
+        const sockaddr& socketAddressToConnectToInNetworkBO, int socketAddressToConnectToSize, const SocketProfile* profile) noexcept
     {
         sockaddr_in6 socketAddress{}; //Used as a buffer for any IP address family.
         socketAddress.sin6_family = socketAddressToConnectToInNetworkBO.sa_family;
@@ -694,7 +843,7 @@ namespace SDS
         while (true)
         {
             auto connectingSocketHandle = _CreateAndBindIPSocket(SOCK_STREAM, IPPROTO_TCP,
-                reinterpret_cast<sockaddr&>(socketAddress), sizeof(sockaddr_in6));
+                reinterpret_cast<sockaddr&>(socketAddress), sizeof(sockaddr_in6), profile);
             if (connectingSocketHandle != nullptr)
             {
                 if (connect(ToNativeSocketHandle(connectingSocketHandle),
@@ -726,4 +875,100 @@ namespace SDS
             return connectingSocketHandle;
         }    
     }
+
+    //If the address family isn't IPv4 or IPv6, the error is signaled and the returned error indicator is set.
+    inline ErrorIPSocketAddress _ToErrorIPSocketAddress(const sockaddr_in6& socketAddressInNetworkBO) noexcept
+    {
+        ErrorIPSocketAddress errorIPSocketAddress{};
+        errorIPSocketAddress.errorIndicator = (ErrorIndicator)1;
+        errorIPSocketAddress.port = socketAddressInNetworkBO.sin6_port;
+
+        if (socketAddressInNetworkBO.sin6_family == AF_INET)
+        {
+            InternalIPv4AddressUtils::CopyFrom(&socketAddressInNetworkBO.sin6_flowinfo, errorIPSocketAddress.v4);
+        }
+        else if (socketAddressInNetworkBO.sin6_family == AF_INET6)
+        {
+            InternalIPv6AddressUtils::CopyFrom(&socketAddressInNetworkBO.sin6_addr, errorIPSocketAddress.v6);
+            errorIPSocketAddress.v6.flowInfo = socketAddressInNetworkBO.sin6_flowinfo;
+            errorIPSocketAddress.v6.scopeID = socketAddressInNetworkBO.sin6_scope_id;
+        }
+        else
+        {
+            ErrorHandler::SignalError(Error::AnotherHostUsesIncompatibleSocketAddress);
+            errorIPSocketAddress.errorIndicator = ErrorIndicator::Error;
+        }
+
+        return errorIPSocketAddress;
+    }
+}
+
+//Socket counters aren't implemented on Windows, so only the global counters of errors are kept.
+Statistics::SocketCounters* Statistics::FindSocketCounters(const void* socketHandle) noexcept
+{
+    return nullptr;
+}
+
+//Large pages need a privilege which processes rarely have, so the memory is only bound to the NUMA node.
+//Reservations are only aligned to the allocation granularity, so more is reserved and only the part aligned to the slab size is committed.
+std::byte* BufferPool::AllocateRegion(size_t size, int32_t numaNode, bool& isHugePageBacked_out) noexcept
+{
+    isHugePageBacked_out = false;
+    const size_t reservedSize = size + slabSize;
+    auto* const reservedRegion = static_cast<std::byte*>(numaNode >= (int32_t)0 ?
+        VirtualAllocExNuma(GetCurrentProcess(), nullptr, reservedSize, MEM_RESERVE, PAGE_READWRITE, (DWORD)numaNode) :
+        VirtualAlloc(nullptr, reservedSize, MEM_RESERVE, PAGE_READWRITE));
+    if (reservedRegion == nullptr)
+        return nullptr;
+
+    const auto misalignment = (size_t)(reinterpret_cast<uintptr_t>(reservedRegion) % slabSize);
+    auto* const region = reservedRegion + (misalignment != (size_t)0 ? slabSize - misalignment : (size_t)0);
+    const void* const committedRegion = numaNode >= (int32_t)0 ?
+        VirtualAllocExNuma(GetCurrentProcess(), region, size, MEM_COMMIT, PAGE_READWRITE, (DWORD)numaNode) :
+        VirtualAlloc(region, size, MEM_COMMIT, PAGE_READWRITE);
+    if (committedRegion == nullptr)
+    {
+        VirtualFree(reservedRegion, 0, MEM_RELEASE);
+        return nullptr;
+    }
+
+    return region;
+}
+
+//The region may start after the beginning of its reservation, which must be released as a whole.
+void BufferPool::FreeRegion(std::byte* region, size_t size) noexcept
+{
+    MEMORY_BASIC_INFORMATION memoryInformation;
+    if (VirtualQuery(region, &memoryInformation, sizeof(MEMORY_BASIC_INFORMATION)) != 0)
+        VirtualFree(memoryInformation.AllocationBase, 0, MEM_RELEASE);
+}
+
+int32_t BufferPool::GetCurrentNUMANode() noexcept
+{
+    PROCESSOR_NUMBER processorNumber;
+    GetCurrentProcessorNumberEx(&processorNumber);
+
+    USHORT numaNode;
+    if (!GetNumaProcessorNodeEx(&processorNumber, &numaNode))
+        return (int32_t)-1;
+
+    return (int32_t)numaNode;
+}
+
+size_t RingBuffer::GetMappingGranularity() noexcept
+{
+    SYSTEM_INFO systemInfo;
+    GetSystemInfo(&systemInfo);
+    return (size_t)systemInfo.dwAllocationGranularity;
+}
+
+//Mirrored mappings aren't implemented on Windows.
+std::byte* RingBuffer::MapMirrored(size_t capacity) noexcept
+{
+    ErrorHandler::SignalError(SDS::Error::NotSupportedMachine);
+    return nullptr;
+}
+
+void RingBuffer::Unmap(std::byte* data, size_t capacity) noexcept
+{
 }
\ No newline at end of file